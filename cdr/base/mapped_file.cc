@@ -0,0 +1,134 @@
+#include <cdr/base/mapped_file.h>
+#include <cdr/base/aligned_alloc.h>
+
+#include <fstream>
+#include <new>
+#include <system_error>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // _WIN32
+
+namespace cdr {
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : base_ptr_(std::exchange(other.base_ptr_, nullptr))
+    , size_(std::exchange(other.size_, 0))
+    , mapped_(std::exchange(other.mapped_, false))
+{}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (&other != this) [[likely]] {
+        Release();
+
+        base_ptr_ = std::exchange(other.base_ptr_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mapped_ = std::exchange(other.mapped_, false);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    Release();
+}
+
+void MappedFile::Release() noexcept {
+    if (base_ptr_ == nullptr) {
+        return;
+    }
+
+#ifndef _WIN32
+    if (mapped_) {
+        ::munmap(const_cast<std::byte*>(base_ptr_), size_);
+        base_ptr_ = nullptr;
+        return;
+    }
+#endif  // _WIN32
+
+    AlignedFree(const_cast<std::byte*>(base_ptr_));
+    base_ptr_ = nullptr;
+}
+
+/* static */
+Expect<MappedFile, Error> MappedFile::Open(const std::filesystem::path& path) noexcept {
+#ifndef _WIN32
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) [[unlikely]] {
+        return ErrorIOFailure();
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) [[unlikely]] {
+        ::close(fd);
+        return ErrorIOFailure();
+    }
+
+    const u64 size = static_cast<u64>(st.st_size);
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (mapping == MAP_FAILED) [[unlikely]] {
+        return ErrorIOFailure();
+    }
+
+    return Ok<MappedFile>(std::in_place, MappedFile(static_cast<const std::byte*>(mapping), size, true));
+#else   // _WIN32
+    std::error_code ec;
+    const u64 size = std::filesystem::file_size(path, ec);
+    if (ec || size == 0) [[unlikely]] {
+        return ErrorIOFailure();
+    }
+
+    std::ifstream input(path, std::ios::binary);
+    if (!input) [[unlikely]] {
+        return ErrorIOFailure();
+    }
+
+    auto* buffer = static_cast<std::byte*>(AlignedAlloc(alignof(std::max_align_t), AlignOffset(size, alignof(std::max_align_t))));
+    if (buffer == nullptr) [[unlikely]] {
+        return ErrorNoMemory();
+    }
+
+    if (!input.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(size))) [[unlikely]] {
+        AlignedFree(buffer);
+        return ErrorIOFailure();
+    }
+
+    return Ok<MappedFile>(std::in_place, MappedFile(buffer, size, false));
+#endif  // _WIN32
+}
+
+Expect<void, Error> WriteFileAtomically(const std::filesystem::path& path, std::span<const std::byte> bytes) noexcept {
+    try {
+        std::filesystem::path tmp_path = path;
+        tmp_path += ".tmp";
+
+        {
+            std::ofstream output(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!output) [[unlikely]] {
+                return ErrorIOFailure();
+            }
+            output.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            if (!output.flush()) [[unlikely]] {
+                return ErrorIOFailure();
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmp_path, path, ec);
+        if (ec) [[unlikely]] {
+            std::filesystem::remove(tmp_path, ec);
+            return ErrorIOFailure();
+        }
+
+        return Ok();
+    } catch (const std::bad_alloc&) {
+        return ErrorNoMemory();
+    }
+}
+
+}  // namespace cdr
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cdr/types/errors.h>
+#include <cdr/types/expect.h>
+#include <cdr/types/integers.h>
+#include <cdr/base/internal/export.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace cdr {
+
+// Read-only memory mapping of a whole file (an aligned in-memory copy on
+// platforms without mmap). Movable, unmapped on destruction.
+class CDR_BASE_EXPORT MappedFile final {
+public:
+    MappedFile() = default;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    ~MappedFile();
+
+    // Fails with Error::IOFailure if the file is missing or empty
+    [[nodiscard]] static Expect<MappedFile, Error> Open(const std::filesystem::path& path) noexcept;
+
+    [[nodiscard]] const std::byte* Data() const noexcept {
+        return base_ptr_;
+    }
+
+    [[nodiscard]] u64 Size() const noexcept {
+        return size_;
+    }
+
+    [[nodiscard]] std::span<const std::byte> Bytes() const noexcept {
+        return {base_ptr_, size_};
+    }
+
+private:
+    MappedFile(const std::byte* base, u64 size, bool mapped) noexcept
+        : base_ptr_(base)
+        , size_(size)
+        , mapped_(mapped)
+    {}
+
+    void Release() noexcept;
+
+private:
+    const std::byte* base_ptr_ = nullptr;
+    u64 size_ = 0;
+    bool mapped_ = false;
+};
+
+// Writes `bytes` to `path` atomically: the data is written next to the
+// target and renamed over it, so readers never observe a partial file.
+[[nodiscard]] CDR_BASE_EXPORT Expect<void, Error> WriteFileAtomically(const std::filesystem::path& path,
+                                                                      std::span<const std::byte> bytes) noexcept;
+
+constexpr u64 AlignOffset(u64 offset, u64 alignment) noexcept {
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+}  // namespace cdr
@@ -0,0 +1,129 @@
+#include <cdr/base/thread_pool.h>
+#include <cdr/base/check.h>
+
+namespace cdr {
+
+namespace {
+
+// Pool and queue owned by the current thread, if it is a pool worker
+thread_local const ThreadPool* tls_pool = nullptr;
+thread_local u32 tls_queue = 0;
+
+}  // namespace
+
+ThreadPool::ThreadPool(u32 concurrency) {
+    CDR_CHECK(concurrency > 0) << "thread pool needs at least one thread";
+
+    const u32 workers = concurrency - 1;
+    queues_.reserve(workers);
+    for (u32 i = 0; i < workers; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+
+    workers_.reserve(workers);
+    for (u32 i = 0; i < workers; ++i) {
+        workers_.emplace_back([this, i] { WorkerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    wake_up_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::Submit(Task task) {
+    if (workers_.empty()) [[unlikely]] {
+        task();
+        return;
+    }
+
+    const u32 index = tls_pool == this
+        ? tls_queue
+        : next_queue_.fetch_add(1, std::memory_order_relaxed) % static_cast<u32>(queues_.size());
+
+    {
+        std::lock_guard lock(sleep_mutex_);
+        queued_.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    wake_up_.notify_one();
+}
+
+bool ThreadPool::PopLocal(u32 index, Task& task) {
+    Queue& queue = *queues_[index];
+    std::lock_guard lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool ThreadPool::Steal(u32 thief, Task& task) {
+    const u32 size = static_cast<u32>(queues_.size());
+    for (u32 shift = 1; shift <= size; ++shift) {
+        Queue& victim = *queues_[(thief + shift) % size];
+        std::lock_guard lock(victim.mutex);
+        if (victim.tasks.empty()) {
+            continue;
+        }
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+bool ThreadPool::TryRunOne() {
+    if (queued_.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+
+    Task task;
+    const bool found = tls_pool == this
+        ? PopLocal(tls_queue, task) || Steal(tls_queue, task)
+        : Steal(next_queue_.load(std::memory_order_relaxed), task);
+    if (!found) {
+        return false;
+    }
+
+    task();
+    return true;
+}
+
+void ThreadPool::WorkerLoop(u32 index) {
+    tls_pool = this;
+    tls_queue = index;
+
+    Task task;
+    while (true) {
+        if (PopLocal(index, task) || Steal(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock lock(sleep_mutex_);
+        wake_up_.wait(lock, [this] {
+            return stopping_ || queued_.load(std::memory_order_relaxed) > 0;
+        });
+        if (stopping_ && queued_.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+    }
+}
+
+}  // namespace cdr
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cdr/types/integers.h>
+#include <cdr/base/hardware_interference_size.h>
+#include <cdr/base/internal/export.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cdr {
+
+// Fixed size work-stealing thread pool.
+//
+// Every worker owns a task queue. A worker pops its own queue from the back
+// (most recently pushed, still hot in cache) and, once it runs dry, steals
+// from the front of the other queues. Tasks submitted from outside of the
+// pool are spread round-robin.
+//
+// `Concurrency()` counts the thread that calls `ParallelFor`: it executes
+// tasks while waiting, so a pool of concurrency N spawns N - 1 workers and
+// a pool of concurrency 1 runs everything inline.
+class CDR_BASE_EXPORT ThreadPool final {
+public:
+    using Task = std::function<void()>;
+
+public:
+    explicit ThreadPool(u32 concurrency = DefaultConcurrency());
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool();
+
+    [[nodiscard]] static u32 DefaultConcurrency() noexcept {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    [[nodiscard]] u32 Concurrency() const noexcept {
+        return static_cast<u32>(workers_.size()) + 1;
+    }
+
+    void Submit(Task task);
+
+    // Runs `body(first, last)` over [begin, end) split into chunks of at most
+    // `grain` elements and blocks until every chunk is done. Chunk bounds do
+    // not depend on the number of threads, so a body writing per-index
+    // results produces the same output for any pool size. The first
+    // exception thrown by a chunk is rethrown to the caller.
+    template <typename Body>
+    void ParallelFor(u64 begin, u64 end, u64 grain, Body&& body) {
+        if (begin >= end) [[unlikely]] {
+            return;
+        }
+        grain = std::max<u64>(grain, 1);
+        const u64 chunks = (end - begin + grain - 1) / grain;
+
+        if (workers_.empty() || chunks == 1) {
+            for (u64 first = begin; first < end; first += grain) {
+                body(first, std::min(first + grain, end));
+            }
+            return;
+        }
+
+        std::latch done(static_cast<std::ptrdiff_t>(chunks));
+        std::exception_ptr error;
+        std::once_flag error_flag;
+
+        for (u64 chunk = 0; chunk < chunks; ++chunk) {
+            const u64 first = begin + chunk * grain;
+            const u64 last = std::min(first + grain, end);
+            Submit([&, first, last] {
+                try {
+                    body(first, last);
+                } catch (...) {
+                    std::call_once(error_flag, [&] { error = std::current_exception(); });
+                }
+                done.count_down();
+            });
+        }
+
+        RunUntil(done);
+
+        if (error) [[unlikely]] {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Runs queued tasks on the calling thread until `done` is released, so a
+    // thread waiting for tasks of the pool helps to finish them
+    void RunUntil(std::latch& done) {
+        while (!done.try_wait()) {
+            if (!TryRunOne()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    struct alignas(kHardwareDestructiveInterferenceSize) Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    [[nodiscard]] bool PopLocal(u32 index, Task& task);
+    [[nodiscard]] bool Steal(u32 thief, Task& task);
+    [[nodiscard]] bool TryRunOne();
+
+    void WorkerLoop(u32 index);
+
+private:
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_up_;
+    std::atomic<u64> queued_ = 0;
+    std::atomic<u32> next_queue_ = 0;
+    bool stopping_ = false;
+};
+
+}  // namespace cdr
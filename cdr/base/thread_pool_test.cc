@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <cdr/base/thread_pool.h>
+#include <cdr/types/floats.h>
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+TEST(ThreadPool, ParallelForCoversRangeOnce) {
+    for (u32 concurrency : {1u, 2u, 4u}) {
+        cdr::ThreadPool pool(concurrency);
+        ASSERT_EQ(pool.Concurrency(), concurrency);
+
+        std::vector<u32> hits(10'000, 0);
+        pool.ParallelFor(0, hits.size(), 37, [&](u64 first, u64 last) {
+            ASSERT_LE(last - first, 37);
+            for (u64 i = first; i < last; ++i) {
+                ++hits[i];
+            }
+        });
+
+        for (u32 value : hits) {
+            ASSERT_EQ(value, 1);
+        }
+    }
+}
+
+TEST(ThreadPool, DeterministicChunks) {
+    auto partial_sums = [](u32 concurrency) {
+        cdr::ThreadPool pool(concurrency);
+        std::vector<f64> chunks(100, 0.);
+        pool.ParallelFor(0, 100'000, 1'000, [&](u64 first, u64 last) {
+            f64 sum = 0.;
+            for (u64 i = first; i < last; ++i) {
+                sum += 1. / static_cast<f64>(i + 1);
+            }
+            chunks[first / 1'000] = sum;
+        });
+        return std::accumulate(chunks.begin(), chunks.end(), 0.);
+    };
+
+    ASSERT_EQ(partial_sums(1), partial_sums(3));
+}
+
+TEST(ThreadPool, NestedParallelFor) {
+    cdr::ThreadPool pool(3);
+    std::atomic<u64> total = 0;
+
+    pool.ParallelFor(0, 8, 1, [&](u64, u64) {
+        pool.ParallelFor(0, 100, 10, [&](u64 first, u64 last) {
+            total.fetch_add(last - first, std::memory_order_relaxed);
+        });
+    });
+
+    ASSERT_EQ(total.load(), 800);
+}
+
+TEST(ThreadPool, SubmitRunsEverything) {
+    std::atomic<u32> counter = 0;
+    {
+        cdr::ThreadPool pool(4);
+        for (u32 i = 0; i < 1'000; ++i) {
+            pool.Submit([&] { counter.fetch_add(1, std::memory_order_relaxed); });
+        }
+    }
+    ASSERT_EQ(counter.load(), 1'000);
+}
+
+TEST(ThreadPool, PropagatesException) {
+    cdr::ThreadPool pool(2);
+    ASSERT_THROW(pool.ParallelFor(0, 16, 1, [](u64 first, u64) {
+        if (first == 7) {
+            throw std::runtime_error("chunk failed");
+        }
+    }), std::runtime_error);
+}
@@ -133,6 +133,13 @@ f64 Period::ActActISDA() const {
     return leap_days / 366.0 + non_leap_days / 365.0;
 }
 
+f64 ActActISDATime(const DateType& date) {
+    const SysDays year_beginning{date.year() / chrono::January / 1};
+    const auto elapsed = (SysDays{date} - year_beginning).count();
+    return static_cast<f64>(static_cast<i32>(date.year()))
+        + static_cast<f64>(elapsed) / static_cast<f64>(DaysInYear(date));
+}
+
 f64 DayCountFraction(const Period& period, DcConvention method) {
     switch(method) {
     case DcConvention::kActActISDA:
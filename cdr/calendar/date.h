@@ -39,15 +39,23 @@ inline constexpr u64 DaysInYear(const DateType& date) {
     return date.year().is_leap() ? 366 : 365;
 }
 
+// Days from `date` (inclusive) to the first day of the next year
 inline constexpr u32 DaysTillTheEndOfYear(const DateType& date) {
-    if (date.year().is_leap()) {
-        return 366 - static_cast<u32>(date.day());
-    }
-    return 365 - static_cast<u32>(date.day());
+    const SysDays next_year{(date.year() + std::chrono::years(1)) / std::chrono::January / 1};
+    return static_cast<u32>((next_year - SysDays{date}).count());
 }
 
 CDR_CALENDAR_EXPORT DateType NextYearBeginning(const DateType& date);
 
+// Day number since 1970-01-01, the date encoding of binary files and day grids
+inline constexpr i32 DaysSinceEpoch(const DateType& date) {
+    return static_cast<i32>(SysDays{date}.time_since_epoch().count());
+}
+
+inline constexpr DateType FromDaysSinceEpoch(i32 days) {
+    return DateType{SysDays{std::chrono::days{days}}};
+}
+
 constexpr struct EternityBeforeType {} EternityBefore;
 constexpr struct EternityAfterType {} EternityAfter;
 
@@ -106,4 +114,10 @@ enum class DcConvention {
 
 CDR_CALENDAR_EXPORT f64 DayCountFraction(const Period& period, DcConvention method = DcConvention::kActActISDA);
 
+// Position of `date` on the Act/Act ISDA time axis: year number plus the
+// elapsed fraction of that year. Act/Act ISDA is additive, so
+// DayCountFraction({a, b}) == ActActISDATime(b) - ActActISDATime(a) for a <= b
+// and year fractions from a moving valuation date can be precomputed.
+CDR_CALENDAR_EXPORT f64 ActActISDATime(const DateType& date);
+
 }  // namespace cdr
@@ -32,6 +32,47 @@ TEST(TestPeriod, sanity) {
 }
 
 TEST(TestPeriod, DCFractions) {
+    cdr::Period same_year = {day(1) / March / 2024, day(31) / March / 2024};
+    ASSERT_DOUBLE_EQ(same_year.Act360(), 30. / 360.);
+    ASSERT_DOUBLE_EQ(same_year.Act365(), 30. / 365.);
+    ASSERT_DOUBLE_EQ(same_year.ActActISDA(), 30. / 366.);
 
+    // 184 days of 2023, the whole leap 2024 and 59 days of 2025
+    cdr::Period across_years = {day(1) / July / 2023, day(1) / March / 2025};
+    ASSERT_DOUBLE_EQ(across_years.ActActISDA(), 1. + 243. / 365.);
+
+    ASSERT_EQ(cdr::DaysTillTheEndOfYear(day(31) / December / 2023), 1);
+    ASSERT_EQ(cdr::DaysTillTheEndOfYear(day(1) / January / 2024), 366);
+}
+
+TEST(TestPeriod, ActActISDATime) {
+    const DateType dates[] = {
+        day(15) / February / 2023,
+        day(31) / December / 2023,
+        day(1) / January / 2024,
+        day(29) / February / 2024,
+        day(3) / November / 2027,
+    };
+
+    for (const auto& since : dates) {
+        for (const auto& until : dates) {
+            if (until < since) {
+                continue;
+            }
+            ASSERT_NEAR(cdr::DayCountFraction({since, until}),
+                        cdr::ActActISDATime(until) - cdr::ActActISDATime(since), 1e-12);
+        }
+    }
 }
 
+
+TEST(TestPeriod, DaysSinceEpoch) {
+    static_assert(cdr::DaysSinceEpoch(day(1) / January / 1970) == 0);
+    ASSERT_EQ(cdr::DaysSinceEpoch(day(31) / December / 1969), -1);
+    ASSERT_EQ(cdr::DaysSinceEpoch(day(4) / January / 2027), 20'822);
+
+    for (const DateType date : {day(28) / February / 1900, day(29) / February / 2024, day(31) / December / 2099}) {
+        ASSERT_EQ(cdr::FromDaysSinceEpoch(cdr::DaysSinceEpoch(date)), date);
+        ASSERT_EQ(cdr::DaysSinceEpoch(cdr::NextDay(date)), cdr::DaysSinceEpoch(date) + 1);
+    }
+}
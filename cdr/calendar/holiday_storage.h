@@ -32,6 +32,15 @@ public:
         storage[jur].emplace(date);
     }
 
+    // Known jurisdiction with weekends only, no-op if it has holidays
+    inline void Insert(const JurisdictionType& jur) {
+        storage.try_emplace(jur);
+    }
+
+    [[nodiscard]] bool Contains(const JurisdictionType& jur) const {
+        return storage.contains(jur);
+    }
+
     bool IsWeekend(const JurisdictionType& jur, const DateType& date) const;
     bool IsBusinessDay(const JurisdictionType& jur, const DateType& date) const {
         return !IsWeekend(jur, date);
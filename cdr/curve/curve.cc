@@ -47,12 +47,17 @@ void Curve::ApplyFXContract(const Curve& other, const ForwardContract& fwd) noex
     node->second = rate_f;
 }
 
-void Curve::RollForward() noexcept {
+void Curve::RollForward(u32 days) noexcept {
+    if (days == 0) {
+        return;
+    }
     // moving backwards to avoid key collisions
     for (auto it = points_.end(); it != points_.begin();) {
         auto hint = it--;
         auto node = points_.extract(it);
-        node.key() = Calendar().FindNextWorkingDay(jurisdiction_, node.key());
+        for (u32 day = 0; day < days; ++day) {
+            node.key() = Calendar().FindNextWorkingDay(jurisdiction_, node.key());
+        }
         it = points_.insert(hint, std::move(node));
     }
 }
@@ -20,6 +20,7 @@ namespace cdr {
 
 class Curve;
 class CurveBuilder;
+class CurveImage;
 using DateType = std::chrono::year_month_day;
 
 template <typename T>
@@ -34,6 +35,7 @@ public:
     using PointsContainer = std::map<DateType, Percent>;
 
     friend class CurveBuilder;
+    friend class CurveImage;
 public:
     Curve(const Curve&) = delete;
     Curve& operator=(const Curve&) = delete;
@@ -114,7 +116,12 @@ public:
     void ApplyFXContract(const Curve& other, const ForwardContract& fwd) noexcept;
 
     // Advance current date and all pillars by one buisness day
-    void RollForward() noexcept;
+    void RollForward() noexcept {
+        RollForward(1);
+    }
+
+    // RollForward `days` times in one pass over the pillars
+    void RollForward(u32 days) noexcept;
 
     [[nodiscard]] DateType Today() const noexcept {
         return ctx_.Today();
@@ -175,7 +182,7 @@ public:
 
     template <std::input_iterator Iter>
     [[nodiscard]] std::unique_ptr<Curve> FromOther(const Curve& other, Iter begin, Iter end) {
-        CDR_CHECK(&ctx_ == &other.ctx_) << "Curves should share market context";
+        CDR_CHECK(ctx_.SharesContext(other.ctx_)) << "Curves should share market context";
         CDR_CHECK(jurisdiction_.has_value()) << "Jusrisdiction should be set";
         CDR_CHECK(jurisdiction_.value() != other.jurisdiction_) << "Same jurisdiction";
 
@@ -7,6 +7,8 @@
 #include <cdr/types/percent.h>
 #include <cdr/curve/interpolation/linear.h>
 #include <cdr/calendar/holiday_storage.h>
+#include <cdr/fx/fx.h>
+#include <cdr/market/context.h>
 #include <cdr/model/model.h>
 
 using namespace std::chrono;
@@ -81,6 +83,58 @@ TEST(Curve, BasicOps) {
     ASSERT_EQ(other, Percent::FromFraction(1));
 }
 
+TEST(Curve, LinearInterpolation) {
+    cdr::HolidayStorage hs;
+    hs.StaticInit()
+        ("TEST", day(1)/January/year(2027))
+    ;
+    cdr::MarketContext context(std::move(hs), day(1)/January/year(2027));
+    auto curve = cdr::CurveBuilder(context)
+        .Jurisdiction("TEST")
+        .Add(day(4)/January/year(2027), Percent::FromPercentage(1))
+        .Add(day(14)/January/year(2027), Percent::FromPercentage(3))
+        .Add(day(3)/February/year(2027), Percent::FromPercentage(2))
+        .FromPoints()
+    ;
+    const auto rate_at = [&](const DateType& date) {
+        return curve->Interpolated<Linear>(date, context.Calendar(), "TEST").Fraction();
+    };
+
+    // On the pillars
+    for (const auto& [date, value] : curve->Pillars()) {
+        ASSERT_EQ(rate_at(date), value.Fraction());
+    }
+    // Between two of them, from both neighbours
+    ASSERT_NEAR(rate_at(day(5)/January/year(2027)), 0.012, 1e-15);
+    ASSERT_NEAR(rate_at(day(11)/January/year(2027)), 0.024, 1e-15);
+    ASSERT_NEAR(rate_at(day(25)/January/year(2027)), 0.0245, 1e-15);
+    // Flat outside of them
+    ASSERT_EQ(rate_at(day(31)/December/year(2026)), 0.01);
+    ASSERT_EQ(rate_at(day(1)/March/year(2027)), 0.02);
+}
+
+TEST(Curve, LookupDate) {
+    cdr::HolidayStorage hs;
+    hs.StaticInit()
+        ("TEST", day(11)/January/year(2027))
+    ;
+    cdr::MarketContext context(std::move(hs), day(4)/January/year(2027));
+    auto curve = cdr::CurveBuilder(context)
+        .Jurisdiction("TEST")
+        .Add(day(4)/January/year(2027), Percent::FromPercentage(1))
+        .Add(day(14)/January/year(2027), Percent::FromPercentage(3))
+        .FromPoints()
+    ;
+
+    // Weekends and holidays are read at the next working day
+    const DateType saturday = day(9)/January/year(2027);
+    const DateType tuesday = day(12)/January/year(2027);
+    ASSERT_EQ(Linear::LookupDate(saturday, context.Calendar(), "TEST"), tuesday);
+    ASSERT_EQ(Linear::LookupDate(tuesday, context.Calendar(), "TEST"), tuesday);
+    ASSERT_EQ(curve->Interpolated<Linear>(saturday, context.Calendar(), "TEST"),
+              Linear::Interpolate(curve->Pillars(), tuesday));
+}
+
 TEST(Curve, RollForward) {
     cdr::HolidayStorage hs;
     hs.StaticInit()
@@ -181,3 +235,45 @@ TEST(Curve, CurveFromContracts) {
     contract.ApplyCurve(*curve);
     ASSERT_NEAR(contract.rate.value().Fraction(), contract.target_rate.Fraction(), 0.001);
 }
+
+TEST(Curve, FromOther) {
+    auto make_calendar = [] {
+        cdr::HolidayStorage hs;
+        hs.StaticInit()
+            ("USD", day(18)/January/year(2027))
+            ("EUR", day(2)/April/year(2027))
+        ;
+        return hs;
+    };
+    const DateType today = day(4)/January/year(2027);
+
+    cdr::MarketContext context(make_calendar(), today);
+    context.SetFxSpot({"EUR", "USD"}, 1.10);
+    auto usd = cdr::CurveBuilder(context)
+        .Jurisdiction("USD")
+        .Add(day(4)/January/year(2028), Percent::FromPercentage(4))
+        .FromPoints()
+    ;
+    const std::vector<cdr::ForwardContract> forwards = {
+        cdr::ForwardContract({"EUR", "USD"}, today, cdr::Tenor{12, cdr::TimeUnit::Month}, 1.12),
+    };
+
+    auto eur = cdr::CurveBuilder(context)
+        .Jurisdiction("EUR")
+        .FromOther(*usd, forwards.begin(), forwards.end())
+    ;
+    ASSERT_EQ(eur->GetJurisdiction(), "EUR");
+    ASSERT_EQ(eur->Pillars().size(), 1);
+
+    // Only curves of the same context combine, even if an other one holds equal data
+    cdr::MarketContext other_context(make_calendar(), today);
+    other_context.SetFxSpot({"EUR", "USD"}, 1.10);
+    auto other_usd = cdr::CurveBuilder(other_context)
+        .Jurisdiction("USD")
+        .Add(day(4)/January/year(2028), Percent::FromPercentage(4))
+        .FromPoints()
+    ;
+    EXPECT_DEATH((void)cdr::CurveBuilder(context)
+        .Jurisdiction("EUR")
+        .FromOther(*other_usd, forwards.begin(), forwards.end()), "Curves should share market context");
+}
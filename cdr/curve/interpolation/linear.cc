@@ -1,37 +1,44 @@
 #include <cdr/curve/interpolation/linear.h>
 #include <cdr/calendar/date.h>
+#include <cdr/base/check.h>
 #include <chrono>
 #include <numeric>
 
 namespace cdr {
 
+/* static */
+DateType Linear::LookupDate(const DateType& date, const HolidayStorage& hs, const JurisdictionType& jur) {
+    return hs.IsWeekend(jur, date) ? hs.FindNextWorkingDay(jur, date) : date;
+}
+
 /* static */
 cdr::Percent Linear::Interpolate(const cdr::Curve::PointsContainer& points, const DateType& date,
                                 const HolidayStorage& hs, const JurisdictionType& jur)
 {
-    if (hs.IsWeekend(jur, date)) {
-        return Interpolate(points, hs.FindPreviousWorkingDay(jur, date), hs, jur);
-    }
+    return Interpolate(points, LookupDate(date, hs, jur));
+}
 
+/* static */
+cdr::Percent Linear::Interpolate(const cdr::Curve::PointsContainer& points, const DateType& date) {
     if (points.empty()) [[unlikely]] {
         return Percent::Zero();
     }
 
-    auto lo_it = points.lower_bound(date);
+    auto up_it = points.lower_bound(date);
 
-    if (lo_it == points.end()) [[unlikely]] {
-        return std::prev(lo_it)->second;
+    if (up_it == points.end()) [[unlikely]] {
+        return std::prev(up_it)->second;
     }
 
-    if (lo_it->first == date) {
-        return lo_it->second;
+    if (up_it->first == date) {
+        return up_it->second;
     }
 
-    if (lo_it == points.begin()) [[unlikely]] {
-        return lo_it->second;
+    if (up_it == points.begin()) [[unlikely]] {
+        return up_it->second;
     }
 
-    auto up_it = points.upper_bound(date);
+    auto lo_it = std::prev(up_it);
 
     const auto& [lo_date, lo_value] = *lo_it;
     const auto& [up_date, up_value] = *up_it;
@@ -44,4 +51,65 @@ cdr::Percent Linear::Interpolate(const cdr::Curve::PointsContainer& points, cons
     return lo_value + (up_value - lo_value) * factor;
 }
 
+/* static */
+void Linear::Interpolate(const Curve::PointsContainer& points, std::span<const DateType> dates,
+                         const HolidayStorage& hs, const JurisdictionType& jur, std::span<f64> rates)
+{
+    CDR_CHECK(rates.size() >= dates.size()) << "output is too small";
+
+    auto up_it = points.begin();
+    DateType previous{};
+    for (u64 i = 0; i < dates.size(); ++i) {
+        // LookupDate is monotone, so adjusted dates stay increasing and the
+        // walk only moves forward
+        const DateType date = LookupDate(dates[i], hs, jur);
+        CDR_CHECK(i == 0 || previous <= date) << "dates must be increasing";
+        previous = date;
+
+        while (up_it != points.end() && up_it->first < date) {
+            ++up_it;
+        }
+
+        if (points.empty()) [[unlikely]] {
+            rates[i] = 0.;
+        } else if (up_it == points.end()) {
+            rates[i] = std::prev(up_it)->second.Fraction();
+        } else if (up_it->first == date || up_it == points.begin()) {
+            rates[i] = up_it->second.Fraction();
+        } else {
+            const auto lo_it = std::prev(up_it);
+            const auto lo_time = std::chrono::sys_days(lo_it->first).time_since_epoch().count();
+            const auto up_time = std::chrono::sys_days(up_it->first).time_since_epoch().count();
+            const auto mid_time = std::chrono::sys_days(date).time_since_epoch().count();
+
+            const f64 factor = f64(mid_time - lo_time) / f64(up_time - lo_time);
+            rates[i] = (lo_it->second + (up_it->second - lo_it->second) * factor).Fraction();
+        }
+    }
+}
+
+/* static */
+Linear::Weights Linear::InterpolationWeights(const Curve::PointsContainer& points, const DateType& date,
+                                             const HolidayStorage& hs, const JurisdictionType& jur)
+{
+    const DateType lookup_date = LookupDate(date, hs, jur);
+    auto up_it = points.lower_bound(lookup_date);
+    if (points.empty()) [[unlikely]] {
+        return {points.end(), points.end()};
+    }
+    if (up_it == points.end()) [[unlikely]] {
+        return {std::prev(up_it), std::prev(up_it)};
+    }
+    if (up_it->first == lookup_date || up_it == points.begin()) {
+        return {up_it, up_it};
+    }
+
+    auto lo_it = std::prev(up_it);
+    auto lo_time = std::chrono::sys_days(lo_it->first).time_since_epoch().count();
+    auto up_time = std::chrono::sys_days(up_it->first).time_since_epoch().count();
+    auto mid_time = std::chrono::sys_days(lookup_date).time_since_epoch().count();
+
+    return {lo_it, up_it, f64(mid_time - lo_time) / f64(up_time - lo_time)};
+}
+
 }  // namespace cdr
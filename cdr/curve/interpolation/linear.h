@@ -3,17 +3,56 @@
 #include <cdr/curve/curve.h>
 #include <cdr/calendar/holiday_storage.h>
 
+#include <span>
+
 namespace cdr {
 
 struct CDR_CURVE_EXPORT Linear {
 public:
     static constexpr bool kStatefulImplementation = false;
 
+    // Business day the calendar-aware overloads read the curve at: `date`
+    // itself, or the next working day for weekends and holidays
+    [[nodiscard]] static DateType LookupDate(const DateType& date,
+                                             const HolidayStorage& hs,
+                                             const JurisdictionType& jur);
+
     static Percent Interpolate(const Curve::PointsContainer& points,
                                const DateType& date,
                                const HolidayStorage& hs,
                                const JurisdictionType& jur);
 
+    // Same as above for a `date` already known to be a business day, e.g.
+    // a lookup date adjusted once when a contract schedule was built.
+    static Percent Interpolate(const Curve::PointsContainer& points,
+                               const DateType& date);
+
+    // Batch version of the first overload for increasing `dates`: one merged
+    // walk over the pillars, rates written as fractions into `rates`.
+    static void Interpolate(const Curve::PointsContainer& points,
+                            std::span<const DateType> dates,
+                            const HolidayStorage& hs,
+                            const JurisdictionType& jur,
+                            std::span<f64> rates);
+
+    // Pillars the first overload blends at `date`, for derivatives with
+    // respect to pillar values:
+    //
+    //   rate = lo->second * (1 - up_weight) + up->second * up_weight
+    //
+    // On a pillar and outside of the pillar range both are the same pillar,
+    // both are end() for an empty curve.
+    struct Weights {
+        Curve::PointsContainer::const_iterator lo;
+        Curve::PointsContainer::const_iterator up;
+        f64 up_weight = 0.;
+    };
+
+    static Weights InterpolationWeights(const Curve::PointsContainer& points,
+                                        const DateType& date,
+                                        const HolidayStorage& hs,
+                                        const JurisdictionType& jur);
+
     // Deprecated. Use cdr/math instead.
     static f64 InterpolateDerivative(const Curve::PointsContainer& points,
                                      const DateType& date,
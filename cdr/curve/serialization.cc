@@ -0,0 +1,138 @@
+#include <cdr/curve/serialization.h>
+
+#include <cstring>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace cdr {
+
+namespace {
+
+[[nodiscard]] bool ValidateImage(const std::byte* base, u64 size) noexcept {
+    if (size < sizeof(CurveFileHeader)) [[unlikely]] {
+        return false;
+    }
+
+    const auto* header = reinterpret_cast<const CurveFileHeader*>(base);
+    if (header->magic != CurveFileHeader::kMagic || header->version != CurveFileHeader::kVersion) {
+        return false;
+    }
+    if (header->total_size_in_bytes != size) {
+        return false;
+    }
+    if (header->interpolation != CurveInterpolation::kLinear) {
+        return false;
+    }
+
+    const u64 jurisdiction_end = u64{header->jurisdiction_byte_offset} + header->jurisdiction_size;
+    const u64 dates_end = u64{header->dates_byte_offset} + u64{header->pillars_size} * sizeof(i32);
+    const u64 rates_end = u64{header->rates_byte_offset} + u64{header->pillars_size} * sizeof(f64);
+
+    if (header->dates_byte_offset % alignof(i32) != 0 || header->rates_byte_offset % alignof(f64) != 0) {
+        return false;
+    }
+    if (jurisdiction_end > size || dates_end > size || rates_end > size) {
+        return false;
+    }
+
+    const auto* dates = reinterpret_cast<const i32*>(base + header->dates_byte_offset);
+    for (u32 i = 1; i < header->pillars_size; ++i) {
+        if (dates[i - 1] >= dates[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}  // namespace
+
+CurveImage::CurveImage(MappedFile file) noexcept
+    : file_(std::move(file))
+{
+    const std::byte* base = file_.Data();
+    header_ptr_ = reinterpret_cast<const CurveFileHeader*>(base);
+    jurisdiction_ptr_ = reinterpret_cast<const char*>(base + header_ptr_->jurisdiction_byte_offset);
+    dates_ptr_ = reinterpret_cast<const i32*>(base + header_ptr_->dates_byte_offset);
+    rates_ptr_ = reinterpret_cast<const f64*>(base + header_ptr_->rates_byte_offset);
+}
+
+/* static */
+Expect<CurveImage, Error> CurveImage::Open(const std::filesystem::path& path) noexcept {
+    auto file = MappedFile::Open(path);
+    if (file.Failed()) [[unlikely]] {
+        return Failure<Error>(file.GetFailure());
+    }
+
+    if (!ValidateImage(file.Value().Data(), file.Value().Size())) [[unlikely]] {
+        return ErrorCorruptedData();
+    }
+
+    return Ok<CurveImage>(std::in_place, CurveImage(std::move(file.Value())));
+}
+
+Expect<std::unique_ptr<Curve>, Error> CurveImage::Restore(MarketContextView ctx) const {
+    if (ctx.Today() != Today()) [[unlikely]] {
+        return ErrorInvalidInput();
+    }
+
+    auto curve = Curve::Create(ctx, JurisdictionType(Jurisdiction()));
+
+    const auto dates = Dates();
+    const auto rates = Rates();
+
+    // Dates are validated to be strictly increasing, so every node goes to the end.
+    for (u64 i = 0; i < dates.size(); ++i) {
+        curve->points_.emplace_hint(curve->points_.end(), FromDaysSinceEpoch(dates[i]),
+                                    Percent::FromFraction(rates[i]));
+    }
+
+    return Ok(std::move(curve));
+}
+
+Expect<void, Error> WriteCurve(const Curve& curve, const std::filesystem::path& path,
+                               CurveInterpolation interpolation) noexcept {
+    const auto& pillars = curve.Pillars();
+    const JurisdictionType jurisdiction = curve.GetJurisdiction();
+
+    const u64 jurisdiction_offset = sizeof(CurveFileHeader);
+    const u64 dates_offset = AlignOffset(jurisdiction_offset + jurisdiction.size(), alignof(i32));
+    const u64 rates_offset = AlignOffset(dates_offset + pillars.size() * sizeof(i32), alignof(f64));
+    const u64 total_size = rates_offset + pillars.size() * sizeof(f64);
+
+    std::vector<std::byte> buffer;
+    try {
+        buffer.resize(total_size);
+    } catch (const std::bad_alloc&) {
+        return ErrorNoMemory();
+    }
+
+    CurveFileHeader header{};
+    header.magic = CurveFileHeader::kMagic;
+    header.version = CurveFileHeader::kVersion;
+    header.interpolation = interpolation;
+    header.today = DaysSinceEpoch(curve.Today());
+    header.pillars_size = static_cast<u32>(pillars.size());
+    header.jurisdiction_size = static_cast<u32>(jurisdiction.size());
+    header.jurisdiction_byte_offset = static_cast<u32>(jurisdiction_offset);
+    header.dates_byte_offset = static_cast<u32>(dates_offset);
+    header.rates_byte_offset = static_cast<u32>(rates_offset);
+    header.total_size_in_bytes = total_size;
+
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    std::memcpy(buffer.data() + jurisdiction_offset, jurisdiction.data(), jurisdiction.size());
+
+    u64 idx = 0;
+    for (const auto& [date, rate] : pillars) {
+        const i32 days = DaysSinceEpoch(date);
+        const f64 fraction = rate.Fraction();
+        std::memcpy(buffer.data() + dates_offset + idx * sizeof(i32), &days, sizeof(days));
+        std::memcpy(buffer.data() + rates_offset + idx * sizeof(f64), &fraction, sizeof(fraction));
+        ++idx;
+    }
+
+    return WriteFileAtomically(path, buffer);
+}
+
+}  // namespace cdr
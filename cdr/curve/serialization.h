@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cdr/curve/curve.h>
+#include <cdr/base/mapped_file.h>
+#include <cdr/types/errors.h>
+#include <cdr/types/expect.h>
+#include <cdr/types/integers.h>
+#include <cdr/curve/internal/export.h>
+
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+
+namespace cdr {
+
+enum class CurveInterpolation : u8 {
+    kLinear = 0,
+};
+
+// On-disk layout of a serialized curve:
+//
+//   [CurveFileHeader][jurisdiction chars][i32 pillar dates][f64 zero rates]
+//
+// Every section starts at an offset aligned for its element type, so a mapped
+// file can be read in place. Dates are stored as days since the unix epoch,
+// zero rates as fractions.
+struct CurveFileHeader {
+    static constexpr u32 kMagic = 0x43524443;  // "CDRC"
+    static constexpr u16 kVersion = 1;
+
+    u32 magic;
+    u16 version;
+    CurveInterpolation interpolation;
+    u8 reserved;
+
+    i32 today;
+
+    u32 pillars_size;
+    u32 jurisdiction_size;
+
+    u32 jurisdiction_byte_offset;
+    u32 dates_byte_offset;
+    u32 rates_byte_offset;
+
+    u64 total_size_in_bytes;
+};
+
+// Read-only view of a serialized curve. Backed by a memory mapping of the
+// file (or by an in-memory copy on platforms without mmap), so opening an
+// image costs one syscall and a header validation regardless of curve size.
+class CDR_CURVE_EXPORT CurveImage final {
+public:
+    CurveImage(const CurveImage&) = delete;
+    CurveImage& operator=(const CurveImage&) = delete;
+
+    CurveImage(CurveImage&& other) noexcept = default;
+    CurveImage& operator=(CurveImage&& other) noexcept = default;
+
+    [[nodiscard]] static Expect<CurveImage, Error> Open(const std::filesystem::path& path) noexcept;
+
+    [[nodiscard]] const CurveFileHeader& Header() const noexcept {
+        return *header_ptr_;
+    }
+
+    [[nodiscard]] DateType Today() const noexcept {
+        return FromDaysSinceEpoch(header_ptr_->today);
+    }
+
+    [[nodiscard]] CurveInterpolation Interpolation() const noexcept {
+        return header_ptr_->interpolation;
+    }
+
+    [[nodiscard]] std::string_view Jurisdiction() const noexcept {
+        return {jurisdiction_ptr_, header_ptr_->jurisdiction_size};
+    }
+
+    [[nodiscard]] std::span<const i32> Dates() const noexcept {
+        return {dates_ptr_, header_ptr_->pillars_size};
+    }
+
+    [[nodiscard]] std::span<const f64> Rates() const noexcept {
+        return {rates_ptr_, header_ptr_->pillars_size};
+    }
+
+    // Rebuilds a curve bound to `ctx` without bootstrapping.
+    // Fails with Error::InvalidInput if the image was taken on another day.
+    [[nodiscard]] Expect<std::unique_ptr<Curve>, Error> Restore(MarketContextView ctx) const;
+
+private:
+    explicit CurveImage(MappedFile file) noexcept;
+
+private:
+    MappedFile file_;
+
+    const CurveFileHeader* header_ptr_ = nullptr;
+    const char* jurisdiction_ptr_ = nullptr;
+    const i32* dates_ptr_ = nullptr;
+    const f64* rates_ptr_ = nullptr;
+};
+
+// Writes `curve` to `path` atomically: the image is written next to the
+// target and renamed over it, so readers never observe a partial file.
+[[nodiscard]] CDR_CURVE_EXPORT Expect<void, Error> WriteCurve(const Curve& curve, const std::filesystem::path& path,
+                                                              CurveInterpolation interpolation = CurveInterpolation::kLinear) noexcept;
+
+}  // namespace cdr
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <cdr/curve/curve.h>
+#include <cdr/curve/serialization.h>
+#include <cdr/curve/interpolation/linear.h>
+#include <cdr/calendar/holiday_storage.h>
+#include <cdr/market/context.h>
+
+#include <filesystem>
+#include <fstream>
+
+using namespace std::chrono;
+using cdr::Percent;
+
+namespace {
+
+std::filesystem::path TempCurvePath(const std::string& name) {
+    return std::filesystem::temp_directory_path() / ("cdr_curve_" + name + ".bin");
+}
+
+}  // anonymous namespace
+
+TEST(CurveSerialization, RoundTrip) {
+    cdr::HolidayStorage hs;
+    hs.StaticInit()
+        ("USD", day(1)/January/year(2027))
+    ;
+    DateType today = day(4)/January/year(2027);
+    cdr::MarketContext context(std::move(hs), today);
+
+    auto curve = cdr::CurveBuilder(context)
+        .Jurisdiction("USD")
+        .Add(day(5)/January/year(2027), Percent::FromPercentage(4.25))
+        .Add(day(5)/April/year(2027), Percent::FromPercentage(4.5))
+        .Add(day(5)/January/year(2028), Percent::FromPercentage(4.125))
+        .Add(day(5)/January/year(2032), Percent::FromPercentage(3.875))
+        .FromPoints()
+    ;
+
+    const auto path = TempCurvePath("round_trip");
+    ASSERT_TRUE(cdr::WriteCurve(*curve, path).Succeed());
+
+    auto image = cdr::CurveImage::Open(path);
+    ASSERT_TRUE(image.Succeed());
+    ASSERT_EQ(image.Value().Today(), today);
+    ASSERT_EQ(image.Value().Jurisdiction(), "USD");
+    ASSERT_EQ(image.Value().Interpolation(), cdr::CurveInterpolation::kLinear);
+    ASSERT_EQ(image.Value().Dates().size(), curve->Pillars().size());
+
+    auto restored = image.Value().Restore(context);
+    ASSERT_TRUE(restored.Succeed());
+    const auto& restored_curve = *restored.Value();
+
+    ASSERT_EQ(restored_curve.GetJurisdiction(), "USD");
+    ASSERT_EQ(restored_curve.Today(), curve->Today());
+    ASSERT_TRUE(std::equal(curve->Pillars().begin(), curve->Pillars().end(),
+                           restored_curve.Pillars().begin(), restored_curve.Pillars().end()));
+
+    const DateType query = day(15)/June/year(2033);
+    ASSERT_EQ(restored_curve.Interpolated<cdr::Linear>(query, context.Calendar(), "USD"),
+              curve->Interpolated<cdr::Linear>(query, context.Calendar(), "USD"));
+
+    std::filesystem::remove(path);
+}
+
+TEST(CurveSerialization, StaleImage) {
+    cdr::HolidayStorage hs;
+    hs.StaticInit()
+        ("USD", day(1)/January/year(2027))
+    ;
+    DateType today = day(4)/January/year(2027);
+    cdr::MarketContext context(std::move(hs), today);
+
+    auto curve = cdr::CurveBuilder(context)
+        .Jurisdiction("USD")
+        .Add(day(5)/April/year(2027), Percent::FromPercentage(4.5))
+        .FromPoints()
+    ;
+
+    const auto path = TempCurvePath("stale");
+    ASSERT_TRUE(cdr::WriteCurve(*curve, path).Succeed());
+
+    context.SetToday(day(5)/January/year(2027));
+    auto image = cdr::CurveImage::Open(path);
+    ASSERT_TRUE(image.Succeed());
+    ASSERT_EQ(image.Value().Restore(context), cdr::ErrorInvalidInput());
+
+    std::filesystem::remove(path);
+}
+
+TEST(CurveSerialization, CorruptedImage) {
+    const auto path = TempCurvePath("corrupted");
+    {
+        std::ofstream output(path, std::ios::binary | std::ios::trunc);
+        output << "definitely not a curve image, but long enough to hold a header";
+    }
+
+    ASSERT_EQ(cdr::CurveImage::Open(path), cdr::ErrorCorruptedData());
+    ASSERT_EQ(cdr::CurveImage::Open(TempCurvePath("missing")), cdr::ErrorIOFailure());
+
+    std::filesystem::remove(path);
+}
@@ -1,19 +1,94 @@
 #pragma once
 
 #include <cdr/types/types.h>
+#include <cdr/base/check.h>
 #include <cdr/calendar/date.h>
 #include <cdr/calendar/freq.h>
 
+#include <bit>
+#include <compare>
+#include <string>
+#include <string_view>
 #include <utility>
 
 namespace cdr {
 
+// Currency pair packed into 64 bits: the base currency code in the high
+// half, the quote one in the low half. A code is up to 4 ASCII characters,
+// first character in the most significant byte. Keys of distinct pairs never
+// collide, reversing a pair swaps the halves, and zero is never a valid key.
+class FXPairKey {
+public:
+    constexpr FXPairKey() = default;
+
+    [[nodiscard]] static u32 PackCode(std::string_view code) {
+        CDR_CHECK(!code.empty() && code.size() <= 4) << "currency code must have 1 to 4 characters: " << code;
+        u32 packed = 0;
+        for (u64 i = 0; i < 4; ++i) {
+            packed = (packed << 8) | (i < code.size() ? static_cast<u8>(code[i]) : 0u);
+        }
+        return packed;
+    }
+
+    // Inverse of PackCode
+    [[nodiscard]] static std::string UnpackCode(u32 packed) {
+        std::string code;
+        for (u32 shift = 32; shift > 0 && static_cast<u8>(packed >> (shift - 8)) != 0; shift -= 8) {
+            code.push_back(static_cast<char>(packed >> (shift - 8)));
+        }
+        return code;
+    }
+
+    [[nodiscard]] static FXPairKey Pack(std::string_view base, std::string_view quote) {
+        return FromCodes(PackCode(base), PackCode(quote));
+    }
+
+    [[nodiscard]] static constexpr FXPairKey FromCodes(u32 base, u32 quote) noexcept {
+        return FXPairKey((u64{base} << 32) | quote);
+    }
+
+    [[nodiscard]] constexpr u32 Base() const noexcept {
+        return static_cast<u32>(value_ >> 32);
+    }
+
+    [[nodiscard]] constexpr u32 Quote() const noexcept {
+        return static_cast<u32>(value_);
+    }
+
+    [[nodiscard]] constexpr u64 Value() const noexcept {
+        return value_;
+    }
+
+    [[nodiscard]] constexpr bool Empty() const noexcept {
+        return value_ == 0;
+    }
+
+    [[nodiscard]] constexpr FXPairKey Reversed() const noexcept {
+        return FXPairKey(std::rotl(value_, 32));
+    }
+
+    friend constexpr auto operator<=>(const FXPairKey&, const FXPairKey&) = default;
+
+private:
+    explicit constexpr FXPairKey(u64 value) noexcept : value_(value) {}
+
+    u64 value_ = 0;
+};
+
 struct FXPair : std::pair<CurrencyTag, CurrencyTag> {
     using std::pair<CurrencyTag, CurrencyTag>::pair;
 
     [[nodiscard]] FXPair Reversed() const noexcept {
         return FXPair(second, first);
     }
+
+    [[nodiscard]] FXPairKey Key() const {
+        return FXPairKey::Pack(first, second);
+    }
+
+    [[nodiscard]] static FXPair FromKey(FXPairKey key) {
+        return FXPair(FXPairKey::UnpackCode(key.Base()), FXPairKey::UnpackCode(key.Quote()));
+    }
 };
 
 class ForwardContract {
@@ -59,11 +134,19 @@ private:
 }  // namespace cdr
 
 namespace std {
+template <>
+struct hash<cdr::FXPairKey> {
+    size_t operator()(const cdr::FXPairKey& key) const noexcept {
+        // Multiply and fold, so both codes reach every bit of the hash
+        const u64 mixed = key.Value() * 0x9e3779b97f4a7c15ull;
+        return static_cast<size_t>(mixed ^ (mixed >> 32));
+    }
+};
+
 template <>
 struct hash<cdr::FXPair> {
     size_t operator()(const cdr::FXPair& pair) const {
-        auto hash = std::hash<JurisdictionType>{};
-        return hash(pair.first) ^ hash(pair.second);
+        return std::hash<cdr::FXPairKey>{}(pair.Key());
     }
 };
 
@@ -2,23 +2,44 @@
 
 namespace cdr {
 
-DateType MarketContext::SpotDate(const FXPair& pair) const noexcept {
-    // TODO: Spot settlement rule
-    return Today();
+DateType MarketContext::SpotDate(FXPairKey pair) const {
+    {
+        std::shared_lock lock(spot_dates_mutex_);
+        if (const auto date = spot_dates_.Find(pair)) [[likely]] {
+            return *date;
+        }
+    }
+    std::unique_lock lock(spot_dates_mutex_);
+    return spot_dates_.Resolve(*calendar_, pair);
+}
+
+f64 MarketContext::FxSpot(FXPairKey pair) const {
+    const auto spot = FindFxSpot(pair);
+    CDR_CHECK(spot.has_value());
+    return *spot;
 }
 
-f64 MarketContext::FxSpot(const FXPair& pair) const {
-    auto iter = fx_spots_.find(pair);
-    if (iter != fx_spots_.end()) [[likely]] {
-        return iter->second;
+std::optional<f64> MarketContext::FindFxSpot(FXPairKey pair) const {
+    if (const auto spot = fx_spots_.Find(pair)) [[likely]] {
+        return spot;
     }
-    iter = fx_spots_.find(pair.Reversed());
-    CDR_CHECK(iter != fx_spots_.end());
-    return 1. / iter->second;
+    return FxCrosses()->Find(pair);
+}
+
+void MarketContext::SetFxSpot(FXPairKey pair, f64 spot) {
+    fx_spots_.Set(pair, spot);
+
+    std::unique_lock lock(fx_crosses_write_mutex_);
+    auto crosses = std::make_shared<FxCrossMatrix>(*fx_crosses_.load(std::memory_order_relaxed));
+    crosses->Set(pair, spot);
+    fx_crosses_.store(std::move(crosses), std::memory_order_release);
 }
 
-void MarketContext::SetFxSpot(const FXPair& pair, f64 spot) {
-    fx_spots_.insert_or_assign(pair, spot);
+void MarketContext::SetFxVehicles(std::vector<CurrencyTag> vehicles) {
+    std::unique_lock lock(fx_crosses_write_mutex_);
+    auto crosses = std::make_shared<FxCrossMatrix>(*fx_crosses_.load(std::memory_order_relaxed));
+    crosses->SetVehicles(std::move(vehicles));
+    fx_crosses_.store(std::move(crosses), std::memory_order_release);
 }
 
 }  // namespace cdr
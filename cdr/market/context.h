@@ -4,10 +4,17 @@
 #include <cdr/base/check.h>
 #include <cdr/calendar/date.h>
 #include <cdr/calendar/holiday_storage.h>
+#include <cdr/market/fx_spots.h>
+#include <cdr/market/fx_crosses.h>
+#include <cdr/market/spot_dates.h>
 #include <cdr/fx/fx.h>
 
-#include <unordered_map>
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
 
 namespace cdr {
 
@@ -16,35 +23,97 @@ class MarketContextView;
 class CDR_MARKET_EXPORT MarketContext {
 public:
     MarketContext(HolidayStorage&& calendar, DateType today)
+        : MarketContext(std::make_shared<const HolidayStorage>(std::move(calendar)), today)
+    {}
+
+    // Shares an immutable calendar with other contexts, e.g. market snapshots
+    MarketContext(std::shared_ptr<const HolidayStorage> calendar, DateType today)
         : fx_spots_()
+        , fx_crosses_(std::make_shared<const FxCrossMatrix>())
         , calendar_(std::move(calendar))
         , today_(today)
-    {}
+    {
+        CDR_CHECK(calendar_ != nullptr) << "calendar is required";
+        spot_dates_.Reset(*calendar_, today);
+    }
 
     MarketContext(const MarketContext&) = delete;
     MarketContext& operator=(const MarketContext&) = delete;
 
     [[nodiscard]] DateType Today() const noexcept {
-        return today_;
+        return today_.load(std::memory_order_acquire);
     }
 
-    [[nodiscard]] DateType SpotDate(const FXPair& pair) const noexcept;
+    [[nodiscard]] DateType SpotDate(const FXPair& pair) const {
+        return SpotDate(pair.Key());
+    }
 
-    void SetToday(DateType date) noexcept {
-        today_ = date;
+    // Spot dates are resolved for every known pair on SetToday, so this is a
+    // table read; pairs met for the first time are resolved once and kept
+    // until the next today. See SpotDateTable for the rules.
+    [[nodiscard]] DateType SpotDate(FXPairKey pair) const;
+
+    // May be called while other threads price off the context
+    void SetToday(DateType date) {
+        std::unique_lock lock(spot_dates_mutex_);
+        today_.store(date, std::memory_order_release);
+        spot_dates_.Reset(*calendar_, date);
+    }
+
+    // Spot lag of `pair` in business days, T+2 unless set
+    void SetFxSpotLag(const FXPair& pair, u32 lag) {
+        std::unique_lock lock(spot_dates_mutex_);
+        spot_dates_.SetLag(pair.Key(), lag);
     }
 
-    [[nodiscard]] f64 FxSpot(const FXPair& pair) const;
-    void SetFxSpot(const FXPair& pair, f64 spot);
+    [[nodiscard]] f64 FxSpot(const FXPair& pair) const {
+        return FxSpot(pair.Key());
+    }
+
+    // Quotes of the reversed pair are inverted, pairs without a quote are
+    // crossed through the vehicle currencies.
+    // FxSpot and SetFxSpot may be called concurrently and neither waits for
+    // the other: quoted pairs are read from the sequence-locked spot table,
+    // crosses from the latest published cross matrix.
+    [[nodiscard]] f64 FxSpot(FXPairKey pair) const;
+
+    // Same as FxSpot, nullopt for pairs that can't be quoted or crossed
+    [[nodiscard]] std::optional<f64> FindFxSpot(FXPairKey pair) const;
+
+    void SetFxSpot(const FXPair& pair, f64 spot) {
+        SetFxSpot(pair.Key(), spot);
+    }
+
+    // Publishes a new cross matrix, O(N^2) in the number of currencies.
+    // Concurrent writers are serialized, readers are never waited for.
+    void SetFxSpot(FXPairKey pair, f64 spot);
+
+    // Vehicle currencies of crosses, highest priority first. USD by default.
+    void SetFxVehicles(std::vector<CurrencyTag> vehicles);
+
+    // Cross matrix as of the last SetFxSpot. The matrix is immutable and
+    // stays alive while pinned, later ticks publish a new one.
+    [[nodiscard]] std::shared_ptr<const FxCrossMatrix> FxCrosses() const noexcept {
+        return fx_crosses_.load(std::memory_order_acquire);
+    }
 
     [[nodiscard]] const HolidayStorage& Calendar() const {
-        return calendar_;
+        return *calendar_;
     };
 
+    [[nodiscard]] const std::shared_ptr<const HolidayStorage>& SharedCalendar() const noexcept {
+        return calendar_;
+    }
+
 private:
-    std::unordered_map<FXPair, f64> fx_spots_;
-    HolidayStorage calendar_;
-    DateType today_;
+    FxSpotTable fx_spots_;
+    // Copied, updated and swapped by writers, read-copy-update style
+    std::atomic<std::shared_ptr<const FxCrossMatrix>> fx_crosses_;
+    std::mutex fx_crosses_write_mutex_;
+    std::shared_ptr<const HolidayStorage> calendar_;
+    std::atomic<DateType> today_;
+    mutable SpotDateTable spot_dates_;
+    mutable std::shared_mutex spot_dates_mutex_;
 };
 
 class CDR_MARKET_EXPORT MarketContextView {
@@ -55,7 +124,11 @@ public:
         return context_.Today();
     }
 
-    [[nodiscard]] DateType SpotDate(const FXPair& pair) const noexcept {
+    [[nodiscard]] DateType SpotDate(const FXPair& pair) const {
+        return context_.SpotDate(pair);
+    }
+
+    [[nodiscard]] DateType SpotDate(FXPairKey pair) const {
         return context_.SpotDate(pair);
     }
 
@@ -63,9 +136,26 @@ public:
         return context_.FxSpot(pair);
     }
 
+    [[nodiscard]] f64 FxSpot(FXPairKey pair) const {
+        return context_.FxSpot(pair);
+    }
+
+    [[nodiscard]] std::optional<f64> FindFxSpot(FXPairKey pair) const {
+        return context_.FindFxSpot(pair);
+    }
+
+    [[nodiscard]] std::shared_ptr<const FxCrossMatrix> FxCrosses() const noexcept {
+        return context_.FxCrosses();
+    }
+
     [[nodiscard]] const HolidayStorage& Calendar() const {
         return context_.Calendar();
     }
+
+    // Whether both views refer to the same MarketContext object
+    [[nodiscard]] bool SharesContext(const MarketContextView& other) const noexcept {
+        return &context_ == &other.context_;
+    }
 private:
     const MarketContext& context_;
 };
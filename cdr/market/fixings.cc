@@ -0,0 +1,334 @@
+#include <cdr/market/fixings.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <new>
+#include <utility>
+
+namespace cdr {
+
+namespace {
+
+constexpr f64 kNoFixing = std::numeric_limits<f64>::quiet_NaN();
+
+[[nodiscard]] bool ValidateImage(const std::byte* base, u64 size) noexcept {
+    if (size < sizeof(FixingsFileHeader)) [[unlikely]] {
+        return false;
+    }
+
+    const auto* header = reinterpret_cast<const FixingsFileHeader*>(base);
+    if (header->magic != FixingsFileHeader::kMagic || header->version != FixingsFileHeader::kVersion) {
+        return false;
+    }
+    if (header->total_size_in_bytes != size) {
+        return false;
+    }
+    if (header->entries_byte_offset % alignof(FixingsSeriesEntry) != 0 || header->values_byte_offset % alignof(f64) != 0) {
+        return false;
+    }
+
+    const u64 entries_end = u64{header->entries_byte_offset} + u64{header->series_size} * sizeof(FixingsSeriesEntry);
+    const u64 names_end = u64{header->names_byte_offset} + header->names_size;
+    if (entries_end > size || names_end > size) {
+        return false;
+    }
+    if (header->values_size > (size - std::min(size, header->values_byte_offset)) / sizeof(f64)) {
+        return false;
+    }
+
+    const auto* entries = reinterpret_cast<const FixingsSeriesEntry*>(base + header->entries_byte_offset);
+    const auto* names = reinterpret_cast<const char*>(base + header->names_byte_offset);
+    for (u32 i = 0; i < header->series_size; ++i) {
+        const auto& entry = entries[i];
+        if (u64{entry.name_offset} + entry.name_size > header->names_size) {
+            return false;
+        }
+        if (entry.days > entry.capacity || entry.values_offset > header->values_size
+            || entry.capacity > header->values_size - entry.values_offset) {
+            return false;
+        }
+        if (i > 0) {
+            const auto& prev = entries[i - 1];
+            if (std::string_view(names + prev.name_offset, prev.name_size)
+                >= std::string_view(names + entry.name_offset, entry.name_size)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+}  // namespace
+
+/* FixingSeries */
+
+[[nodiscard]] std::optional<f64> FixingSeries::Find(const DateType& date) const noexcept {
+    const i64 offset = i64{DaysSinceEpoch(date)} - first_day_;
+    if (offset < 0 || offset >= static_cast<i64>(values_.size())) {
+        return std::nullopt;
+    }
+
+    const f64 value = values_[static_cast<u64>(offset)];
+    if (std::isnan(value)) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+/* FixingsImage */
+
+FixingsImage::FixingsImage(MappedFile file) noexcept
+    : file_(std::move(file))
+{
+    const std::byte* base = file_.Data();
+    header_ptr_ = reinterpret_cast<const FixingsFileHeader*>(base);
+    entries_ptr_ = reinterpret_cast<const FixingsSeriesEntry*>(base + header_ptr_->entries_byte_offset);
+    names_ptr_ = reinterpret_cast<const char*>(base + header_ptr_->names_byte_offset);
+    values_ptr_ = reinterpret_cast<const f64*>(base + header_ptr_->values_byte_offset);
+}
+
+/* static */
+Expect<FixingsImage, Error> FixingsImage::Open(const std::filesystem::path& path) noexcept {
+    auto file = MappedFile::Open(path);
+    if (file.Failed()) [[unlikely]] {
+        return Failure<Error>(file.GetFailure());
+    }
+
+    if (!ValidateImage(file.Value().Data(), file.Value().Size())) [[unlikely]] {
+        return ErrorCorruptedData();
+    }
+
+    return Ok<FixingsImage>(std::in_place, FixingsImage(std::move(file.Value())));
+}
+
+[[nodiscard]] std::string_view FixingsImage::Name(u64 idx) const noexcept {
+    const auto& entry = entries_ptr_[idx];
+    return {names_ptr_ + entry.name_offset, entry.name_size};
+}
+
+[[nodiscard]] FixingSeries FixingsImage::Series(u64 idx) const noexcept {
+    const auto& entry = Entry(idx);
+    return FixingSeries(entry.first_day, std::span<const f64>(values_ptr_ + entry.values_offset, entry.days));
+}
+
+[[nodiscard]] std::optional<u64> FixingsImage::IndexOf(std::string_view index) const noexcept {
+    u64 lo = 0;
+    u64 hi = Size();
+    while (lo < hi) {
+        const u64 mid = lo + (hi - lo) / 2;
+        if (Name(mid) < index) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo == Size() || Name(lo) != index) {
+        return std::nullopt;
+    }
+    return lo;
+}
+
+[[nodiscard]] std::optional<FixingSeries> FixingsImage::Find(std::string_view index) const noexcept {
+    const auto idx = IndexOf(index);
+    if (!idx.has_value()) {
+        return std::nullopt;
+    }
+    return Series(*idx);
+}
+
+/* FixingsStore */
+
+/* static */
+[[nodiscard]] FixingsStore FixingsStore::FromImage(const FixingsImage& image) {
+    FixingsStore store;
+    for (u64 idx = 0; idx < image.Size(); ++idx) {
+        const auto series = image.Series(idx);
+        store.series_.emplace_hint(store.series_.end(), std::string(image.Name(idx)),
+                                   Column{series.FirstDay(), {series.Values().begin(), series.Values().end()}});
+    }
+    return store;
+}
+
+[[nodiscard]] Expect<void, Error> FixingsStore::Append(std::string_view index, const DateType& date, f64 value) {
+    if (index.empty() || std::isnan(value)) [[unlikely]] {
+        return ErrorInvalidInput();
+    }
+
+    const i32 day = DaysSinceEpoch(date);
+    auto it = series_.find(index);
+    if (it == series_.end()) {
+        it = series_.emplace(std::string(index), Column{day, {}}).first;
+    }
+
+    auto& column = it->second;
+    const i64 offset = i64{day} - column.first_day;
+    if (offset < static_cast<i64>(column.values.size())) [[unlikely]] {
+        return ErrorInvalidInput();
+    }
+
+    column.values.resize(static_cast<u64>(offset), kNoFixing);
+    column.values.push_back(value);
+    return Ok();
+}
+
+[[nodiscard]] std::optional<FixingSeries> FixingsStore::Find(std::string_view index) const noexcept {
+    auto it = series_.find(index);
+    if (it == series_.end()) {
+        return std::nullopt;
+    }
+    return FixingSeries(it->second.first_day, it->second.values);
+}
+
+Expect<void, Error> WriteFixings(const FixingsStore& store, const std::filesystem::path& path,
+                                 u32 reserve_days) noexcept {
+    const auto& series = store.series_;
+    auto capacity_of = [&](const FixingsStore::Column& column) {
+        return column.values.size() + reserve_days;
+    };
+
+    u64 names_size = 0;
+    u64 values_size = 0;
+    for (const auto& [name, column] : series) {
+        names_size += name.size();
+        values_size += capacity_of(column);
+    }
+
+    const u64 entries_offset = AlignOffset(sizeof(FixingsFileHeader), alignof(FixingsSeriesEntry));
+    const u64 names_offset = entries_offset + series.size() * sizeof(FixingsSeriesEntry);
+    const u64 values_offset = AlignOffset(names_offset + names_size, alignof(f64));
+    const u64 total_size = values_offset + values_size * sizeof(f64);
+
+    std::vector<std::byte> buffer;
+    try {
+        buffer.resize(total_size);
+    } catch (const std::bad_alloc&) {
+        return ErrorNoMemory();
+    }
+
+    FixingsFileHeader header{};
+    header.magic = FixingsFileHeader::kMagic;
+    header.version = FixingsFileHeader::kVersion;
+    header.series_size = static_cast<u32>(series.size());
+    header.entries_byte_offset = static_cast<u32>(entries_offset);
+    header.names_byte_offset = static_cast<u32>(names_offset);
+    header.names_size = static_cast<u32>(names_size);
+    header.values_byte_offset = values_offset;
+    header.values_size = values_size;
+    header.total_size_in_bytes = total_size;
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    u64 idx = 0;
+    u64 name_cursor = 0;
+    u64 value_cursor = 0;
+    for (const auto& [name, column] : series) {
+        const FixingsSeriesEntry entry{
+            .name_offset = static_cast<u32>(name_cursor),
+            .name_size = static_cast<u32>(name.size()),
+            .first_day = column.first_day,
+            .days = static_cast<u32>(column.values.size()),
+            .capacity = static_cast<u32>(capacity_of(column)),
+            .reserved = 0,
+            .values_offset = value_cursor,
+        };
+        std::memcpy(buffer.data() + entries_offset + idx * sizeof(entry), &entry, sizeof(entry));
+        std::memcpy(buffer.data() + names_offset + name_cursor, name.data(), name.size());
+
+        auto* values = buffer.data() + values_offset + value_cursor * sizeof(f64);
+        std::memcpy(values, column.values.data(), column.values.size() * sizeof(f64));
+        for (u64 day = column.values.size(); day < entry.capacity; ++day) {
+            std::memcpy(values + day * sizeof(f64), &kNoFixing, sizeof(f64));
+        }
+
+        ++idx;
+        name_cursor += name.size();
+        value_cursor += entry.capacity;
+    }
+
+    return WriteFileAtomically(path, buffer);
+}
+
+namespace {
+
+// AppendFixing without the allocation guard: loading the store back and
+// opening the file stream may throw std::bad_alloc
+[[nodiscard]] Expect<void, Error> AppendFixingUnguarded(const std::filesystem::path& path, std::string_view index,
+                                                        const DateType& date, f64 value) {
+    if (index.empty() || std::isnan(value)) [[unlikely]] {
+        return ErrorInvalidInput();
+    }
+
+    // Byte offsets of the value slot and of the day count to update
+    u64 value_offset = 0;
+    u64 days_offset = 0;
+    u32 days = 0;
+    std::optional<FixingsStore> rewritten;
+
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec)) {
+        rewritten.emplace();
+    } else {
+        auto image = FixingsImage::Open(path);
+        if (image.Failed()) [[unlikely]] {
+            return Failure<Error>(image.GetFailure());
+        }
+
+        const auto& header = image.Value().Header();
+        const auto idx = image.Value().IndexOf(index);
+        const auto* entry = idx.has_value() ? &image.Value().Entry(*idx) : nullptr;
+        const i64 offset = entry != nullptr ? i64{DaysSinceEpoch(date)} - entry->first_day : 0;
+        if (entry != nullptr && offset < static_cast<i64>(entry->days)) [[unlikely]] {
+            return ErrorInvalidInput();
+        }
+
+        if (entry == nullptr || offset >= static_cast<i64>(entry->capacity)) {
+            rewritten = FixingsStore::FromImage(image.Value());
+        } else {
+            value_offset = header.values_byte_offset + (entry->values_offset + static_cast<u64>(offset)) * sizeof(f64);
+            days_offset = header.entries_byte_offset + *idx * sizeof(FixingsSeriesEntry)
+                + offsetof(FixingsSeriesEntry, days);
+            days = static_cast<u32>(offset) + 1;
+        }
+    }
+
+    if (rewritten.has_value()) {
+        if (auto appended = rewritten->Append(index, date, value); appended.Failed()) [[unlikely]] {
+            return appended;
+        }
+        return WriteFixings(*rewritten, path);
+    }
+
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file) [[unlikely]] {
+        return ErrorIOFailure();
+    }
+    file.seekp(static_cast<std::streamoff>(value_offset));
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    if (!file.flush()) [[unlikely]] {
+        return ErrorIOFailure();
+    }
+    file.seekp(static_cast<std::streamoff>(days_offset));
+    file.write(reinterpret_cast<const char*>(&days), sizeof(days));
+    if (!file.flush()) [[unlikely]] {
+        return ErrorIOFailure();
+    }
+    return Ok();
+}
+
+}  // namespace
+
+Expect<void, Error> AppendFixing(const std::filesystem::path& path, std::string_view index, const DateType& date,
+                                 f64 value) noexcept {
+    try {
+        return AppendFixingUnguarded(path, index, date, value);
+    } catch (const std::bad_alloc&) {
+        return ErrorNoMemory();
+    }
+}
+
+}  // namespace cdr
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <cdr/base/mapped_file.h>
+#include <cdr/calendar/date.h>
+#include <cdr/types/errors.h>
+#include <cdr/types/expect.h>
+#include <cdr/types/integers.h>
+#include <cdr/types/floats.h>
+#include <cdr/market/internal/export.h>
+
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cdr {
+
+// Daily fixings of one index (e.g. "SOFR") as a dense column starting at
+// FirstDay(), days since the unix epoch. Days without a fixing hold NaN, so
+// a lookup is a single offset into the column.
+class CDR_MARKET_EXPORT FixingSeries final {
+public:
+    FixingSeries() = default;
+    FixingSeries(i32 first_day, std::span<const f64> values) noexcept
+        : values_(values)
+        , first_day_(first_day)
+    {}
+
+    [[nodiscard]] i32 FirstDay() const noexcept {
+        return first_day_;
+    }
+
+    [[nodiscard]] i32 LastDay() const noexcept {
+        return first_day_ + static_cast<i32>(values_.size()) - 1;
+    }
+
+    [[nodiscard]] bool Empty() const noexcept {
+        return values_.empty();
+    }
+
+    [[nodiscard]] std::span<const f64> Values() const noexcept {
+        return values_;
+    }
+
+    // Fixing published on `date`, as a fraction
+    [[nodiscard]] std::optional<f64> Find(const DateType& date) const noexcept;
+
+private:
+    std::span<const f64> values_;
+    i32 first_day_ = 0;
+};
+
+// On-disk layout of a fixings store:
+//
+//   [FixingsFileHeader][FixingsSeriesEntry...][index names][f64 values]
+//
+// Entries are sorted by index name. Values of every series are one dense
+// column segment of `capacity` days, stored back to back: the first `days`
+// slots hold the series, the reserved tail is NaN. AppendFixing fills the
+// tail in place, so daily appends don't rewrite the file. Sections are
+// aligned for in-place reads.
+struct FixingsFileHeader {
+    static constexpr u32 kMagic = 0x58464443;  // "CDFX"
+    static constexpr u16 kVersion = 2;
+
+    u32 magic;
+    u16 version;
+    u16 reserved;
+
+    u32 series_size;
+    u32 entries_byte_offset;
+    u32 names_byte_offset;
+    u32 names_size;
+
+    u64 values_byte_offset;
+    u64 values_size;
+    u64 total_size_in_bytes;
+};
+
+struct FixingsSeriesEntry {
+    u32 name_offset;
+    u32 name_size;
+    i32 first_day;
+    u32 days;
+    // days of the segment, `days` included
+    u32 capacity;
+    u32 reserved;
+    // index of the first value inside of the values section
+    u64 values_offset;
+};
+
+// Read-only view of a fixings file, see CurveImage
+class CDR_MARKET_EXPORT FixingsImage final {
+public:
+    FixingsImage(const FixingsImage&) = delete;
+    FixingsImage& operator=(const FixingsImage&) = delete;
+
+    FixingsImage(FixingsImage&& other) noexcept = default;
+    FixingsImage& operator=(FixingsImage&& other) noexcept = default;
+
+    [[nodiscard]] static Expect<FixingsImage, Error> Open(const std::filesystem::path& path) noexcept;
+
+    [[nodiscard]] const FixingsFileHeader& Header() const noexcept {
+        return *header_ptr_;
+    }
+
+    [[nodiscard]] u64 Size() const noexcept {
+        return header_ptr_->series_size;
+    }
+
+    [[nodiscard]] const FixingsSeriesEntry& Entry(u64 idx) const noexcept {
+        return entries_ptr_[idx];
+    }
+
+    [[nodiscard]] std::string_view Name(u64 idx) const noexcept;
+    [[nodiscard]] FixingSeries Series(u64 idx) const noexcept;
+
+    // Binary search over index names, returns the position of `index`
+    [[nodiscard]] std::optional<u64> IndexOf(std::string_view index) const noexcept;
+    [[nodiscard]] std::optional<FixingSeries> Find(std::string_view index) const noexcept;
+
+private:
+    explicit FixingsImage(MappedFile file) noexcept;
+
+private:
+    MappedFile file_;
+
+    const FixingsFileHeader* header_ptr_ = nullptr;
+    const FixingsSeriesEntry* entries_ptr_ = nullptr;
+    const char* names_ptr_ = nullptr;
+    const f64* values_ptr_ = nullptr;
+};
+
+// In-memory, append-only fixings store. Every series only grows forward in
+// time; the store is persisted with WriteFixings and reopened with
+// FixingsImage (or loaded back with FromImage to keep appending). Single
+// fixings are better appended to the file with AppendFixing.
+class CDR_MARKET_EXPORT FixingsStore final {
+public:
+    [[nodiscard]] static FixingsStore FromImage(const FixingsImage& image);
+
+    // Fails with Error::InvalidInput unless `date` is after the last fixing
+    // of `index`
+    [[nodiscard]] Expect<void, Error> Append(std::string_view index, const DateType& date, f64 value);
+
+    [[nodiscard]] u64 Size() const noexcept {
+        return series_.size();
+    }
+
+    // View stays valid until the next Append to the same index
+    [[nodiscard]] std::optional<FixingSeries> Find(std::string_view index) const noexcept;
+
+private:
+    friend Expect<void, Error> WriteFixings(const FixingsStore&, const std::filesystem::path&, u32) noexcept;
+
+    struct Column {
+        i32 first_day = 0;
+        std::vector<f64> values;
+    };
+
+private:
+    std::map<std::string, Column, std::less<>> series_;
+};
+
+// A year of daily fixings
+inline constexpr u32 kFixingsReserveDays = 366;
+
+// Writes `store` to `path` atomically, every series reserving room for
+// `reserve_days` more days
+[[nodiscard]] CDR_MARKET_EXPORT Expect<void, Error> WriteFixings(const FixingsStore& store,
+                                                                 const std::filesystem::path& path,
+                                                                 u32 reserve_days = kFixingsReserveDays) noexcept;
+
+// Appends one fixing to the file at `path`, created if missing. The value
+// goes into the reserved tail of its series in place: the slot is written
+// before the day count of the series, so the file is valid at every step.
+// A new index or a series without room left rewrites the file with
+// WriteFixings instead. Images opened before an in-place append may not
+// see it, reopen the file to read it. Not safe against concurrent writers.
+// Fails like FixingsStore::Append, with Error::IOFailure and
+// Error::CorruptedData for an unreadable file, or with Error::NoMemory.
+[[nodiscard]] CDR_MARKET_EXPORT Expect<void, Error> AppendFixing(const std::filesystem::path& path,
+                                                                 std::string_view index, const DateType& date,
+                                                                 f64 value) noexcept;
+
+}  // namespace cdr
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <cdr/market/fixings.h>
+#include <cdr/calendar/date.h>
+
+#include <filesystem>
+#include <fstream>
+
+using namespace std::chrono;
+
+namespace {
+
+std::filesystem::path TempFixingsPath(const std::string& name) {
+    return std::filesystem::temp_directory_path() / ("cdr_fixings_" + name + ".bin");
+}
+
+}  // anonymous namespace
+
+TEST(Fixings, AppendOnly) {
+    cdr::FixingsStore store;
+    ASSERT_TRUE(store.Append("SOFR", day(4)/January/year(2027), 0.0431).Succeed());
+    ASSERT_TRUE(store.Append("SOFR", day(6)/January/year(2027), 0.0433).Succeed());
+
+    ASSERT_TRUE(store.Append("SOFR", day(6)/January/year(2027), 0.0434).Failed());
+    ASSERT_TRUE(store.Append("SOFR", day(5)/January/year(2027), 0.0434).Failed());
+
+    const auto series = store.Find("SOFR");
+    ASSERT_TRUE(series.has_value());
+    ASSERT_EQ(series->Values().size(), 3);
+    ASSERT_EQ(series->Find(day(4)/January/year(2027)), 0.0431);
+    ASSERT_FALSE(series->Find(day(5)/January/year(2027)).has_value());
+    ASSERT_EQ(series->Find(day(6)/January/year(2027)), 0.0433);
+    ASSERT_FALSE(series->Find(day(7)/January/year(2027)).has_value());
+    ASSERT_FALSE(series->Find(day(3)/January/year(2027)).has_value());
+    ASSERT_FALSE(store.Find("ESTR").has_value());
+}
+
+TEST(Fixings, RoundTrip) {
+    cdr::FixingsStore store;
+    const DateType first = day(2)/January/year(2025);
+    for (i32 i = 0; i < 730; ++i) {
+        const DateType date = SysDays{first} + days(i);
+        if (SysDays{date} == SysDays{first} + days(100)) {
+            continue;
+        }
+        ASSERT_TRUE(store.Append("SOFR", date, 0.04 + 1e-5 * i).Succeed());
+        if (i % 7 == 0) {
+            ASSERT_TRUE(store.Append("ESTR", date, 0.03 - 1e-5 * i).Succeed());
+        }
+    }
+
+    const auto path = TempFixingsPath("round_trip");
+    ASSERT_TRUE(cdr::WriteFixings(store, path).Succeed());
+
+    auto image = cdr::FixingsImage::Open(path);
+    ASSERT_TRUE(image.Succeed());
+    ASSERT_EQ(image.Value().Size(), 2);
+    ASSERT_EQ(image.Value().Name(0), "ESTR");
+    ASSERT_FALSE(image.Value().Find("EONIA").has_value());
+
+    for (std::string_view index : {"SOFR", "ESTR"}) {
+        const auto mapped = image.Value().Find(index);
+        const auto original = store.Find(index);
+        ASSERT_TRUE(mapped.has_value() && original.has_value());
+        ASSERT_EQ(mapped->FirstDay(), original->FirstDay());
+        ASSERT_EQ(mapped->LastDay(), original->LastDay());
+        for (i32 i = -3; i < 740; ++i) {
+            const DateType date = SysDays{first} + days(i);
+            ASSERT_EQ(mapped->Find(date), original->Find(date)) << index << " " << i;
+        }
+    }
+
+    // Reloaded stores keep appending after the last fixing
+    auto reloaded = cdr::FixingsStore::FromImage(image.Value());
+    ASSERT_TRUE(reloaded.Append("SOFR", SysDays{first} + days(729), 0.05).Failed());
+    ASSERT_TRUE(reloaded.Append("SOFR", SysDays{first} + days(730), 0.05).Succeed());
+    ASSERT_TRUE(cdr::WriteFixings(reloaded, path).Succeed());
+
+    auto extended = cdr::FixingsImage::Open(path);
+    ASSERT_TRUE(extended.Succeed());
+    ASSERT_EQ(extended.Value().Find("SOFR")->Find(SysDays{first} + days(730)), 0.05);
+
+    std::filesystem::remove(path);
+}
+
+TEST(Fixings, AppendInPlace) {
+    const auto path = TempFixingsPath("append");
+    std::filesystem::remove(path);
+    const DateType first = day(4)/January/year(2027);
+
+    // Created on the first append
+    ASSERT_TRUE(cdr::AppendFixing(path, "SOFR", first, 0.0431).Succeed());
+    ASSERT_EQ(cdr::FixingsImage::Open(path).Value().Find("SOFR")->Find(first), 0.0431);
+
+    cdr::FixingsStore store;
+    ASSERT_TRUE(store.Append("SOFR", first, 0.0431).Succeed());
+    ASSERT_TRUE(store.Append("SOFR", SysDays{first} + days(1), 0.0432).Succeed());
+    ASSERT_TRUE(cdr::WriteFixings(store, path, 3).Succeed());
+    const u64 size = std::filesystem::file_size(path);
+
+    // Within the reserved days the file keeps its size
+    ASSERT_TRUE(cdr::AppendFixing(path, "SOFR", SysDays{first} + days(2), 0.0433).Succeed());
+    ASSERT_TRUE(cdr::AppendFixing(path, "SOFR", SysDays{first} + days(4), 0.0435).Succeed());
+    ASSERT_EQ(std::filesystem::file_size(path), size);
+    ASSERT_EQ(cdr::AppendFixing(path, "SOFR", SysDays{first} + days(4), 0.0436), cdr::ErrorInvalidInput());
+    ASSERT_EQ(cdr::AppendFixing(path, "SOFR", SysDays{first} + days(3), 0.0434), cdr::ErrorInvalidInput());
+    {
+        auto image = cdr::FixingsImage::Open(path);
+        ASSERT_TRUE(image.Succeed());
+        const auto series = image.Value().Find("SOFR");
+        ASSERT_EQ(series->Values().size(), 5);
+        ASSERT_EQ(series->Find(SysDays{first} + days(2)), 0.0433);
+        ASSERT_FALSE(series->Find(SysDays{first} + days(3)).has_value());
+        ASSERT_EQ(series->Find(SysDays{first} + days(4)), 0.0435);
+        ASSERT_FALSE(series->Find(SysDays{first} + days(5)).has_value());
+        ASSERT_EQ(image.Value().Entry(0).capacity, 5);
+    }
+
+    // A full series and a new index rewrite the file with fresh room
+    ASSERT_TRUE(cdr::AppendFixing(path, "SOFR", SysDays{first} + days(5), 0.0436).Succeed());
+    ASSERT_TRUE(cdr::AppendFixing(path, "ESTR", first, 0.0291).Succeed());
+    ASSERT_GT(std::filesystem::file_size(path), size);
+    {
+        auto image = cdr::FixingsImage::Open(path);
+        ASSERT_TRUE(image.Succeed());
+        ASSERT_EQ(image.Value().Find("SOFR")->Find(SysDays{first} + days(5)), 0.0436);
+        ASSERT_EQ(image.Value().Find("SOFR")->Find(SysDays{first} + days(4)), 0.0435);
+        ASSERT_EQ(image.Value().Find("ESTR")->Find(first), 0.0291);
+        ASSERT_EQ(image.Value().Entry(0).capacity, 1 + cdr::kFixingsReserveDays);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(Fixings, RejectsCorruptedFile) {
+    const auto path = TempFixingsPath("corrupted");
+    {
+        std::ofstream output(path, std::ios::binary | std::ios::trunc);
+        output << "definitely not a fixings file";
+    }
+
+    ASSERT_EQ(cdr::FixingsImage::Open(path), cdr::ErrorCorruptedData());
+    ASSERT_EQ(cdr::FixingsImage::Open(TempFixingsPath("missing")), cdr::ErrorIOFailure());
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,136 @@
+#include <cdr/market/fx_crosses.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <cdr/base/check.h>
+
+namespace cdr {
+
+namespace {
+
+constexpr f64 kNoQuote = std::numeric_limits<f64>::quiet_NaN();
+
+}  // namespace
+
+FxCrossMatrix::FxCrossMatrix(std::vector<CurrencyTag> vehicles) {
+    SetVehicles(std::move(vehicles));
+}
+
+void FxCrossMatrix::SetVehicles(std::vector<CurrencyTag> vehicles) {
+    vehicle_codes_.clear();
+    for (const auto& vehicle : vehicles) {
+        vehicle_codes_.push_back(FXPairKey::PackCode(vehicle));
+    }
+    ResolveVehicles();
+    RecomputeAll();
+}
+
+void FxCrossMatrix::Set(FXPairKey pair, f64 spot) {
+    CDR_CHECK(pair.Base() != pair.Quote()) << "currency can't be quoted against itself";
+
+    const u64 size = Size();
+    const u32 base = AddCurrency(pair.Base());
+    const u32 quote = AddCurrency(pair.Quote());
+
+    quoted_[base * Size() + quote] = spot;
+    quoted_[quote * Size() + base] = 1. / spot;
+
+    if (Size() != size && vehicles_.size() != vehicle_codes_.size()) {
+        // A new currency may be a vehicle and reroute any cross
+        const u64 vehicles = vehicles_.size();
+        ResolveVehicles();
+        if (vehicles_.size() != vehicles) {
+            RecomputeAll();
+            return;
+        }
+    }
+
+    RecomputeCurrency(base);
+    RecomputeCurrency(quote);
+}
+
+[[nodiscard]] u32 FxCrossMatrix::Index(u32 code) const noexcept {
+    const auto it = indices_.find(code);
+    return it != indices_.end() ? it->second : kNoCurrency;
+}
+
+[[nodiscard]] std::optional<f64> FxCrossMatrix::Find(FXPairKey pair) const noexcept {
+    const u32 base = Index(pair.Base());
+    const u32 quote = Index(pair.Quote());
+    if (base == kNoCurrency || quote == kNoCurrency) {
+        return std::nullopt;
+    }
+    const f64 cross = At(base, quote);
+    if (std::isnan(cross)) {
+        return std::nullopt;
+    }
+    return cross;
+}
+
+[[nodiscard]] u32 FxCrossMatrix::AddCurrency(u32 code) {
+    if (const u32 idx = Index(code); idx != kNoCurrency) {
+        return idx;
+    }
+
+    const u32 old_size = Size();
+    const u32 size = old_size + 1;
+
+    // Grow both matrices keeping the known cells, the new row and column
+    // are recomputed by the caller
+    auto grow = [&](std::vector<f64>& matrix) {
+        std::vector<f64> grown(static_cast<u64>(size) * size, kNoQuote);
+        for (u32 row = 0; row < old_size; ++row) {
+            std::copy_n(matrix.begin() + row * old_size, old_size, grown.begin() + row * size);
+        }
+        matrix = std::move(grown);
+    };
+    grow(quoted_);
+    grow(crosses_);
+
+    codes_.push_back(code);
+    indices_.emplace(code, old_size);
+    return old_size;
+}
+
+void FxCrossMatrix::ResolveVehicles() {
+    vehicles_.clear();
+    for (u32 code : vehicle_codes_) {
+        if (const u32 idx = Index(code); idx != kNoCurrency) {
+            vehicles_.push_back(idx);
+        }
+    }
+}
+
+[[nodiscard]] f64 FxCrossMatrix::Cross(u32 base, u32 quote) const noexcept {
+    if (base == quote) {
+        return 1.;
+    }
+    if (const f64 spot = Quoted(base, quote); !std::isnan(spot)) {
+        return spot;
+    }
+    for (u32 vehicle : vehicles_) {
+        const f64 cross = Quoted(base, vehicle) * Quoted(vehicle, quote);
+        if (!std::isnan(cross)) {
+            return cross;
+        }
+    }
+    return kNoQuote;
+}
+
+void FxCrossMatrix::RecomputeCurrency(u32 idx) noexcept {
+    for (u32 other = 0; other < Size(); ++other) {
+        crosses_[idx * Size() + other] = Cross(idx, other);
+        crosses_[other * Size() + idx] = Cross(other, idx);
+    }
+}
+
+void FxCrossMatrix::RecomputeAll() noexcept {
+    for (u32 base = 0; base < Size(); ++base) {
+        for (u32 quote = 0; quote < Size(); ++quote) {
+            crosses_[base * Size() + quote] = Cross(base, quote);
+        }
+    }
+}
+
+}  // namespace cdr
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cdr/fx/fx.h>
+#include <cdr/types/integers.h>
+#include <cdr/types/floats.h>
+#include <cdr/market/internal/export.h>
+
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace cdr {
+
+// Dense matrix of every cross between the currencies with a quoted spot.
+//
+// Quoted spots are the edges of a currency graph. The cross of `base` and
+// `quote` is the quoted spot of the pair if there is one, otherwise the
+// product of spots through the first vehicle currency (in priority order)
+// quoted against both of them. Crosses without such a path are NaN.
+//
+// Currencies get dense indices in the order they are first quoted, so a
+// cross is a single read of At(). A ticking spot only invalidates the rows
+// and columns of its two currencies, which are recomputed in O(N * vehicles).
+class CDR_MARKET_EXPORT FxCrossMatrix final {
+public:
+    static constexpr u32 kNoCurrency = std::numeric_limits<u32>::max();
+
+    explicit FxCrossMatrix(std::vector<CurrencyTag> vehicles = {"USD"});
+
+    // Replaces vehicle currencies, highest priority first, and recomputes
+    // the whole matrix
+    void SetVehicles(std::vector<CurrencyTag> vehicles);
+
+    void Set(FXPairKey pair, f64 spot);
+
+    [[nodiscard]] u32 Size() const noexcept {
+        return static_cast<u32>(codes_.size());
+    }
+
+    // Dense index of a packed currency code, kNoCurrency if never quoted
+    [[nodiscard]] u32 Index(u32 code) const noexcept;
+
+    [[nodiscard]] u32 Index(std::string_view code) const {
+        return Index(FXPairKey::PackCode(code));
+    }
+
+    [[nodiscard]] f64 At(u32 base, u32 quote) const noexcept {
+        return crosses_[base * Size() + quote];
+    }
+
+    [[nodiscard]] std::optional<f64> Find(FXPairKey pair) const noexcept;
+
+private:
+    [[nodiscard]] f64 Quoted(u32 base, u32 quote) const noexcept {
+        return quoted_[base * Size() + quote];
+    }
+
+    [[nodiscard]] u32 AddCurrency(u32 code);
+    void ResolveVehicles();
+
+    [[nodiscard]] f64 Cross(u32 base, u32 quote) const noexcept;
+    void RecomputeCurrency(u32 idx) noexcept;
+    void RecomputeAll() noexcept;
+
+private:
+    std::vector<u32> vehicle_codes_;
+    // indices of the vehicles quoted so far, in priority order
+    std::vector<u32> vehicles_;
+
+    std::vector<u32> codes_;
+    std::unordered_map<u32, u32> indices_;
+
+    // row-major N x N, NaN where unknown
+    std::vector<f64> quoted_;
+    std::vector<f64> crosses_;
+};
+
+}  // namespace cdr
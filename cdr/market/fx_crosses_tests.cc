@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <cdr/market/fx_crosses.h>
+#include <cdr/market/context.h>
+#include <cdr/calendar/date.h>
+#include <cdr/calendar/holiday_storage.h>
+
+#include <atomic>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+
+cdr::FXPairKey Pair(std::string_view base, std::string_view quote) {
+    return cdr::FXPairKey::Pack(base, quote);
+}
+
+}  // anonymous namespace
+
+TEST(FxCrossMatrix, CrossesThroughVehicle) {
+    cdr::FxCrossMatrix crosses;
+    crosses.Set(Pair("EUR", "USD"), 1.10);
+    crosses.Set(Pair("USD", "JPY"), 150.);
+    crosses.Set(Pair("GBP", "USD"), 1.25);
+    ASSERT_EQ(crosses.Size(), 4);
+
+    ASSERT_DOUBLE_EQ(*crosses.Find(Pair("EUR", "JPY")), 1.10 * 150.);
+    ASSERT_DOUBLE_EQ(*crosses.Find(Pair("JPY", "EUR")), 1. / 150. * (1. / 1.10));
+    ASSERT_DOUBLE_EQ(*crosses.Find(Pair("EUR", "GBP")), 1.10 / 1.25);
+    ASSERT_EQ(crosses.Find(Pair("USD", "JPY")), 150.);
+    ASSERT_EQ(crosses.Find(Pair("JPY", "JPY")), 1.);
+
+    const u32 eur = crosses.Index("EUR");
+    const u32 jpy = crosses.Index("JPY");
+    ASSERT_EQ(crosses.At(eur, jpy), *crosses.Find(Pair("EUR", "JPY")));
+    ASSERT_EQ(crosses.Index("CHF"), cdr::FxCrossMatrix::kNoCurrency);
+
+    // A tick only moves the crosses through the quoted pair
+    crosses.Set(Pair("USD", "JPY"), 140.);
+    ASSERT_DOUBLE_EQ(*crosses.Find(Pair("EUR", "JPY")), 1.10 * 140.);
+    ASSERT_DOUBLE_EQ(*crosses.Find(Pair("GBP", "JPY")), 1.25 * 140.);
+    ASSERT_DOUBLE_EQ(*crosses.Find(Pair("EUR", "GBP")), 1.10 / 1.25);
+
+    // A quoted cross takes precedence over the vehicle
+    crosses.Set(Pair("EUR", "JPY"), 155.);
+    ASSERT_EQ(crosses.Find(Pair("EUR", "JPY")), 155.);
+}
+
+TEST(FxCrossMatrix, VehiclePriority) {
+    cdr::FxCrossMatrix crosses({"USD", "EUR"});
+    crosses.Set(Pair("SEK", "EUR"), 0.087);
+    crosses.Set(Pair("NOK", "EUR"), 0.085);
+    ASSERT_DOUBLE_EQ(*crosses.Find(Pair("SEK", "NOK")), 0.087 / 0.085);
+    ASSERT_FALSE(crosses.Find(Pair("SEK", "JPY")).has_value());
+
+    // USD becomes known and routes crosses quoted against it
+    crosses.Set(Pair("SEK", "USD"), 0.095);
+    crosses.Set(Pair("NOK", "USD"), 0.093);
+    ASSERT_DOUBLE_EQ(*crosses.Find(Pair("SEK", "NOK")), 0.095 / 0.093);
+
+    crosses.SetVehicles({"EUR"});
+    ASSERT_DOUBLE_EQ(*crosses.Find(Pair("SEK", "NOK")), 0.087 / 0.085);
+}
+
+TEST(MarketContext, CrossedSpots) {
+    cdr::MarketContext context(cdr::HolidayStorage(), day(4)/January/year(2027));
+    context.SetFxSpot({"EUR", "USD"}, 1.10);
+    context.SetFxSpot({"USD", "RUB"}, 80.);
+
+    ASSERT_EQ(context.FxSpot({"USD", "EUR"}), 1. / 1.10);
+    ASSERT_DOUBLE_EQ(context.FxSpot({"EUR", "RUB"}), 1.10 * 80.);
+    ASSERT_DOUBLE_EQ(cdr::MarketContextView(context).FxSpot({"RUB", "EUR"}), 1. / 80. / 1.10);
+}
+
+TEST(MarketContext, CrossesUnderConcurrentTicks) {
+    cdr::MarketContext context(cdr::HolidayStorage(), day(4)/January/year(2027));
+    context.SetFxSpot({"EUR", "USD"}, 1.25);
+    context.SetFxSpot({"USD", "RUB"}, 80.);
+    const auto eur_rub = Pair("EUR", "RUB");
+
+    std::atomic<bool> stop = false;
+    std::vector<std::thread> readers;
+    std::atomic<u64> wrong = 0;
+    for (u32 r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                const auto spot = context.FindFxSpot(eur_rub);
+                if (!spot.has_value() || (*spot != 1.25 * 80. && *spot != 1.5 * 80.)) {
+                    wrong.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                // A pinned matrix stays valid and unchanged under later ticks
+                const auto crosses = context.FxCrosses();
+                const auto first = crosses->Find(eur_rub);
+                std::this_thread::yield();
+                if (first != crosses->Find(eur_rub)) {
+                    wrong.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    // New currencies grow the matrix while EUR/USD ticks
+    for (u32 i = 0; i < 1000; ++i) {
+        context.SetFxSpot(Pair("EUR", "USD"), i % 2 == 0 ? 1.5 : 1.25);
+        if (i < 200) {
+            context.SetFxSpot(Pair("USD", "C" + std::to_string(i)), 1. + i);
+        }
+    }
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    ASSERT_EQ(wrong.load(), 0);
+    ASSERT_EQ(context.FxCrosses()->Size(), 203);
+}
@@ -0,0 +1,101 @@
+#include <cdr/market/fx_spots.h>
+
+#include <bit>
+#include <cdr/base/check.h>
+
+namespace cdr {
+
+FxSpotTable::FxSpotTable(u64 capacity)
+    : slots_(std::make_unique<Slot[]>(capacity))
+    , mask_(capacity - 1)
+    , shift_(64 - static_cast<u32>(std::countr_zero(capacity)))
+{
+    CDR_CHECK(capacity >= 2 && std::has_single_bit(capacity)) << "capacity must be a power of two";
+}
+
+[[nodiscard]] std::optional<f64> FxSpotTable::Find(FXPairKey key) const noexcept {
+    const FXPairKey canonical = Canonical(key);
+    for (u64 idx = Home(canonical); ; idx = (idx + 1) & mask_) {
+        const Slot& slot = slots_[idx];
+        const u64 pair = slot.pair.load(std::memory_order_acquire);
+        if (pair == 0) {
+            return std::nullopt;
+        }
+        if (pair != canonical.Value()) {
+            continue;
+        }
+
+        for (;;) {
+            const u64 sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence & 1) [[unlikely]] {
+                continue;
+            }
+            const u64 quoted = slot.quoted.load(std::memory_order_relaxed);
+            const f64 spot = slot.spot.load(std::memory_order_relaxed);
+            const f64 inverse = slot.inverse.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence) [[unlikely]] {
+                continue;
+            }
+
+            if (quoted == 0) {
+                // interned, but the first spot is not published yet
+                return std::nullopt;
+            }
+            return quoted == key.Value() ? spot : inverse;
+        }
+    }
+}
+
+void FxSpotTable::Set(FXPairKey key, f64 spot) {
+    CDR_CHECK(!key.Empty()) << "empty currency pair";
+
+    Slot& slot = Intern(Canonical(key));
+
+    // Writers of the same pair take turns, readers are never waited for
+    u64 sequence = slot.sequence.load(std::memory_order_relaxed);
+    while ((sequence & 1) || !slot.sequence.compare_exchange_weak(sequence, sequence + 1,
+                                                                 std::memory_order_acquire,
+                                                                 std::memory_order_relaxed)) {
+        sequence = slot.sequence.load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.quoted.store(key.Value(), std::memory_order_relaxed);
+    slot.spot.store(spot, std::memory_order_relaxed);
+    slot.inverse.store(1. / spot, std::memory_order_relaxed);
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void FxSpotTable::Clear() noexcept {
+    for (u64 idx = 0; idx <= mask_; ++idx) {
+        Slot& slot = slots_[idx];
+        slot.pair.store(0, std::memory_order_relaxed);
+        slot.sequence.store(0, std::memory_order_relaxed);
+        slot.quoted.store(0, std::memory_order_relaxed);
+        slot.spot.store(0., std::memory_order_relaxed);
+        slot.inverse.store(0., std::memory_order_relaxed);
+    }
+    size_.store(0, std::memory_order_relaxed);
+}
+
+[[nodiscard]] FxSpotTable::Slot& FxSpotTable::Intern(FXPairKey canonical) {
+    for (u64 idx = Home(canonical); ; idx = (idx + 1) & mask_) {
+        Slot& slot = slots_[idx];
+        u64 pair = slot.pair.load(std::memory_order_acquire);
+        if (pair == 0) {
+            CDR_CHECK(4 * (Size() + 1) <= 3 * Capacity()) << "FX spot table is full";
+            if (slot.pair.compare_exchange_strong(pair, canonical.Value(), std::memory_order_acq_rel)) {
+                size_.fetch_add(1, std::memory_order_relaxed);
+                return slot;
+            }
+            // Lost the race for the slot, `pair` holds the winner
+        }
+        if (pair == canonical.Value()) {
+            return slot;
+        }
+    }
+}
+
+}  // namespace cdr
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cdr/fx/fx.h>
+#include <cdr/base/hardware_interference_size.h>
+#include <cdr/types/integers.h>
+#include <cdr/types/floats.h>
+#include <cdr/market/internal/export.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <optional>
+
+namespace cdr {
+
+// FX spots in a flat open-addressing table keyed by packed pairs, safe for
+// concurrent readers and writers.
+//
+// A pair and its reverse share one slot, which keeps the quoted direction
+// together with the spot and its inverse, so both directions are answered by
+// the same probe sequence without a second lookup or a division. Linear
+// probing over a fixed power-of-two capacity: a pair is interned into its
+// slot once and the slot never moves, so lookups don't synchronize with
+// inserts of other pairs.
+//
+// Every slot is guarded by a sequence lock. Writers never wait for readers,
+// readers never block and only retry while a write of the same pair is in
+// flight, and a reader always sees a spot and direction written together.
+class CDR_MARKET_EXPORT FxSpotTable final {
+public:
+    static constexpr u64 kDefaultCapacity = 1024;
+
+    // `capacity` is a power of two, at most 3/4 of it can be used
+    explicit FxSpotTable(u64 capacity = kDefaultCapacity);
+
+    FxSpotTable(const FxSpotTable&) = delete;
+    FxSpotTable& operator=(const FxSpotTable&) = delete;
+
+    // Spot of `key`, inverting the quote of the reversed pair if that is the
+    // one stored
+    [[nodiscard]] std::optional<f64> Find(FXPairKey key) const noexcept;
+
+    // Stores the spot of `key`, replacing the quote of the pair in either
+    // direction
+    void Set(FXPairKey key, f64 spot);
+
+    [[nodiscard]] u64 Size() const noexcept {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] u64 Capacity() const noexcept {
+        return mask_ + 1;
+    }
+
+    // Not thread-safe
+    void Clear() noexcept;
+
+private:
+    struct alignas(kHardwareDestructiveInterferenceSize) Slot {
+        // min(pair, reversed pair), set once when the pair is interned
+        std::atomic<u64> pair{0};
+        // odd while a write is in progress
+        std::atomic<u64> sequence{0};
+        std::atomic<u64> quoted{0};
+        std::atomic<f64> spot{0.};
+        std::atomic<f64> inverse{0.};
+    };
+
+    [[nodiscard]] static FXPairKey Canonical(FXPairKey key) noexcept {
+        return std::min(key, key.Reversed());
+    }
+
+    [[nodiscard]] u64 Home(FXPairKey canonical) const noexcept {
+        return (canonical.Value() * 0x9e3779b97f4a7c15ull) >> shift_;
+    }
+
+    [[nodiscard]] Slot& Intern(FXPairKey canonical);
+
+private:
+    std::unique_ptr<Slot[]> slots_;
+    u64 mask_ = 0;
+    u32 shift_ = 0;
+    std::atomic<u64> size_ = 0;
+};
+
+}  // namespace cdr
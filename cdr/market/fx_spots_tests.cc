@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <cdr/market/fx_spots.h>
+#include <cdr/fx/fx.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(FXPairKey, Packing) {
+    const auto eur_usd = cdr::FXPairKey::Pack("EUR", "USD");
+    const auto usd_eur = cdr::FXPairKey::Pack("USD", "EUR");
+
+    ASSERT_NE(eur_usd, usd_eur);
+    ASSERT_EQ(eur_usd.Reversed(), usd_eur);
+    ASSERT_EQ(eur_usd.Reversed().Reversed(), eur_usd);
+    ASSERT_EQ(cdr::FXPair("EUR", "USD").Key(), eur_usd);
+    ASSERT_FALSE(eur_usd.Empty());
+
+    // Shorter codes are zero padded and stay distinct
+    ASSERT_NE(cdr::FXPairKey::Pack("EU", "RUSD"), eur_usd);
+
+    // Reversed pairs used to hash to the same value
+    std::hash<cdr::FXPair> hash;
+    ASSERT_NE(hash({"EUR", "USD"}), hash({"USD", "EUR"}));
+}
+
+TEST(FxSpotTable, DirectAndInvertedQuotes) {
+    cdr::FxSpotTable table;
+    ASSERT_FALSE(table.Find(cdr::FXPairKey::Pack("USD", "RUB")).has_value());
+
+    table.Set(cdr::FXPairKey::Pack("USD", "RUB"), 80.);
+    ASSERT_EQ(table.Find(cdr::FXPairKey::Pack("USD", "RUB")), 80.);
+    ASSERT_EQ(table.Find(cdr::FXPairKey::Pack("RUB", "USD")), 1. / 80.);
+
+    // Quoting the reversed pair replaces the stored direction
+    table.Set(cdr::FXPairKey::Pack("RUB", "USD"), 0.0125);
+    ASSERT_EQ(table.Size(), 1);
+    ASSERT_EQ(table.Find(cdr::FXPairKey::Pack("RUB", "USD")), 0.0125);
+    ASSERT_EQ(table.Find(cdr::FXPairKey::Pack("USD", "RUB")), 1. / 0.0125);
+
+    table.Clear();
+    ASSERT_EQ(table.Size(), 0);
+    ASSERT_FALSE(table.Find(cdr::FXPairKey::Pack("USD", "RUB")).has_value());
+}
+
+TEST(FxSpotTable, ManyPairs) {
+    const std::vector<std::string> codes = {"USD", "EUR", "GBP", "JPY", "CHF", "CAD", "AUD", "NZD",
+                                            "SEK", "NOK", "DKK", "PLN", "CZK", "HUF", "CNY", "HKD"};
+
+    cdr::FxSpotTable table;
+    f64 spot = 1.;
+    for (u64 i = 0; i < codes.size(); ++i) {
+        for (u64 j = i + 1; j < codes.size(); ++j) {
+            table.Set(cdr::FXPairKey::Pack(codes[i], codes[j]), spot);
+            spot += 0.25;
+        }
+    }
+    ASSERT_EQ(table.Size(), codes.size() * (codes.size() - 1) / 2);
+    ASSERT_EQ(table.Capacity(), cdr::FxSpotTable::kDefaultCapacity);
+
+    spot = 1.;
+    for (u64 i = 0; i < codes.size(); ++i) {
+        for (u64 j = i + 1; j < codes.size(); ++j) {
+            ASSERT_EQ(table.Find(cdr::FXPairKey::Pack(codes[i], codes[j])), spot);
+            ASSERT_EQ(table.Find(cdr::FXPairKey::Pack(codes[j], codes[i])), 1. / spot);
+            spot += 0.25;
+        }
+    }
+    ASSERT_FALSE(table.Find(cdr::FXPairKey::Pack("USD", "TRY")).has_value());
+}
+
+TEST(FxSpotTable, ConcurrentReadersSeeWholeQuotes) {
+    cdr::FxSpotTable table(16);
+    const auto eur_usd = cdr::FXPairKey::Pack("EUR", "USD");
+    table.Set(eur_usd, 1.25);
+
+    std::atomic<bool> stop = false;
+    std::thread writer([&] {
+        for (u32 i = 0; !stop.load(std::memory_order_relaxed); ++i) {
+            // A torn read would mix the direction of one quote with the
+            // spot of the other and give 0.5 or 0.8
+            if (i % 2 == 0) {
+                table.Set(eur_usd.Reversed(), 0.5);
+            } else {
+                table.Set(eur_usd, 1.25);
+            }
+        }
+    });
+
+    std::vector<std::thread> readers;
+    std::atomic<u64> torn = 0;
+    for (u32 r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            for (u32 i = 0; i < 200'000; ++i) {
+                const auto spot = table.Find(eur_usd);
+                if (!spot.has_value() || (*spot != 1.25 && *spot != 2.)) {
+                    torn.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    stop = true;
+    writer.join();
+
+    ASSERT_EQ(torn.load(), 0);
+    ASSERT_EQ(table.Size(), 1);
+}
@@ -0,0 +1,89 @@
+#include <cdr/market/spot_dates.h>
+
+#include <array>
+#include <chrono>
+
+namespace cdr {
+
+SpotDateTable::SpotDateTable(const CurrencyTag& settlement_currency)
+    : settlement_code_(FXPairKey::PackCode(settlement_currency))
+    , settlement_currency_(settlement_currency)
+{
+    for (const char* currency : {"CAD", "TRY", "RUB", "PHP"}) {
+        lags_.emplace(Canonical(FXPairKey::Pack(settlement_currency, currency)), 1);
+    }
+}
+
+void SpotDateTable::SetLag(FXPairKey pair, u32 lag) {
+    const FXPairKey canonical = Canonical(pair);
+    lags_.insert_or_assign(canonical, lag);
+    dates_.erase(canonical);
+}
+
+u32 SpotDateTable::Lag(FXPairKey pair) const noexcept {
+    if (auto it = lags_.find(Canonical(pair)); it != lags_.end()) {
+        return it->second;
+    }
+    return kDefaultLag;
+}
+
+void SpotDateTable::Reset(const HolidayStorage& calendar, DateType today) {
+    today_ = today;
+    for (auto& [pair, date] : dates_) {
+        date = Compute(calendar, today, pair);
+    }
+    for (const auto& [pair, lag] : lags_) {
+        if (!dates_.contains(pair)) {
+            dates_.emplace(pair, Compute(calendar, today, pair));
+        }
+    }
+}
+
+DateType SpotDateTable::Resolve(const HolidayStorage& calendar, FXPairKey pair) {
+    const FXPairKey canonical = Canonical(pair);
+    if (auto it = dates_.find(canonical); it != dates_.end()) [[likely]] {
+        return it->second;
+    }
+    return dates_.emplace(canonical, Compute(calendar, today_, canonical)).first->second;
+}
+
+DateType SpotDateTable::Compute(const HolidayStorage& calendar, DateType today, FXPairKey pair) const {
+    const std::array<u32, 2> codes = {pair.Base(), pair.Quote()};
+    const std::array<JurisdictionType, 2> currencies = {FXPairKey::UnpackCode(codes[0]),
+                                                         FXPairKey::UnpackCode(codes[1])};
+    const bool has_settlement_calendar = calendar.Contains(settlement_currency_);
+
+    // `settles`: the spot date, which needs the settlement currency too
+    const auto good_day = [&](DateType date, bool settles) {
+        const auto weekday = Weekday(date);
+        if (weekday == std::chrono::Saturday || weekday == std::chrono::Sunday) {
+            return false;
+        }
+        for (u64 i = 0; i < codes.size(); ++i) {
+            if (codes[i] == settlement_code_ && !settles) {
+                continue;
+            }
+            if (calendar.Contains(currencies[i]) && !calendar.IsBusinessDay(currencies[i], date)) {
+                return false;
+            }
+        }
+        return !settles || !has_settlement_calendar || calendar.IsBusinessDay(settlement_currency_, date);
+    };
+
+    const u32 lag = Lag(pair);
+    DateType date = today;
+    for (u32 day = 1; day < lag; ++day) {
+        do {
+            date = NextDay(date);
+        } while (!good_day(date, false));
+    }
+    if (lag > 0) {
+        date = NextDay(date);
+    }
+    while (!good_day(date, true)) {
+        date = NextDay(date);
+    }
+    return date;
+}
+
+}  // namespace cdr
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cdr/fx/fx.h>
+#include <cdr/calendar/date.h>
+#include <cdr/calendar/holiday_storage.h>
+#include <cdr/types/integers.h>
+#include <cdr/market/internal/export.h>
+
+#include <algorithm>
+#include <optional>
+#include <unordered_map>
+
+namespace cdr {
+
+// Spot dates of currency pairs, resolved once per today.
+//
+// A pair settles T+N business days after today, N = Lag() of the pair.
+// Days up to T+N-1 only need to be business days of the pair's currencies
+// other than the settlement currency (USD), so a USD holiday doesn't delay
+// EUR/USD on T+1. The spot date itself must be a business day of both
+// currencies and of the settlement currency, and rolls forward until it is.
+// T+1 pairs thus need both calendars open on T+1.
+//
+// Currencies missing from the calendar have weekends only.
+class CDR_MARKET_EXPORT SpotDateTable final {
+public:
+    static constexpr u32 kDefaultLag = 2;
+
+    // Known T+1 pairs are preset: USD/CAD, USD/TRY, USD/RUB, USD/PHP
+    explicit SpotDateTable(const CurrencyTag& settlement_currency = "USD");
+
+    // Lag of `pair` in business days, for both directions of the pair.
+    // The spot date of the pair is resolved again on the next Resolve.
+    void SetLag(FXPairKey pair, u32 lag);
+
+    [[nodiscard]] u32 Lag(FXPairKey pair) const noexcept;
+
+    // Drops resolved dates and resolves every pair with a lag rule or
+    // resolved before for `today`
+    void Reset(const HolidayStorage& calendar, DateType today);
+
+    // Spot date resolved for the current today, nullopt if `pair` is not
+    // resolved yet
+    [[nodiscard]] std::optional<DateType> Find(FXPairKey pair) const noexcept {
+        if (auto it = dates_.find(Canonical(pair)); it != dates_.end()) [[likely]] {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+    // Find, resolving and remembering the spot date on a miss
+    DateType Resolve(const HolidayStorage& calendar, FXPairKey pair);
+
+    // The calendar walk behind Resolve, without the table
+    [[nodiscard]] DateType Compute(const HolidayStorage& calendar, DateType today, FXPairKey pair) const;
+
+    [[nodiscard]] DateType Today() const noexcept {
+        return today_;
+    }
+
+private:
+    [[nodiscard]] static FXPairKey Canonical(FXPairKey pair) noexcept {
+        return std::min(pair, pair.Reversed());
+    }
+
+private:
+    u32 settlement_code_;
+    JurisdictionType settlement_currency_;
+    DateType today_;
+
+    // by canonical pair
+    std::unordered_map<FXPairKey, u32> lags_;
+    std::unordered_map<FXPairKey, DateType> dates_;
+};
+
+}  // namespace cdr
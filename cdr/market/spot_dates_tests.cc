@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <cdr/market/spot_dates.h>
+#include <cdr/market/context.h>
+#include <cdr/calendar/date.h>
+#include <cdr/calendar/holiday_storage.h>
+
+using namespace std::chrono;
+
+namespace {
+
+cdr::FXPairKey Pair(std::string_view base, std::string_view quote) {
+    return cdr::FXPairKey::Pack(base, quote);
+}
+
+cdr::HolidayStorage MakeCalendar() {
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        // Tuesday and Thursday
+        ("USD", year(2027) / January / day(12))
+        ("USD", year(2027) / January / day(21))
+        // Wednesday
+        ("EUR", year(2027) / January / day(27))
+        ("GBP", year(2027) / January / day(1))
+        // Monday
+        ("CAD", year(2027) / February / day(15))
+    ;
+    return holiday_storage;
+}
+
+}  // anonymous namespace
+
+TEST(SpotDateTable, JointCalendarRules) {
+    const auto calendar = MakeCalendar();
+    cdr::SpotDateTable table;
+    const auto spot = [&](DateType today, cdr::FXPairKey pair) {
+        return table.Compute(calendar, today, pair);
+    };
+
+    // Monday T+2, Thursday T+2 over the weekend
+    ASSERT_EQ(spot(day(4)/January/year(2027), Pair("EUR", "USD")), day(6)/January/year(2027));
+    ASSERT_EQ(spot(day(7)/January/year(2027), Pair("USD", "EUR")), day(11)/January/year(2027));
+
+    // A USD holiday on T+1 doesn't count, on the spot date it rolls it
+    ASSERT_EQ(spot(day(11)/January/year(2027), Pair("EUR", "USD")), day(13)/January/year(2027));
+    ASSERT_EQ(spot(day(19)/January/year(2027), Pair("EUR", "USD")), day(22)/January/year(2027));
+
+    // A holiday of the other currency on T+1 delays the spot date
+    ASSERT_EQ(spot(day(26)/January/year(2027), Pair("EUR", "USD")), day(29)/January/year(2027));
+    ASSERT_EQ(spot(day(26)/January/year(2027), Pair("EUR", "GBP")), day(29)/January/year(2027));
+
+    // Crosses settle on USD business days too, but ignore USD before the spot date
+    ASSERT_EQ(spot(day(19)/January/year(2027), Pair("EUR", "GBP")), day(22)/January/year(2027));
+    ASSERT_EQ(spot(day(11)/January/year(2027), Pair("EUR", "GBP")), day(13)/January/year(2027));
+    ASSERT_EQ(spot(day(31)/December/year(2026), Pair("EUR", "GBP")), day(5)/January/year(2027));
+
+    // T+1 pairs need both calendars on T+1, unknown calendars are weekends only
+    ASSERT_EQ(table.Lag(Pair("CAD", "USD")), 1);
+    ASSERT_EQ(spot(day(12)/February/year(2027), Pair("USD", "CAD")), day(16)/February/year(2027));
+    ASSERT_EQ(spot(day(11)/January/year(2027), Pair("USD", "CAD")), day(13)/January/year(2027));
+    ASSERT_EQ(spot(day(8)/January/year(2027), Pair("USD", "RUB")), day(11)/January/year(2027));
+
+    table.SetLag(Pair("USD", "EUR"), 0);
+    ASSERT_EQ(table.Lag(Pair("EUR", "USD")), 0);
+    ASSERT_EQ(spot(day(9)/January/year(2027), Pair("EUR", "USD")), day(11)/January/year(2027));
+    ASSERT_EQ(spot(day(11)/January/year(2027), Pair("EUR", "USD")), day(11)/January/year(2027));
+}
+
+TEST(SpotDateTable, ResolvedOncePerToday) {
+    const auto calendar = MakeCalendar();
+    cdr::SpotDateTable table;
+    table.Reset(calendar, day(4)/January/year(2027));
+
+    // Lag rules are resolved upfront, other pairs on first use
+    ASSERT_EQ(table.Find(Pair("CAD", "USD")), day(5)/January/year(2027));
+    ASSERT_FALSE(table.Find(Pair("EUR", "USD")).has_value());
+    ASSERT_EQ(table.Resolve(calendar, Pair("EUR", "USD")), day(6)/January/year(2027));
+    ASSERT_EQ(table.Find(Pair("USD", "EUR")), day(6)/January/year(2027));
+
+    // ...and kept resolved for the next today
+    table.Reset(calendar, day(11)/January/year(2027));
+    ASSERT_EQ(table.Find(Pair("EUR", "USD")), day(13)/January/year(2027));
+
+    table.SetLag(Pair("EUR", "USD"), 1);
+    ASSERT_FALSE(table.Find(Pair("EUR", "USD")).has_value());
+    ASSERT_EQ(table.Resolve(calendar, Pair("EUR", "USD")), day(13)/January/year(2027));
+}
+
+TEST(MarketContext, SpotDates) {
+    cdr::MarketContext context(MakeCalendar(), day(4)/January/year(2027));
+    ASSERT_EQ(context.SpotDate({"EUR", "USD"}), day(6)/January/year(2027));
+    ASSERT_EQ(context.SpotDate({"USD", "CAD"}), day(5)/January/year(2027));
+
+    context.SetToday(day(19)/January/year(2027));
+    ASSERT_EQ(context.SpotDate({"EUR", "USD"}), day(22)/January/year(2027));
+
+    context.SetFxSpotLag({"EUR", "USD"}, 1);
+    ASSERT_EQ(context.SpotDate({"USD", "EUR"}), day(20)/January/year(2027));
+}
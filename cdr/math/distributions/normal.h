@@ -63,7 +63,7 @@ constexpr f64 NormalCDFHartAlgorithm(f64 x) noexcept {
     return x > 0. ? 1. - cnd : cnd;
 }
 
-f64 NormalCDFStdLib(f64 x) noexcept {
+inline f64 NormalCDFStdLib(f64 x) noexcept {
     constexpr f64 inv_sqrt1_2 = 1.0 / 1.4142135623730951;
     return 0.5 * std::erfc(-x * inv_sqrt1_2);
 }
@@ -102,7 +102,7 @@ constexpr f64 NormalCDFInverseMoroAlgorithm(f64 u) noexcept {
     return NormalCDFInverseMoroAlgorithm(u);
 }
 
-[[nodiscard("pure")]] f64 NormalPDF(f64 x) noexcept {
+[[nodiscard("pure")]] inline f64 NormalPDF(f64 x) noexcept {
     constexpr f64 inv_sqrt_2pi = 0.3989422804014327;
     return std::exp(-0.5 * x * x) * inv_sqrt_2pi;
 }
@@ -0,0 +1,241 @@
+#include <cdr/model/backtest.h>
+
+#include <algorithm>
+#include <iomanip>
+
+namespace cdr {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+[[nodiscard]] DateType AddDays(DateType date, u64 days) noexcept {
+    return DateType{SysDays{date} + std::chrono::days{static_cast<i64>(days)}};
+}
+
+[[nodiscard]] u64 RangeSize(const BacktestSettings& settings) noexcept {
+    if (settings.last < settings.first) {
+        return 0;
+    }
+    return static_cast<u64>((SysDays{settings.last} - SysDays{settings.first}).count()) + 1;
+}
+
+// yyyy-mm-dd
+void WriteDate(std::ostream& out, DateType date) {
+    out << std::setfill('0') << std::setw(4) << static_cast<i32>(date.year()) << '-'
+        << std::setw(2) << static_cast<u32>(date.month()) << '-'
+        << std::setw(2) << static_cast<u32>(date.day()) << std::setfill(' ');
+}
+
+}  // anonymous namespace
+
+Expect<MarketHistory, Error> MarketHistory::FromTicks(std::span<const MarketTick> ticks) {
+    MarketHistory history;
+    MarketDay day;
+    bool opened = false;
+
+    for (const auto& tick : ticks) {
+        switch (tick.kind) {
+            case TickKind::kToday: {
+                if (opened && tick.date < day.date) [[unlikely]] {
+                    return ErrorInvalidInput();
+                }
+                if (opened && tick.date != day.date) {
+                    history.Add(day);
+                }
+                day.date = tick.date;
+                opened = true;
+                break;
+            }
+            case TickKind::kFxSpot: {
+                // The last quote wins, whichever the direction
+                day.spots.erase(tick.pair.Reversed());
+                day.spots.insert_or_assign(tick.pair, tick.value);
+                break;
+            }
+            case TickKind::kSwapQuote: {
+                day.swap_quotes[tick.currency].insert_or_assign(tick.tenor_months, tick.value);
+                break;
+            }
+            case TickKind::kVolPillar:
+                break;
+        }
+    }
+    if (opened) {
+        history.Add(std::move(day));
+    }
+    return Ok(std::move(history));
+}
+
+void MarketHistory::Add(MarketDay day) {
+    const DateType date = day.date;
+    days_.insert_or_assign(date, std::move(day));
+}
+
+const MarketDay* MarketHistory::Find(DateType date) const noexcept {
+    if (auto it = days_.find(date); it != days_.end()) {
+        return &it->second;
+    }
+    return nullptr;
+}
+
+const MarketDay* MarketHistory::FindLatest(DateType date) const noexcept {
+    auto it = days_.upper_bound(date);
+    if (it == days_.begin()) {
+        return nullptr;
+    }
+    return &std::prev(it)->second;
+}
+
+u64 BacktestReport::Failed() const noexcept {
+    return static_cast<u64>(std::ranges::count_if(days, [](const auto& day) { return day.error.has_value(); }));
+}
+
+void BacktestReport::Write(std::ostream& out) const {
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+
+    out << std::fixed << std::setprecision(1);
+    out << "days " << days.size() << ", failed " << Failed() << ", elapsed "
+        << std::chrono::duration<f64, std::milli>(elapsed).count() << " ms\n";
+    out << std::left << std::setw(12) << "date" << std::setw(12) << "quoted" << std::right
+        << std::setw(20) << "pv" << std::setw(16) << "dv01" << '\n';
+    out << std::setprecision(2);
+    for (const auto& day : days) {
+        WriteDate(out, day.date);
+        out << "  ";
+        if (day.error.has_value()) {
+            out << std::left << std::setw(10) << "-" << std::right << "  " << ErrorAsStringView(*day.error) << '\n';
+            continue;
+        }
+        WriteDate(out, day.quoted);
+        out << std::setw(20) << day.total_pv << std::setw(16) << day.total_dv01 << '\n';
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+// Context and model of the last quoted day, rolled to the current date
+struct Backtest::Market {
+    // declared first, the model views it
+    std::unique_ptr<MarketContext> context;
+    std::unique_ptr<Model> model;
+    DateType quoted;
+    std::optional<Error> error;
+};
+
+Backtest::Backtest(std::shared_ptr<const HolidayStorage> calendar, const MarketHistory& history,
+                   const BacktestBook& book)
+    : calendar_(std::move(calendar))
+    , history_(history)
+    , book_(book)
+{
+    CDR_CHECK(calendar_ != nullptr);
+}
+
+BacktestReport Backtest::Run(const BacktestSettings& settings) const {
+    const auto start = Clock::now();
+    BacktestReport report;
+    report.days.resize(RangeSize(settings));
+    RunChunk(settings, settings.first, report.days);
+    report.elapsed = Clock::now() - start;
+    return report;
+}
+
+BacktestReport Backtest::Run(const BacktestSettings& settings, ThreadPool& pool) const {
+    const auto start = Clock::now();
+    BacktestReport report;
+    report.days.resize(RangeSize(settings));
+
+    const u64 size = report.days.size();
+    const u64 grain = settings.chunk_days != 0 ? settings.chunk_days
+                                               : (size + pool.Concurrency() - 1) / pool.Concurrency();
+    pool.ParallelFor(0, size, grain, [&](u64 first, u64 last) {
+        RunChunk(settings, AddDays(settings.first, first), std::span(report.days).subspan(first, last - first));
+    });
+    report.elapsed = Clock::now() - start;
+    return report;
+}
+
+void Backtest::RunChunk(const BacktestSettings& settings, DateType first, std::span<BacktestDay> days) const {
+    Market market;
+    for (u64 i = 0; i < days.size(); ++i) {
+        auto& day = days[i];
+        day = BacktestDay{.date = AddDays(first, i)};
+
+        if (const auto* quoted = history_.Find(day.date)) {
+            Load(market, *quoted);
+        } else if (market.model == nullptr) {
+            // Chunks starting between quotes pick up the last quoted day
+            if (const auto* latest = history_.FindLatest(day.date)) {
+                Load(market, *latest);
+            }
+        }
+        if (market.model == nullptr) {
+            day.error = Error::NoData;
+            continue;
+        }
+
+        if (market.context->Today() != day.date) {
+            market.context->SetToday(day.date);
+            market.model->RollToToday();
+        }
+        Value(settings, market, day);
+    }
+}
+
+void Backtest::Load(Market& market, const MarketDay& day) const {
+    market.model.reset();
+    market.context = std::make_unique<MarketContext>(calendar_, day.date);
+    market.model = std::make_unique<Model>(*market.context);
+    market.quoted = day.date;
+    market.error.reset();
+
+    for (const auto& [pair, spot] : day.spots) {
+        market.context->SetFxSpot(pair, spot);
+    }
+    // Only curves of the book are bootstrapped
+    for (const auto& [currency, quotes] : day.swap_quotes) {
+        const JurisdictionType jur = FXPairKey::UnpackCode(currency);
+        if (!book_.swaps.contains(jur)) {
+            continue;
+        }
+        market.model->SetSwaps(jur, QuotedSwaps(*calendar_, jur, day.date, quotes));
+        if (auto built = market.model->BuildMainCurve(jur); built.Failed() && !market.error.has_value()) {
+            market.error = built.GetFailure();
+        }
+    }
+}
+
+void Backtest::Value(const BacktestSettings& settings, const Market& market, BacktestDay& day) const {
+    day.quoted = market.quoted;
+    if (market.error.has_value()) {
+        day.error = market.error;
+        return;
+    }
+
+    const Model& model = *market.model;
+    for (const auto& [jur, portfolio] : book_.swaps) {
+        const Curve* curve = model.GetCurve(jur);
+        const auto rate = jur == settings.reporting_currency
+            ? std::optional<f64>(1.)
+            : market.context->FindFxSpot(FXPairKey::Pack(jur, settings.reporting_currency));
+        if (curve == nullptr || !rate.has_value()) {
+            day.error = Error::NoData;
+            return;
+        }
+
+        f64 pv = 0.;
+        f64 dv01 = 0.;
+        for (const auto& risk : portfolio.Risk(*curve)) {
+            pv += risk.npv;
+            dv01 += risk.dv01;
+        }
+        day.pv.emplace(jur, pv);
+        day.dv01.emplace(jur, dv01);
+        day.total_pv += pv * *rate;
+        day.total_dv01 += dv01 * *rate;
+    }
+}
+
+}  // namespace cdr
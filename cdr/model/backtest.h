@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cdr/model/internal/export.h>
+#include <cdr/model/model.h>
+#include <cdr/model/replay.h>
+#include <cdr/base/thread_pool.h>
+#include <cdr/types/types.h>
+#include <cdr/types/errors.h>
+#include <cdr/types/expect.h>
+#include <cdr/calendar/date.h>
+#include <cdr/calendar/holiday_storage.h>
+#include <cdr/market/context.h>
+#include <cdr/fx/fx.h>
+#include <cdr/swaps/portfolio.h>
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <vector>
+
+namespace cdr {
+
+// End of day market of one historical date
+struct MarketDay {
+    DateType date;
+    // pair as quoted -> spot
+    std::map<FXPairKey, f64> spots;
+    // currency -> tenor in months -> par rate in percent, see QuotedSwaps
+    std::map<u32, std::map<i32, f64>> swap_quotes;
+};
+
+// Historical market by date, dates without a MarketDay had no quotes
+class CDR_MODEL_EXPORT MarketHistory final {
+public:
+    // Days of a recording: every today tick closes the day before it and
+    // opens one holding each quote seen so far. Vol pillars are ignored.
+    // Fails with Error::InvalidInput if todays go backwards.
+    [[nodiscard]] static Expect<MarketHistory, Error> FromTicks(std::span<const MarketTick> ticks);
+
+    // insert or assign
+    void Add(MarketDay day);
+
+    // returns nullptr if `date` has no quotes
+    [[nodiscard]] const MarketDay* Find(DateType date) const noexcept;
+    // Last day with quotes on or before `date`, nullptr if there is none
+    [[nodiscard]] const MarketDay* FindLatest(DateType date) const noexcept;
+
+    [[nodiscard]] u64 Size() const noexcept {
+        return days_.size();
+    }
+
+private:
+    std::map<DateType, MarketDay> days_;
+};
+
+// Trades valued every day of a backtest
+struct BacktestBook {
+    // Swaps by currency, valued on the curve of their currency
+    std::map<JurisdictionType, SwapPortfolio> swaps;
+};
+
+struct BacktestSettings {
+    // Inclusive range of valuation dates
+    DateType first;
+    DateType last;
+    // Currency of the book totals
+    JurisdictionType reporting_currency = "USD";
+    // Consecutive days valued by one task of the pool, 0 splits the range
+    // evenly across its threads
+    u32 chunk_days = 0;
+};
+
+struct BacktestDay {
+    DateType date;
+    // Day of the quotes the curves were built from, before `date` if the
+    // curves were rolled forward to it
+    DateType quoted;
+    // Book NPV and DV01 by currency
+    std::map<JurisdictionType, f64> pv;
+    std::map<JurisdictionType, f64> dv01;
+    // Sums in the reporting currency at the spots of `quoted`
+    f64 total_pv = 0.;
+    f64 total_dv01 = 0.;
+    // Set if the day couldn't be valued, e.g. before the first quotes or
+    // with a curve that failed to build
+    std::optional<Error> error;
+
+    bool operator==(const BacktestDay&) const = default;
+};
+
+struct CDR_MODEL_EXPORT BacktestReport {
+    // One per date of the range, in order
+    std::vector<BacktestDay> days;
+    std::chrono::nanoseconds elapsed{0};
+
+    // Days with an error
+    [[nodiscard]] u64 Failed() const noexcept;
+
+    // One line per day
+    void Write(std::ostream& out) const;
+};
+
+// Values a book on every date of a range from historical quotes. Days with
+// quotes get a fresh MarketContext and Model bootstrapped from that day
+// only; days without quotes roll the curves of the last quoted day forward
+// with Model::RollToToday. A day thus depends on its date and its last
+// quoted day alone, so the range can be cut into chunks valued
+// independently, each with its own context and model, and gives exactly the
+// days of a sequential run whatever the chunking.
+class CDR_MODEL_EXPORT Backtest final {
+public:
+    // `history` and `book` must outlive the backtest
+    Backtest(std::shared_ptr<const HolidayStorage> calendar, const MarketHistory& history, const BacktestBook& book);
+
+    // Day by day on the calling thread
+    [[nodiscard]] BacktestReport Run(const BacktestSettings& settings) const;
+    // Consecutive chunks of days on `pool`
+    [[nodiscard]] BacktestReport Run(const BacktestSettings& settings, ThreadPool& pool) const;
+
+private:
+    struct Market;
+
+    // Values `days.size()` dates from `first` into `days`
+    void RunChunk(const BacktestSettings& settings, DateType first, std::span<BacktestDay> days) const;
+
+    void Load(Market& market, const MarketDay& day) const;
+    void Value(const BacktestSettings& settings, const Market& market, BacktestDay& day) const;
+
+private:
+    std::shared_ptr<const HolidayStorage> calendar_;
+    const MarketHistory& history_;
+    const BacktestBook& book_;
+};
+
+}  // namespace cdr
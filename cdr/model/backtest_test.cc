@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include <cdr/model/backtest.h>
+#include <cdr/calendar/date.h>
+#include <cdr/calendar/holiday_storage.h>
+#include <cdr/base/thread_pool.h>
+#include <cdr/market/context.h>
+#include <cdr/fx/fx.h>
+
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+
+// Quotes on weekdays from Jan 4th to Feb 26th 2027, but for Mondays
+// of odd weeks, drifting a little every day
+std::vector<cdr::MarketTick> MakeTicks() {
+    std::vector<cdr::MarketTick> ticks;
+    const SysDays start{year(2027) / January / day(4)};
+    i64 ts = 0;
+    for (i32 i = 0; i < 54; ++i) {
+        const cdr::DateType date = start + days(i);
+        const auto weekday = cdr::Weekday(date);
+        if (weekday == Saturday || weekday == Sunday || (weekday == Monday && (i / 7) % 2 == 1)) {
+            continue;
+        }
+        const f64 drift = 0.01 * i;
+        ticks.push_back({.timestamp_ns = ts++, .kind = cdr::TickKind::kToday, .date = date});
+        for (const auto& [months, rate] : {std::pair{12, 4.40}, {24, 4.10}, {60, 3.80}}) {
+            ticks.push_back({.timestamp_ns = ts++, .kind = cdr::TickKind::kSwapQuote,
+                             .currency = cdr::FXPairKey::PackCode("USD"), .tenor_months = months,
+                             .value = rate + drift});
+        }
+        // EUR only moves on odd days, the rest carries over
+        if (i % 2 == 1 || i == 0) {
+            for (const auto& [months, rate] : {std::pair{12, 2.50}, {60, 2.30}}) {
+                ticks.push_back({.timestamp_ns = ts++, .kind = cdr::TickKind::kSwapQuote,
+                                 .currency = cdr::FXPairKey::PackCode("EUR"), .tenor_months = months,
+                                 .value = rate - drift});
+            }
+        }
+        ticks.push_back({.timestamp_ns = ts++, .kind = cdr::TickKind::kFxSpot,
+                         .pair = cdr::FXPairKey::Pack("EUR", "USD"), .value = 1.10 + drift});
+    }
+    return ticks;
+}
+
+cdr::BacktestBook MakeBook(const cdr::HolidayStorage& calendar) {
+    const auto traded = year(2027) / January / day(4);
+    cdr::BacktestBook book;
+    for (const auto& swap : cdr::QuotedSwaps(calendar, "USD", traded, {{24, 4.00}, {60, 3.90}})) {
+        book.swaps["USD"].Add(swap);
+    }
+    for (const auto& swap : cdr::QuotedSwaps(calendar, "EUR", traded, {{12, 2.60}, {60, 2.20}})) {
+        book.swaps["EUR"].Add(swap);
+    }
+    return book;
+}
+
+// Book NPV and DV01 on a curve, as the backtest sums them
+std::pair<f64, f64> Value(const cdr::SwapPortfolio& portfolio, const cdr::Curve& curve) {
+    f64 pv = 0.;
+    f64 dv01 = 0.;
+    for (const auto& risk : portfolio.Risk(curve)) {
+        pv += risk.npv;
+        dv01 += risk.dv01;
+    }
+    return {pv, dv01};
+}
+
+}  // anonymous namespace
+
+TEST(MarketHistory, FromTicks) {
+    const auto history = cdr::MarketHistory::FromTicks(MakeTicks());
+    ASSERT_TRUE(history.Succeed());
+    // 40 weekdays less 4 skipped Mondays
+    ASSERT_EQ(history.Value().Size(), 36);
+
+    const auto* quotes = history.Value().Find(year(2027) / January / day(6));
+    ASSERT_NE(quotes, nullptr);
+    ASSERT_DOUBLE_EQ(quotes->spots.at(cdr::FXPairKey::Pack("EUR", "USD")), 1.12);
+    ASSERT_DOUBLE_EQ(quotes->swap_quotes.at(cdr::FXPairKey::PackCode("USD")).at(60), 3.82);
+    // Carried over from the 5th
+    ASSERT_DOUBLE_EQ(quotes->swap_quotes.at(cdr::FXPairKey::PackCode("EUR")).at(12), 2.49);
+
+    ASSERT_EQ(history.Value().Find(year(2027) / January / day(11)), nullptr);
+    ASSERT_EQ(history.Value().FindLatest(year(2027) / January / day(11))->date, year(2027) / January / day(8));
+    ASSERT_EQ(history.Value().FindLatest(year(2027) / January / day(3)), nullptr);
+
+    const std::vector<cdr::MarketTick> backwards = {
+        {.kind = cdr::TickKind::kToday, .date = year(2027) / January / day(5)},
+        {.kind = cdr::TickKind::kToday, .date = year(2027) / January / day(4)},
+    };
+    ASSERT_EQ(cdr::MarketHistory::FromTicks(backwards).GetFailure(), cdr::Error::InvalidInput);
+}
+
+TEST(Backtest, ChunksMatchSequentialRun) {
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("USD", year(2027) / January / day(18))
+        ("EUR", year(2027) / January / day(27))
+    ;
+    const auto calendar = std::make_shared<const cdr::HolidayStorage>(std::move(holiday_storage));
+    const auto history = cdr::MarketHistory::FromTicks(MakeTicks()).Value();
+    const auto book = MakeBook(*calendar);
+    const cdr::Backtest backtest(calendar, history, book);
+
+    const cdr::BacktestSettings settings{
+        .first = year(2027) / January / day(1),
+        .last = year(2027) / February / day(28),
+    };
+    const auto sequential = backtest.Run(settings);
+    ASSERT_EQ(sequential.days.size(), 59);
+    // Nothing is quoted before the 4th
+    ASSERT_EQ(sequential.Failed(), 3);
+    ASSERT_EQ(sequential.days[0].error, cdr::Error::NoData);
+
+    // Chunks starting on days with and without quotes
+    for (u32 chunk_days : {0u, 1u, 3u, 10u}) {
+        cdr::ThreadPool pool(4);
+        auto chunked_settings = settings;
+        chunked_settings.chunk_days = chunk_days;
+        const auto chunked = backtest.Run(chunked_settings, pool);
+        ASSERT_TRUE(chunked.days == sequential.days) << chunk_days;
+    }
+
+    // A quoted day is valued on curves bootstrapped from its own quotes
+    const auto wednesday = year(2027) / January / day(6);
+    const auto& quoted = sequential.days[5];
+    ASSERT_EQ(quoted.date, wednesday);
+    ASSERT_EQ(quoted.quoted, wednesday);
+    ASSERT_FALSE(quoted.error.has_value());
+    {
+        const auto* market = history.Find(wednesday);
+        cdr::MarketContext context(calendar, wednesday);
+        cdr::Model model(context);
+        for (const JurisdictionType jur : {"USD", "EUR"}) {
+            model.SetSwaps(jur, cdr::QuotedSwaps(*calendar, jur, wednesday,
+                                                 market->swap_quotes.at(cdr::FXPairKey::PackCode(jur))));
+            ASSERT_TRUE(model.BuildMainCurve(jur).Succeed());
+        }
+        const auto [usd_pv, usd_dv01] = Value(book.swaps.at("USD"), *model.GetCurve("USD"));
+        const auto [eur_pv, eur_dv01] = Value(book.swaps.at("EUR"), *model.GetCurve("EUR"));
+        ASSERT_EQ(quoted.pv.at("USD"), usd_pv);
+        ASSERT_EQ(quoted.dv01.at("EUR"), eur_dv01);
+        ASSERT_DOUBLE_EQ(quoted.total_pv, usd_pv + eur_pv * 1.12);
+        ASSERT_DOUBLE_EQ(quoted.total_dv01, usd_dv01 + eur_dv01 * 1.12);
+    }
+
+    // Days without quotes roll the curves of the last quoted day, as
+    // OnNextDay after each day would
+    const auto monday = year(2027) / January / day(11);
+    const auto& rolled = sequential.days[10];
+    ASSERT_EQ(rolled.date, monday);
+    ASSERT_EQ(rolled.quoted, year(2027) / January / day(8));
+    ASSERT_FALSE(rolled.error.has_value());
+    {
+        const auto friday = rolled.quoted;
+        const auto* market = history.Find(friday);
+        cdr::MarketContext context(calendar, friday);
+        cdr::Model model(context);
+        for (const JurisdictionType jur : {"USD", "EUR"}) {
+            model.SetSwaps(jur, cdr::QuotedSwaps(*calendar, jur, friday,
+                                                 market->swap_quotes.at(cdr::FXPairKey::PackCode(jur))));
+            ASSERT_TRUE(model.BuildMainCurve(jur).Succeed());
+        }
+        for (auto date = cdr::NextDay(friday); date <= monday; date = cdr::NextDay(date)) {
+            context.SetToday(date);
+            model.OnNextDay();
+        }
+        ASSERT_EQ(rolled.pv.at("USD"), Value(book.swaps.at("USD"), *model.GetCurve("USD")).first);
+        ASSERT_EQ(rolled.pv.at("EUR"), Value(book.swaps.at("EUR"), *model.GetCurve("EUR")).first);
+    }
+
+    std::ostringstream out;
+    sequential.Write(out);
+    ASSERT_NE(out.str().find("days 59, failed 3"), std::string::npos);
+}
+
+TEST(Model, RollToToday) {
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("USD", year(2027) / January / day(18))
+        ("EUR", year(2027) / January / day(27))
+    ;
+    const auto calendar = std::make_shared<const cdr::HolidayStorage>(std::move(holiday_storage));
+    const auto today = year(2027) / January / day(14);
+    cdr::MarketContext context(calendar, today);
+    cdr::Model stepped(context);
+    cdr::Model batched(context);
+    for (cdr::Model* model : {&stepped, &batched}) {
+        model->SetSwaps("USD", cdr::QuotedSwaps(*calendar, "USD", today, {{12, 4.4}, {24, 4.1}, {60, 3.8}}));
+        ASSERT_TRUE(model->BuildMainCurve("USD").Succeed());
+    }
+
+    // Over a weekend and the USD holiday of the 18th
+    const auto until = year(2027) / January / day(21);
+    for (auto date = cdr::NextDay(today); date <= until; date = cdr::NextDay(date)) {
+        context.SetToday(date);
+        stepped.OnNextDay();
+    }
+    const u64 version = batched.Version();
+    batched.RollToToday();
+    ASSERT_NE(batched.Version(), version);
+    ASSERT_EQ(batched.GetCurve("USD")->Pillars(), stepped.GetCurve("USD")->Pillars());
+
+    // Nothing to roll until the next day
+    batched.RollToToday();
+    ASSERT_EQ(batched.GetCurve("USD")->Pillars(), stepped.GetCurve("USD")->Pillars());
+}
@@ -1,24 +1,86 @@
 #include <cdr/model/model.h>
 #include <cdr/curve/interpolation/linear.h>
 
+#include <ceres/jet.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <latch>
+#include <map>
+#include <new>
+#include <utility>
+
 namespace cdr {
 
+std::string CurveChanges::ToString() const {
+    constexpr std::array<std::string_view, static_cast<u64>(CurveChange::__NumberOfChanges)> kNames = {
+        "new", "swaps", "forwards", "fx_spot", "today", "main"};
+
+    std::string result;
+    for (u64 i = 0; i < kNames.size(); ++i) {
+        if (Has(static_cast<CurveChange>(i))) {
+            if (!result.empty()) {
+                result += ',';
+            }
+            result += kNames[i];
+        }
+    }
+    return result;
+}
+
 void Model::SetSwaps(JurisdictionType jur, std::vector<IrsContract>&& swaps) noexcept {
     swaps_.insert_or_assign(jur, std::move(swaps));
+    curve_states_[jur].pending.Set(CurveChange::kSwaps);
 }
 
 void Model::SetForwards(JurisdictionType jur, std::vector<ForwardContract>&& fwds) noexcept {
     forwards_.insert_or_assign(jur, std::move(fwds));
+    curve_states_[jur].pending.Set(CurveChange::kForwards);
 }
 
 
-Expect<void, Error> Model::BuildMainCurve(JurisdictionType jur) noexcept {
-    auto& swaps = swaps_[jur];
-    auto curve = CurveBuilder(ctx_)
+std::unique_ptr<Curve> Model::MakeMainCurve(const JurisdictionType& jur) const {
+    // Bootstrapping adapts the swaps, the map itself is left intact
+    auto it = swaps_.find(jur);
+    if (it == swaps_.end()) {
+        return CurveBuilder(ctx_).Jurisdiction(jur).FromPoints();
+    }
+    return CurveBuilder(ctx_)
         .Jurisdiction(jur)
-        .FromContracts(swaps.begin(), swaps.end());
-    ;
-    AddCurve(std::move(curve));
+        .FromContracts(it->second.begin(), it->second.end());
+}
+
+std::unique_ptr<Curve> Model::MakeDependentCurve(const Curve& main, const JurisdictionType& jur) const {
+    auto it = forwards_.find(jur);
+    if (it == forwards_.end()) {
+        return CurveBuilder(ctx_).Jurisdiction(jur).FromPoints();
+    }
+    return CurveBuilder(ctx_)
+        .Jurisdiction(jur)
+        .FromOther(main, it->second.begin(), it->second.end());
+}
+
+std::vector<std::pair<FXPairKey, std::optional<f64>>> Model::ForwardSpots(const JurisdictionType& jur) const {
+    std::vector<std::pair<FXPairKey, std::optional<f64>>> spots;
+    auto it = forwards_.find(jur);
+    if (it == forwards_.end()) {
+        return spots;
+    }
+    for (const auto& fwd : it->second) {
+        const FXPairKey key = fwd.GetPair().Key();
+        if (std::ranges::find(spots, key, &std::pair<FXPairKey, std::optional<f64>>::first) == spots.end()) {
+            spots.emplace_back(key, ctx_.FindFxSpot(key));
+        }
+    }
+    return spots;
+}
+
+Expect<void, Error> Model::BuildMainCurve(JurisdictionType jur) noexcept {
+    Install(MakeMainCurve(jur));
+    MarkDependents(jur);
     return Ok();
 }
 
@@ -28,27 +90,319 @@ Expect<void, Error> Model::BuildDependentCurve(JurisdictionType main_jur, Jurisd
     if (main == nullptr) [[unlikely]] {
         return Failure(Error::NoData);
     }
-    const auto& fwds = forwards_[dependent_jur];
-    auto curve = CurveBuilder(ctx_)
-        .Jurisdiction(dependent_jur)
-        .FromOther(*main, fwds.begin(), fwds.end())
-    ;
-    AddCurve(std::move(curve));
+    auto spots = ForwardSpots(dependent_jur);
+    Install(MakeDependentCurve(*main, dependent_jur), std::move(spots));
+    MarkDependents(dependent_jur);
 
     return Ok();
 }
 
+Expect<Model::CurveOrder, Error> Model::OrderCurves() const {
+    // Every curve with swaps or a dependency, and the curve it depends on
+    std::map<JurisdictionType, std::optional<JurisdictionType>> mains;
+    for (const auto& [jur, swaps] : swaps_) {
+        mains.try_emplace(jur);
+    }
+    for (const auto& [main, dependents] : curve_deps_) {
+        mains.try_emplace(main);
+        for (const auto& dependent : dependents) {
+            auto& known = mains[dependent];
+            if (dependent == main || (known.has_value() && *known != main)) [[unlikely]] {
+                return ErrorInvalidInput();
+            }
+            known = main;
+        }
+    }
+
+    // Breadth first from the main curves, anything unreached is on a cycle
+    CurveOrder order;
+    order.jurs.reserve(mains.size());
+    std::map<JurisdictionType, u64> index;
+    for (const auto& [jur, main] : mains) {
+        if (!main.has_value()) {
+            index.emplace(jur, order.jurs.size());
+            order.jurs.push_back(jur);
+            order.main_of.push_back(CurveOrder::kNoMain);
+        }
+    }
+    for (u64 i = 0; i < order.jurs.size(); ++i) {
+        order.dependents_of.emplace_back();
+        auto deps = curve_deps_.find(order.jurs[i]);
+        if (deps == curve_deps_.end()) {
+            continue;
+        }
+        for (const auto& dependent : deps->second) {
+            if (index.contains(dependent)) {
+                continue;
+            }
+            index.emplace(dependent, order.jurs.size());
+            order.dependents_of[i].push_back(order.jurs.size());
+            order.jurs.push_back(dependent);
+            order.main_of.push_back(i);
+        }
+    }
+    if (order.jurs.size() != mains.size()) [[unlikely]] {
+        return ErrorInvalidInput();
+    }
+    return Ok(std::move(order));
+}
+
+std::vector<CurveChanges> Model::Changes(const CurveOrder& order) const {
+    std::vector<CurveChanges> changes(order.jurs.size());
+    for (u64 i = 0; i < order.jurs.size(); ++i) {
+        auto state = curve_states_.find(order.jurs[i]);
+        if (state == curve_states_.end() || !state->second.built) {
+            changes[i].Set(CurveChange::kNew);
+            continue;
+        }
+        changes[i] = state->second.pending;
+        if (state->second.today != Today()) {
+            changes[i].Set(CurveChange::kToday);
+        }
+        if (order.main_of[i] != CurveOrder::kNoMain && ForwardSpots(order.jurs[i]) != state->second.spots) {
+            changes[i].Set(CurveChange::kFxSpot);
+        }
+    }
+
+    // Mains come first, so changes reach the ends of dependency chains
+    for (u64 i = 0; i < order.jurs.size(); ++i) {
+        if (order.main_of[i] != CurveOrder::kNoMain && changes[order.main_of[i]].Any()
+            && !changes[i].Has(CurveChange::kNew)) {
+            changes[i].Set(CurveChange::kMain);
+        }
+    }
+    return changes;
+}
+
+CurveBuildReport Model::BuildCurves(ThreadPool& pool, const CurveOrder& order, const std::vector<bool>& selected,
+                                    std::vector<CurveChanges> changes) {
+    using Clock = std::chrono::steady_clock;
+    constexpr u64 kNoMain = CurveOrder::kNoMain;
+
+    const u64 size = order.jurs.size();
+    CurveBuildReport report;
+    std::vector<u64> slot(size, 0);
+    for (u64 i = 0; i < size; ++i) {
+        if (selected[i]) {
+            slot[i] = report.curves.size();
+            report.curves.push_back({
+                .jur = order.jurs[i],
+                .main = order.main_of[i] == kNoMain ? JurisdictionType() : order.jurs[order.main_of[i]],
+                .changes = changes[i],
+            });
+        }
+    }
+
+    std::vector<std::unique_ptr<Curve>> built(size);
+    std::vector<std::vector<std::pair<FXPairKey, std::optional<f64>>>> spots(size);
+    std::latch done(static_cast<std::ptrdiff_t>(report.curves.size()));
+    const auto start = Clock::now();
+
+    // A task builds its curve and then schedules the dependents, so the
+    // main curve is complete before anything reads it. Mains left out are
+    // taken from the model, which is not modified until every build is done.
+    std::function<void(u64)> build = [&](u64 i) {
+        auto& timing = report.curves[slot[i]];
+        const auto begin = Clock::now();
+        timing.start = begin - start;
+
+        const u64 main_index = order.main_of[i];
+        const Curve* main = nullptr;
+        if (main_index != kNoMain) {
+            if (selected[main_index]) {
+                main = built[main_index].get();
+            } else if (auto it = curves_.find(order.jurs[main_index]); it != curves_.end()) {
+                main = it->second.get();
+            }
+        }
+
+        if (main_index != kNoMain && main == nullptr) {
+            timing.error = Error::NoData;
+        } else {
+            try {
+                if (main_index == kNoMain) {
+                    built[i] = MakeMainCurve(timing.jur);
+                } else {
+                    spots[i] = ForwardSpots(timing.jur);
+                    built[i] = MakeDependentCurve(*main, timing.jur);
+                }
+            } catch (const std::bad_alloc&) {
+                timing.error = Error::NoMemory;
+            } catch (...) {
+                timing.error = Error::CalibrationFailed;
+            }
+        }
+        timing.elapsed = Clock::now() - begin;
+
+        for (u64 dependent : order.dependents_of[i]) {
+            if (selected[dependent]) {
+                pool.Submit([&build, dependent] { build(dependent); });
+            }
+        }
+        done.count_down();
+    };
+
+    for (u64 i = 0; i < size; ++i) {
+        if (selected[i] && (order.main_of[i] == kNoMain || !selected[order.main_of[i]])) {
+            pool.Submit([&build, i] { build(i); });
+        }
+    }
+    pool.RunUntil(done);
+    report.elapsed = Clock::now() - start;
+
+    // In dependency order: a dependent installed after its main is current
+    for (u64 i = 0; i < size; ++i) {
+        if (built[i] != nullptr) {
+            Install(std::move(built[i]), std::move(spots[i]));
+            MarkDependents(order.jurs[i]);
+        } else if (selected[i]) {
+            changes[i].Reset(CurveChange::kNew);
+            curve_states_[order.jurs[i]].pending |= changes[i];
+        }
+    }
+    return report;
+}
+
+Expect<CurveBuildReport, Error> Model::BuildAll(ThreadPool& pool) {
+    auto order = OrderCurves();
+    if (order.Failed()) [[unlikely]] {
+        return std::move(order).PropagateFailure();
+    }
+    auto changes = Changes(order.Value());
+    const std::vector<bool> selected(order.Value().jurs.size(), true);
+    return Ok(BuildCurves(pool, order.Value(), selected, std::move(changes)));
+}
+
+Expect<CurveBuildReport, Error> Model::Recalculate(ThreadPool& pool) {
+    auto order = OrderCurves();
+    if (order.Failed()) [[unlikely]] {
+        return std::move(order).PropagateFailure();
+    }
+    auto changes = Changes(order.Value());
+    std::vector<bool> selected(changes.size());
+    for (u64 i = 0; i < changes.size(); ++i) {
+        selected[i] = changes[i].Any();
+    }
+    return Ok(BuildCurves(pool, order.Value(), selected, std::move(changes)));
+}
+
+Expect<std::map<JurisdictionType, CurveChanges>, Error> Model::PendingChanges() const {
+    auto order = OrderCurves();
+    if (order.Failed()) [[unlikely]] {
+        return std::move(order).PropagateFailure();
+    }
+    const auto changes = Changes(order.Value());
+    std::map<JurisdictionType, CurveChanges> pending;
+    for (u64 i = 0; i < changes.size(); ++i) {
+        if (changes[i].Any()) {
+            pending.emplace(order.Value().jurs[i], changes[i]);
+        }
+    }
+    return Ok(std::move(pending));
+}
+
+bool CurveBuildReport::Succeed() const noexcept {
+    return std::ranges::none_of(curves, [](const auto& curve) { return curve.error.has_value(); });
+}
+
+std::chrono::nanoseconds CurveBuildReport::BuildTime() const noexcept {
+    std::chrono::nanoseconds total{0};
+    for (const auto& curve : curves) {
+        total += curve.elapsed;
+    }
+    return total;
+}
+
+void CurveBuildReport::Write(std::ostream& out) const {
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+    const auto us = [](std::chrono::nanoseconds ns) {
+        return std::chrono::duration<f64, std::micro>(ns).count();
+    };
+
+    out << std::fixed << std::setprecision(1);
+    out << "curves " << curves.size() << ", elapsed " << us(elapsed) << " us"
+        << ", build time " << us(BuildTime()) << " us\n";
+    out << std::left << std::setw(10) << "curve" << std::setw(10) << "main" << std::right
+        << std::setw(12) << "start, us" << std::setw(12) << "build, us" << "   changes\n";
+    for (const auto& curve : curves) {
+        out << std::left << std::setw(10) << curve.jur << std::setw(10) << (curve.main.empty() ? "-" : curve.main)
+            << std::right << std::setw(12) << us(curve.start) << std::setw(12) << us(curve.elapsed)
+            << "   " << (curve.changes.Any() ? curve.changes.ToString() : "-");
+        if (curve.error.has_value()) {
+            out << "   " << ErrorAsStringView(*curve.error);
+        }
+        out << '\n';
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void Model::Install(std::unique_ptr<Curve>&& curve,
+                    std::vector<std::pair<FXPairKey, std::optional<f64>>> spots) const {
+    auto& state = curve_states_[curve->GetJurisdiction()];
+    state.built = true;
+    state.today = Today();
+    state.spots = std::move(spots);
+    state.pending = {};
 
-void Model::AddCurve(std::unique_ptr<Curve>&& curve) {
     auto jur = curve->GetJurisdiction();
     curves_.insert_or_assign(jur, std::move(curve));
+    ++version_;
+}
+
+void Model::MarkDependents(const JurisdictionType& main) const {
+    if (auto it = curve_deps_.find(main); it != curve_deps_.end()) {
+        for (const auto& dependent : it->second) {
+            curve_states_[dependent].pending.Set(CurveChange::kMain);
+        }
+    }
+}
+
+void Model::AddCurve(std::unique_ptr<Curve>&& curve) {
+    // Taken as built from the current inputs
+    auto jur = curve->GetJurisdiction();
+    Install(std::move(curve), ForwardSpots(jur));
+    MarkDependents(jur);
+}
+
+void Model::RollToToday() noexcept {
+    const DateType today = Today();
+    for (auto& [jur, curve] : curves_) {
+        const auto& calendar = ctx_.Calendar();
+        auto& state = curve_states_[jur];
+        u32 days = 0;
+        if (state.today == DateType{}) {
+            // No today recorded, roll as OnNextDay
+            days = calendar.IsBusinessDay(jur, today) ? 1 : 0;
+        } else {
+            for (DateType date = NextDay(state.today); date <= today; date = NextDay(date)) {
+                days += calendar.IsBusinessDay(jur, date) ? 1 : 0;
+            }
+        }
+        curve->RollForward(days);
+        state.today = today;
+    }
+    ++version_;
 }
 
 void Model::AddDependency(const JurisdictionType& main, const JurisdictionType& dependent) {
     curve_deps_[main].push_back(dependent);
+    curve_states_[dependent].pending.Set(CurveChange::kMain);
 }
 
 const Curve* Model::GetCurve(const JurisdictionType& jur) const noexcept {
+    if (lazy_) {
+        {
+            std::shared_lock lock(curves_mutex_);
+            if (auto it = curves_.find(jur); it != curves_.end()) [[likely]] {
+                return it->second.get();
+            }
+        }
+        std::unique_lock lock(curves_mutex_);
+        return FindOrBuildLocked(jur, 0);
+    }
+
     if (auto it = curves_.find(jur); it == curves_.end()) [[unlikely]] {
         return nullptr;
     } else {
@@ -57,13 +411,54 @@ const Curve* Model::GetCurve(const JurisdictionType& jur) const noexcept {
 }
 
 Curve* Model::GetCurve(const JurisdictionType& jur) noexcept {
+    if (lazy_ && std::as_const(*this).GetCurve(jur) == nullptr) [[unlikely]] {
+        return nullptr;
+    }
     if (auto it = curves_.find(jur); it == curves_.end()) [[unlikely]] {
         return nullptr;
     } else {
+        ++version_;
         return it->second.get();
     }
 }
 
+const Curve* Model::FindOrBuildLocked(const JurisdictionType& jur, u64 depth) const {
+    // Another lookup may have built it while the lock was released
+    if (auto it = curves_.find(jur); it != curves_.end()) {
+        return it->second.get();
+    }
+
+    std::optional<JurisdictionType> main;
+    for (const auto& [candidate, dependents] : curve_deps_) {
+        if (std::ranges::find(dependents, jur) == dependents.end()) {
+            continue;
+        }
+        if (main.has_value() && *main != candidate) [[unlikely]] {
+            return nullptr;
+        }
+        main = candidate;
+    }
+
+    if (main.has_value()) {
+        // Longer chains than dependencies recorded are cycles
+        if (depth > curve_deps_.size()) [[unlikely]] {
+            return nullptr;
+        }
+        const Curve* main_curve = FindOrBuildLocked(*main, depth + 1);
+        if (main_curve == nullptr) [[unlikely]] {
+            return nullptr;
+        }
+        auto spots = ForwardSpots(jur);
+        Install(MakeDependentCurve(*main_curve, jur), std::move(spots));
+    } else if (swaps_.contains(jur)) {
+        Install(MakeMainCurve(jur));
+    } else {
+        return nullptr;
+    }
+    MarkDependents(jur);
+    return curves_.at(jur).get();
+}
+
 f64 Model::ForwardPrice(const FXPair& pair, const DateType& date) const noexcept {
     auto spot = ctx_.FxSpot(pair);
     auto *base_curve = GetCurve(pair.first);
@@ -71,14 +466,334 @@ f64 Model::ForwardPrice(const FXPair& pair, const DateType& date) const noexcept
     if (base_curve == nullptr || quote_curve == nullptr) [[unlikely]] {
         return 0.;
     }
-    auto base_rate = base_curve->Interpolated<Linear>(date, ctx_.Calendar(), base_curve->GetJurisdiction());
-    auto quote_rate = quote_curve->Interpolated<Linear>(date, ctx_.Calendar(), quote_curve->GetJurisdiction());
 
-    auto base_df = base_curve->ZeroRatesToDiscount(date, base_rate);
-    auto quote_df = quote_curve->ZeroRatesToDiscount(date, quote_rate);
+    // The spot settles on the spot date, so both legs are discounted from it
+    const DateType spot_date = ctx_.SpotDate(pair);
+    const auto discount = [&](const Curve& curve, const DateType& when) {
+        const auto rate = curve.Interpolated<Linear>(when, ctx_.Calendar(), curve.GetJurisdiction());
+        return curve.ZeroRatesToDiscount(when, rate).Fraction();
+    };
+
+    const f64 base_df = discount(*base_curve, date) / discount(*base_curve, spot_date);
+    const f64 quote_df = discount(*quote_curve, date) / discount(*quote_curve, spot_date);
+    return spot * base_df / quote_df;
+}
+
+namespace {
+
+// Pillars whose NPV derivatives one jet carries
+constexpr u64 kPillarBlock = 8;
+using PillarJet = ceres::Jet<f64, static_cast<int>(kPillarBlock)>;
+
+// Spreads the adjoint of the rate interpolated at `date` over the pillars
+void AddRateAdjoint(std::map<DateType, f64>& adjoints, const Curve& curve, const DateType& date,
+                    const JurisdictionType& jur, f64 adjoint) {
+    const auto weights = Linear::InterpolationWeights(curve.Pillars(), date, curve.Calendar(), jur);
+    if (weights.lo == curve.Pillars().end()) [[unlikely]] {
+        return;
+    }
+    adjoints[weights.lo->first] += adjoint * (1. - weights.up_weight);
+    if (weights.up != weights.lo) {
+        adjoints[weights.up->first] += adjoint * weights.up_weight;
+    }
+}
+
+[[nodiscard]] FXPairKey CanonicalPair(FXPairKey pair) noexcept {
+    return std::min(pair, pair.Reversed());
+}
+
+}  // anonymous namespace
+
+f64 ForwardSensitivities::SpotDerivative(FXPairKey pair) const noexcept {
+    const FXPairKey canonical = CanonicalPair(pair);
+    auto it = spots.find(canonical);
+    if (it == spots.end()) {
+        return 0.;
+    }
+    // d/d(1 / spot) = -spot^2 * d/d(spot)
+    const auto& [spot, derivative] = it->second;
+    return pair == canonical ? derivative : -spot * spot * derivative;
+}
+
+Expect<ForwardSensitivities, Error> Model::ForwardPriceSensitivities(const FXPair& pair,
+                                                                     const DateType& date) const {
+    const auto* base_curve = GetCurve(pair.first);
+    const auto* quote_curve = GetCurve(pair.second);
+    if (base_curve == nullptr || quote_curve == nullptr) [[unlikely]] {
+        return ErrorNoData();
+    }
+    auto order = OrderCurves();
+    if (order.Failed()) [[unlikely]] {
+        return std::move(order).PropagateFailure();
+    }
+    const auto changes = Changes(order.Value());
+
+    // Forward pass, as in ForwardPrice
+    ForwardSensitivities result;
+    const DateType spot_date = ctx_.SpotDate(pair);
+    const f64 date_time = DayCountFraction(Period{Today(), date});
+    const f64 spot_time = DayCountFraction(Period{Today(), spot_date});
+    const auto rate = [&](const Curve& curve, const DateType& when) {
+        return curve.Interpolated<Linear>(when, ctx_.Calendar(), curve.GetJurisdiction()).Fraction();
+    };
+    const f64 spot = ctx_.FxSpot(pair);
+    result.price = spot * std::exp(-rate(*base_curve, date) * date_time + rate(*base_curve, spot_date) * spot_time
+                                   + rate(*quote_curve, date) * date_time - rate(*quote_curve, spot_date) * spot_time);
+
+    // Backward pass: pricing, then curves from dependents to their mains
+    std::map<JurisdictionType, PillarAdjoints> adjoints;
+    std::map<FXPairKey, f64> spot_adjoints;
+    spot_adjoints[pair.Key()] += result.price / spot;
+    auto& base_adjoints = adjoints[base_curve->GetJurisdiction()];
+    AddRateAdjoint(base_adjoints, *base_curve, date, base_curve->GetJurisdiction(), -result.price * date_time);
+    AddRateAdjoint(base_adjoints, *base_curve, spot_date, base_curve->GetJurisdiction(), result.price * spot_time);
+    auto& quote_adjoints = adjoints[quote_curve->GetJurisdiction()];
+    AddRateAdjoint(quote_adjoints, *quote_curve, date, quote_curve->GetJurisdiction(), result.price * date_time);
+    AddRateAdjoint(quote_adjoints, *quote_curve, spot_date, quote_curve->GetJurisdiction(), -result.price * spot_time);
+
+    const auto& jurs = order.Value().jurs;
+    for (u64 i = jurs.size(); i-- > 0;) {
+        auto it = adjoints.find(jurs[i]);
+        if (it == adjoints.end()) {
+            continue;
+        }
+        if (changes[i].Any()) [[unlikely]] {
+            return ErrorInvalidInput();
+        }
+        const auto* curve = GetCurve(jurs[i]);
+        if (curve == nullptr) [[unlikely]] {
+            return ErrorNoData();
+        }
+
+        Expect<void, Error> swept = Ok();
+        if (const u64 main = order.Value().main_of[i]; main != CurveOrder::kNoMain) {
+            const auto* main_curve = GetCurve(jurs[main]);
+            if (main_curve == nullptr) [[unlikely]] {
+                return ErrorNoData();
+            }
+            swept = DependentCurveAdjoint(*curve, *main_curve, it->second, adjoints[jurs[main]], spot_adjoints,
+                                          result.forwards[jurs[i]]);
+        } else if (swaps_.contains(jurs[i])) {
+            swept = MainCurveAdjoint(*curve, it->second, result.swaps[jurs[i]]);
+        } else {
+            continue;
+        }
+        if (swept.Failed()) [[unlikely]] {
+            return Failure(swept.GetFailure());
+        }
+        adjoints.erase(it);
+    }
+    result.pillars = std::move(adjoints);
+
+    for (const auto& [used, adjoint] : spot_adjoints) {
+        const FXPairKey canonical = CanonicalPair(used);
+        auto& sensitivity = result.spots[canonical];
+        sensitivity.spot = ctx_.FxSpot(canonical);
+        // d/d(spot) of the reversed quote 1 / spot is -1 / spot^2 of it
+        sensitivity.derivative += used == canonical ? adjoint : -adjoint / (sensitivity.spot * sensitivity.spot);
+    }
+    return Ok(std::move(result));
+}
+
+Expect<void, Error> Model::MainCurveAdjoint(const Curve& curve, const PillarAdjoints& adjoints,
+                                            std::vector<f64>& swap_adjoints) const {
+    const auto& jur = curve.GetJurisdiction();
+    const auto& swaps = swaps_.at(jur);
+    const auto& pillars = curve.Pillars();
+
+    // Swap j was bootstrapped on the pillars of swaps 0..j, solving for its own
+    std::vector<DateType> dates;
+    std::map<DateType, u64> index_of;
+    dates.reserve(swaps.size());
+    for (const auto& swap : swaps) {
+        const DateType settlement = swap.SettlementDate();
+        if (!pillars.contains(settlement) || index_of.contains(settlement)) [[unlikely]] {
+            return ErrorInvalidInput();
+        }
+        index_of.emplace(settlement, dates.size());
+        dates.push_back(settlement);
+    }
+    if (dates.size() != pillars.size()) [[unlikely]] {
+        return ErrorInvalidInput();
+    }
+
+    // jacobian[j * size + k] = d NPV_j / d pillar_k, lower triangular. Zero
+    // rates are linear in the pillars around them, so the NPV of swap j read
+    // off its pillars 0..j as jets gives the exact derivatives, one
+    // evaluation per block of kPillarBlock pillars.
+    const u64 size = dates.size();
+    std::vector<f64> jacobian(size * size, 0.);
+    std::vector<f64> quote_derivatives(size, 0.);
+    Curve::PointsContainer partial;
+
+    for (u64 j = 0; j < size; ++j) {
+        partial.emplace(dates[j], pillars.at(dates[j]));
+        const auto& swap = swaps[j];
+
+        for (u64 begin = 0; begin <= j; begin += kPillarBlock) {
+            auto pillar_jet = [&](Curve::PointsContainer::const_iterator it) {
+                const u64 k = index_of.at(it->first);
+                if (k < begin || k >= begin + kPillarBlock) {
+                    return PillarJet(it->second.Fraction());
+                }
+                return PillarJet(it->second.Fraction(), static_cast<int>(k - begin));
+            };
+            auto rate_at = [&](const DateType& curve_date) {
+                const auto weights = Linear::InterpolationWeights(partial, curve_date, curve.Calendar(), jur);
+                return pillar_jet(weights.lo) * (1. - weights.up_weight) + pillar_jet(weights.up) * weights.up_weight;
+            };
+
+            const PillarJet npv = swap.ProjectedNPV<PillarJet>(curve.Today(), rate_at);
+            for (u64 k = begin; k <= j && k < begin + kPillarBlock; ++k) {
+                jacobian[j * size + k] = npv.v[static_cast<int>(k - begin)];
+            }
+            if (begin == 0) {
+                // NPV = sign * (float - fixed), sign is +1 for the fixed rate payer
+                const f64 annuity = swap.Annuity<PillarJet>(curve.Today(), rate_at).a;
+                quote_derivatives[j] = (swap.PayFix() ? -1. : 1.) * swap.Notional() * annuity;
+            }
+        }
+    }
+
+    // Transposed triangular solve for the NPV adjoints, then quotes through
+    // d pillars / d quotes = -jacobian^-1 * d NPV / d quotes
+    swap_adjoints.assign(size, 0.);
+    std::vector<f64> lambda(size, 0.);
+    for (u64 j = size; j-- > 0;) {
+        auto it = adjoints.find(dates[j]);
+        f64 residual = it != adjoints.end() ? it->second : 0.;
+        for (u64 i = j + 1; i < size; ++i) {
+            residual -= jacobian[i * size + j] * lambda[i];
+        }
+        if (jacobian[j * size + j] == 0.) [[unlikely]] {
+            return ErrorCalibrationFailed();
+        }
+        lambda[j] = residual / jacobian[j * size + j];
+        swap_adjoints[j] = -lambda[j] * quote_derivatives[j];
+    }
+    return Ok();
+}
+
+Expect<void, Error> Model::DependentCurveAdjoint(const Curve& curve, const Curve& main,
+                                                 const PillarAdjoints& adjoints, PillarAdjoints& main_adjoints,
+                                                 std::map<FXPairKey, f64>& spot_adjoints,
+                                                 std::vector<f64>& forward_adjoints) const {
+    const auto& jur = curve.GetJurisdiction();
+    auto fwds = forwards_.find(jur);
+    if (fwds == forwards_.end()) {
+        if (!curve.Pillars().empty()) [[unlikely]] {
+            return ErrorInvalidInput();
+        }
+        return Ok();
+    }
+
+    // A forward settling on the day of an earlier one overwrites its pillar
+    std::map<DateType, u64> owners;
+    for (u64 k = 0; k < fwds->second.size(); ++k) {
+        const auto& fwd = fwds->second[k];
+        owners.insert_or_assign(ctx_.Calendar().AdvanceDateByConvention(jur, fwd.GetTradeDate(), fwd.GetTenor()), k);
+    }
+    if (owners.size() != curve.Pillars().size()) [[unlikely]] {
+        return ErrorInvalidInput();
+    }
+
+    // pillar = r_main(spot date) - log(spot / price) / DCF(spot date, settlement)
+    forward_adjoints.assign(fwds->second.size(), 0.);
+    for (const auto& [settlement, adjoint] : adjoints) {
+        auto owner = owners.find(settlement);
+        if (owner == owners.end()) [[unlikely]] {
+            return ErrorInvalidInput();
+        }
+        const auto& fwd = fwds->second[owner->second];
+        const DateType spot_date = ctx_.SpotDate(fwd.GetPair());
+        const f64 tau = DayCountFraction(Period{spot_date, settlement});
+        const f64 spot = ctx_.FxSpot(fwd.GetPair());
+
+        AddRateAdjoint(main_adjoints, main, spot_date, main.GetJurisdiction(), adjoint);
+        spot_adjoints[fwd.GetPair().Key()] -= adjoint / (spot * tau);
+        forward_adjoints[owner->second] += adjoint / (fwd.GetPrice() * tau);
+    }
+    return Ok();
+}
+
+Expect<void, Error> Model::ForwardPrices(const FXPair& pair, std::span<const DateType> dates,
+                                         std::span<f64> prices) const {
+    if (prices.size() < dates.size()) [[unlikely]] {
+        return Failure(Error::InvalidInput);
+    }
+    if (!std::is_sorted(dates.begin(), dates.end())) [[unlikely]] {
+        return Failure(Error::InvalidInput);
+    }
+    if (!dates.empty() && dates.front() < Today()) [[unlikely]] {
+        return Failure(Error::DateInAPast);
+    }
+
+    const auto factors = FindForwardFactors(pair.Key(), dates);
+    if (factors != nullptr) [[likely]] {
+        const f64 spot = ctx_.FxSpot(pair);
+        for (u64 i = 0; i < dates.size(); ++i) {
+            prices[i] = spot * factors->factors[i];
+        }
+        return Ok();
+    }
+
+    const auto* base_curve = GetCurve(pair.first);
+    const auto* quote_curve = GetCurve(pair.second);
+    if (base_curve == nullptr || quote_curve == nullptr) [[unlikely]] {
+        return Failure(Error::NoData);
+    }
+
+    auto computed = std::make_shared<ForwardFactors>();
+    computed->version = version_;
+    computed->today = Today();
+    computed->spot_date = ctx_.SpotDate(pair);
+    computed->dates.assign(dates.begin(), dates.end());
+    computed->factors.resize(dates.size());
 
-    return spot * (base_df / quote_df).Fraction();
+    std::vector<f64> base_rates(dates.size());
+    std::vector<f64> quote_rates(dates.size());
+    Linear::Interpolate(base_curve->Pillars(), dates, ctx_.Calendar(), base_curve->GetJurisdiction(), base_rates);
+    Linear::Interpolate(quote_curve->Pillars(), dates, ctx_.Calendar(), quote_curve->GetJurisdiction(), quote_rates);
+
+    // Both curves discount from the same today: one exp per date, relative
+    // to the spot date
+    const f64 today_time = ActActISDATime(Today());
+    const DateType spot_date = computed->spot_date;
+    const f64 spot_time = ActActISDATime(spot_date) - today_time;
+    const f64 spot_exponent =
+        (quote_curve->Interpolated<Linear>(spot_date, ctx_.Calendar(), quote_curve->GetJurisdiction()).Fraction()
+         - base_curve->Interpolated<Linear>(spot_date, ctx_.Calendar(), base_curve->GetJurisdiction()).Fraction())
+        * spot_time;
+    for (u64 i = 0; i < dates.size(); ++i) {
+        const f64 time = ActActISDATime(dates[i]) - today_time;
+        computed->factors[i] = std::exp((quote_rates[i] - base_rates[i]) * time - spot_exponent);
+    }
+
+    const f64 spot = ctx_.FxSpot(pair);
+    for (u64 i = 0; i < dates.size(); ++i) {
+        prices[i] = spot * computed->factors[i];
+    }
+
+    std::lock_guard lock(forward_factors_mutex_);
+    forward_factors_.insert_or_assign(pair.Key(), std::move(computed));
+    return Ok();
 }
 
+std::shared_ptr<const Model::ForwardFactors> Model::FindForwardFactors(FXPairKey pair,
+                                                                       std::span<const DateType> dates) const {
+    std::shared_ptr<const ForwardFactors> factors;
+    {
+        std::lock_guard lock(forward_factors_mutex_);
+        if (auto it = forward_factors_.find(pair); it != forward_factors_.end()) {
+            factors = it->second;
+        }
+    }
+    if (factors == nullptr || factors->version != version_ || factors->today != Today()
+        || factors->spot_date != ctx_.SpotDate(pair)
+        || !std::equal(dates.begin(), dates.end(), factors->dates.begin(), factors->dates.end())) {
+        return nullptr;
+    }
+    return factors;
+}
 
 }  // namespace cdr
@@ -2,17 +2,141 @@
 
 #include <cdr/model/internal/export.h>
 #include <cdr/base/check.h>
+#include <cdr/base/thread_pool.h>
 #include <cdr/types/types.h>
+#include <cdr/types/errors.h>
+#include <cdr/types/expect.h>
 #include <cdr/calendar/date.h>
 #include <cdr/market/context.h>
 #include <cdr/fx/fx.h>
 #include <cdr/curve/curve.h>
 #include <cdr/swaps/irs.h>
 
+#include <atomic>
+#include <chrono>
+#include <initializer_list>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace cdr {
 
+// Inputs of a curve that changed since it was last built
+enum class CurveChange : u8 {
+    // Never built
+    kNew = 0,
+    // SetSwaps of a main curve
+    kSwaps,
+    // SetForwards of a dependent curve
+    kForwards,
+    // Spot of a pair of its forwards
+    kFxSpot,
+    kToday,
+    // Its main curve was rebuilt or replaced, or the dependency was added
+    kMain,
+    __NumberOfChanges,
+};
+
+class CDR_MODEL_EXPORT CurveChanges {
+public:
+    CurveChanges() = default;
+    CurveChanges(std::initializer_list<CurveChange> changes) noexcept {
+        for (auto change : changes) {
+            Set(change);
+        }
+    }
+
+    void Set(CurveChange change) noexcept {
+        bits_ |= Bit(change);
+    }
+
+    void Reset(CurveChange change) noexcept {
+        bits_ &= static_cast<u8>(~Bit(change));
+    }
+
+    [[nodiscard]] bool Has(CurveChange change) const noexcept {
+        return (bits_ & Bit(change)) != 0;
+    }
+
+    [[nodiscard]] bool Any() const noexcept {
+        return bits_ != 0;
+    }
+
+    CurveChanges& operator|=(CurveChanges other) noexcept {
+        bits_ |= other.bits_;
+        return *this;
+    }
+
+    bool operator==(const CurveChanges&) const = default;
+
+    // Comma separated, e.g. "swaps,today"
+    [[nodiscard]] std::string ToString() const;
+
+private:
+    [[nodiscard]] static u8 Bit(CurveChange change) noexcept {
+        return static_cast<u8>(1u << static_cast<u8>(change));
+    }
+
+private:
+    u8 bits_ = 0;
+};
+
+struct CurveBuildTiming {
+    JurisdictionType jur;
+    // Curve it was built from, empty for main curves
+    JurisdictionType main;
+    // From the start of the whole build to the start of this curve
+    std::chrono::nanoseconds start{0};
+    std::chrono::nanoseconds elapsed{0};
+    // Set if the curve was not built, the previous one is kept then
+    std::optional<Error> error;
+    // Why the curve was built, empty if nothing changed
+    CurveChanges changes;
+};
+
+struct CDR_MODEL_EXPORT CurveBuildReport {
+    // Main curves first, each dependent after its main
+    std::vector<CurveBuildTiming> curves;
+    std::chrono::nanoseconds elapsed{0};
+
+    [[nodiscard]] bool Succeed() const noexcept;
+
+    // Sum of the curve build times, compare with `elapsed`
+    [[nodiscard]] std::chrono::nanoseconds BuildTime() const noexcept;
+
+    void Write(std::ostream& out) const;
+};
+
+// Derivatives of one forward price with respect to the market inputs of
+// the curves it is priced on, see Model::ForwardPriceSensitivities
+struct CDR_MODEL_EXPORT ForwardSensitivities {
+    struct SpotSensitivity {
+        f64 spot = 0.;
+        f64 derivative = 0.;
+    };
+
+    f64 price = 0.;
+    // Per swap of a main curve, in SetSwaps order, to the fixed rate as a fraction
+    std::map<JurisdictionType, std::vector<f64>> swaps;
+    // Per forward of a dependent curve, in SetForwards order, to its price
+    std::map<JurisdictionType, std::vector<f64>> forwards;
+    // By pair in one direction, the lesser of the two FXPairKeys
+    std::map<FXPairKey, SpotSensitivity> spots;
+    // Per pillar of curves not built by the model (added with AddCurve), to
+    // the zero rate as a fraction
+    std::map<JurisdictionType, std::map<DateType, f64>> pillars;
+
+    // Derivative to the spot of `pair` as quoted, 0 if the price doesn't depend on it
+    [[nodiscard]] f64 SpotDerivative(FXPairKey pair) const noexcept;
+};
+
 class CDR_MODEL_EXPORT Model {
 public:
     // main -> dependent
@@ -33,11 +157,23 @@ public:
     }
 
     // returns nullptr is curve is not present
+    // With lazy curves a missing curve is built first, see SetLazyCurves
     [[nodiscard]] const Curve* GetCurve(const JurisdictionType& jur) const noexcept;
     // returns nullptr is curve is not present
+    // Mutable access counts as a change of the model, see Version()
     [[nodiscard]] Curve* GetCurve(const JurisdictionType& jur) noexcept;
 
+    // Lazy curves are built by the first GetCurve asking for them or for a
+    // curve depending on them, as BuildMainCurve and BuildDependentCurve
+    // would build them, so only curves in use are ever built. Lookups and
+    // the builds they trigger are safe from many threads at once and build a
+    // curve once; changing the model still needs exclusive access.
+    void SetLazyCurves(bool lazy) noexcept {
+        lazy_ = lazy;
+    }
+
     // insert or assign curve to the model
+    // The curve counts as built from the current inputs, its dependents as changed
     void AddCurve(std::unique_ptr<Curve>&& curve);
     void AddDependency(const JurisdictionType& main, const JurisdictionType& dependent);
     void SetSwaps(JurisdictionType jur, std::vector<IrsContract>&& swaps) noexcept;
@@ -47,23 +183,158 @@ public:
     [[nodiscard]] Expect<void, Error> BuildDependentCurve(JurisdictionType main_jur,
                                                           JurisdictionType dependent_jur) noexcept;
 
+    // Builds every curve known to the model on `pool`: main curves from
+    // their swaps, dependent curves from their main curve and forwards, as
+    // recorded by AddDependency. Main curves bootstrap concurrently and a
+    // dependent curve starts as soon as its main curve is built; chains of
+    // dependencies are followed. Curves are installed once all builds are
+    // done, so readers of the model never see half of a build.
+    //
+    // Fails with Error::InvalidInput, building nothing, if a curve depends on
+    // more than one curve or dependencies form a cycle. Curves that fail to
+    // build, or depend on such a curve, are reported with their error.
+    // Curves are reported with their changes, see Recalculate.
+    [[nodiscard]] Expect<CurveBuildReport, Error> BuildAll(ThreadPool& pool);
+
+    // BuildAll restricted to curves whose inputs changed since they were
+    // last built, and their dependents. Changes are tracked for curves with
+    // swaps or dependencies: SetSwaps, SetForwards, AddDependency, AddCurve
+    // of a main curve, a new today and moves of the FX spots a dependent
+    // curve was built with. The report lists rebuilt curves only, each with
+    // the reasons. Curves that fail to build stay pending.
+    [[nodiscard]] Expect<CurveBuildReport, Error> Recalculate(ThreadPool& pool);
+
+    // What the next Recalculate rebuilds and why
+    [[nodiscard]] Expect<std::map<JurisdictionType, CurveChanges>, Error> PendingChanges() const;
 
+
+    // Spot carried from the pair's spot date to `trade_date`
     [[nodiscard]] f64 ForwardPrice(const FXPair& pair, const DateType& trade_date) const noexcept;
 
+    // ForwardPrice and its derivatives with respect to every swap quote,
+    // forward quote and FX spot behind it, from one backward sweep through
+    // pricing, dependent curve construction and bootstrapping. Bootstrapped
+    // pillars solve NPV(pillars, quote) = 0 swap by swap, so their adjoints
+    // come from one triangular solve with the Jacobian of those NPVs. The
+    // Jacobian is exact: the NPVs are evaluated on jets seeded per pillar of
+    // the bootstrapped curve, so nothing is bumped or rebuilt.
+    //
+    // Curves must be built from the current inputs, see PendingChanges; fails
+    // with Error::InvalidInput otherwise, or if swaps of a curve settle on the
+    // same day, and with Error::NoData if a curve is missing.
+    [[nodiscard]] Expect<ForwardSensitivities, Error> ForwardPriceSensitivities(const FXPair& pair,
+                                                                                const DateType& trade_date) const;
+
+    // ForwardPrice for every date of `dates`, which must be increasing and
+    // not before today. Forward factors DF(base) / DF(quote) take one pillar
+    // walk per curve and one exp per date; they are cached per pair and grid
+    // until Version() changes, and the current spot is applied on each call.
+    [[nodiscard]] Expect<void, Error> ForwardPrices(const FXPair& pair, std::span<const DateType> dates,
+                                                    std::span<f64> prices) const;
+
+    // Changes whenever curves may have changed
+    [[nodiscard]] u64 Version() const noexcept {
+        return version_.load(std::memory_order_acquire);
+    }
+
+    // Rolled curves count as built for the new today, see Recalculate
     void OnNextDay() noexcept {
         for (auto& [jur, curve] : curves_) {
             if (ctx_.Calendar().IsBusinessDay(jur, ctx_.Today())) {
                 curve->RollForward();
             }
         }
+        for (auto& [jur, state] : curve_states_) {
+            if (curves_.contains(jur)) {
+                state.today = ctx_.Today();
+            }
+        }
+        ++version_;
     }
 
+    // OnNextDay for any number of days at once: every curve rolls by the
+    // business days of its jurisdiction after the today it was built or last
+    // rolled for, up to the current one, in one pass over its pillars. Gives
+    // the pillars of calling OnNextDay after each of those days.
+    void RollToToday() noexcept;
+
 private:
-    std::map<JurisdictionType, std::vector<IrsContract>> swaps_;
+    // Curves with swaps or dependencies, mains before their dependents
+    struct CurveOrder {
+        static constexpr u64 kNoMain = ~u64{0};
+
+        std::vector<JurisdictionType> jurs;
+        std::vector<u64> main_of;
+        std::vector<std::vector<u64>> dependents_of;
+    };
+
+    // Inputs a curve was last built with
+    struct CurveState {
+        bool built = false;
+        DateType today;
+        std::vector<std::pair<FXPairKey, std::optional<f64>>> spots;
+        CurveChanges pending;
+    };
+
+    [[nodiscard]] Expect<CurveOrder, Error> OrderCurves() const;
+    [[nodiscard]] std::vector<CurveChanges> Changes(const CurveOrder& order) const;
+    // Builds the curves of `order` with a set `selected` flag, the others
+    // are taken as they are
+    [[nodiscard]] CurveBuildReport BuildCurves(ThreadPool& pool, const CurveOrder& order,
+                                               const std::vector<bool>& selected,
+                                               std::vector<CurveChanges> changes);
+
+    // Curve of a lazy lookup, built with its main curves if missing; the
+    // unique lock of curves_mutex_ must be held
+    [[nodiscard]] const Curve* FindOrBuildLocked(const JurisdictionType& jur, u64 depth) const;
+
+    [[nodiscard]] std::unique_ptr<Curve> MakeMainCurve(const JurisdictionType& jur) const;
+    [[nodiscard]] std::unique_ptr<Curve> MakeDependentCurve(const Curve& main, const JurisdictionType& jur) const;
+    [[nodiscard]] std::vector<std::pair<FXPairKey, std::optional<f64>>> ForwardSpots(const JurisdictionType& jur) const;
+
+    using PillarAdjoints = std::map<DateType, f64>;
+
+    // Carry pillar adjoints of a curve back to its inputs
+    [[nodiscard]] Expect<void, Error> MainCurveAdjoint(const Curve& curve, const PillarAdjoints& adjoints,
+                                                       std::vector<f64>& swap_adjoints) const;
+    [[nodiscard]] Expect<void, Error> DependentCurveAdjoint(const Curve& curve, const Curve& main,
+                                                            const PillarAdjoints& adjoints,
+                                                            PillarAdjoints& main_adjoints,
+                                                            std::map<FXPairKey, f64>& spot_adjoints,
+                                                            std::vector<f64>& forward_adjoints) const;
+
+    // Installs a built curve and records what it was built with
+    void Install(std::unique_ptr<Curve>&& curve,
+                 std::vector<std::pair<FXPairKey, std::optional<f64>>> spots = {}) const;
+    void MarkDependents(const JurisdictionType& main) const;
+
+    struct ForwardFactors {
+        u64 version = 0;
+        DateType today;
+        DateType spot_date;
+        std::vector<DateType> dates;
+        std::vector<f64> factors;
+    };
+
+    [[nodiscard]] std::shared_ptr<const ForwardFactors> FindForwardFactors(FXPairKey pair,
+                                                                           std::span<const DateType> dates) const;
+
+private:
+    // Curves, their states and the swaps bootstrapping adapts change under
+    // const lookups of lazy curves
+    mutable std::map<JurisdictionType, std::vector<IrsContract>> swaps_;
     std::map<JurisdictionType, std::vector<ForwardContract>> forwards_;
-    CurveStorage curves_;
+    mutable CurveStorage curves_;
     DependencyGraph curve_deps_;
+    mutable std::map<JurisdictionType, CurveState> curve_states_;
     MarketContextView ctx_;
+    mutable std::atomic<u64> version_ = 0;
+
+    bool lazy_ = false;
+    mutable std::shared_mutex curves_mutex_;
+
+    mutable std::mutex forward_factors_mutex_;
+    mutable std::unordered_map<FXPairKey, std::shared_ptr<const ForwardFactors>> forward_factors_;
 };
 
 }  // namespace cdr
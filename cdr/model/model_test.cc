@@ -6,8 +6,61 @@
 #include <cdr/market/context.h>
 #include <cdr/calendar/holiday_storage.h>
 #include <cdr/swaps/irs.h>
+#include <cdr/base/thread_pool.h>
+#include <cdr/fx/fx.h>
+
+#include <map>
+#include <sstream>
+#include <thread>
 
 #include <chrono>
+#include <vector>
+
+namespace {
+
+std::vector<cdr::IrsContract> MakeSwaps(const cdr::MarketContext& context, const JurisdictionType& jur,
+                                        const std::vector<std::pair<int, f64>>& quotes) {
+    std::vector<cdr::IrsContract> swaps;
+    for (const auto& [months, rate] : quotes) {
+        swaps.push_back(cdr::IrsBuilderExperimental()
+            .Adjustment(cdr::Percent::Zero())
+            .FixedFreq({std::min(months, 12), cdr::TimeUnit::Month})
+            .FloatFreq({std::min(months, 3), cdr::TimeUnit::Month})
+            .FixedTerm({months, cdr::TimeUnit::Month})
+            .FloatTerm({months, cdr::TimeUnit::Month})
+            .FixedRate(cdr::Percent::FromPercentage(rate))
+            .Notion(1'000'000)
+            .PayFix(false)
+            .PaymentDateShift(2)
+            .StartShift(2)
+            .Stub(cdr::IrsContract::Stub::SHORT)
+            .TradeDate(context.Today())
+            .Build(context.Calendar(), jur, cdr::DateRollingRule::kModifiedFollowing)
+        );
+    }
+    return swaps;
+}
+
+std::vector<cdr::ForwardContract> MakeForwards(const cdr::MarketContext& context, const cdr::FXPair& pair,
+                                               const std::vector<std::pair<int, f64>>& quotes) {
+    std::vector<cdr::ForwardContract> forwards;
+    for (const auto& [months, price] : quotes) {
+        forwards.emplace_back(pair, context.Today(), cdr::Tenor{months, cdr::TimeUnit::Month}, price);
+    }
+    return forwards;
+}
+
+// USD and GBP from swaps, EUR from USD, JPY from EUR
+void SetUpCurves(const cdr::MarketContext& context, cdr::Model& model) {
+    model.SetSwaps("USD", MakeSwaps(context, "USD", {{12, 4.40}, {24, 4.10}, {60, 3.80}}));
+    model.SetSwaps("GBP", MakeSwaps(context, "GBP", {{12, 4.00}, {60, 3.60}}));
+    model.SetForwards("EUR", MakeForwards(context, {"EUR", "USD"}, {{3, 1.105}, {12, 1.12}}));
+    model.SetForwards("JPY", MakeForwards(context, {"EUR", "JPY"}, {{6, 158.}, {24, 150.}}));
+    model.AddDependency("USD", "EUR");
+    model.AddDependency("EUR", "JPY");
+}
+
+}  // anonymous namespace
 
 TEST(Model, Basic) {
     using namespace std::chrono;
@@ -36,3 +89,374 @@ TEST(Model, Basic) {
     ASSERT_NE(curve, nullptr);
     ASSERT_TRUE(curve->Pillars().empty());
 }
+
+TEST(Model, BatchForwardPrices) {
+    using namespace std::chrono;
+
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("USD", year(2027) / January / day(18))
+        ("EUR", year(2027) / April / day(2))
+    ;
+    cdr::MarketContext context(std::move(holiday_storage), day(4)/January/year(2027));
+    context.SetFxSpot({"EUR", "USD"}, 1.10);
+
+    cdr::Model model(context);
+    model.AddCurve(cdr::CurveBuilder(context)
+        .Jurisdiction("USD")
+        .Add(day(4)/April/year(2027), cdr::Percent::FromPercentage(4.40))
+        .Add(day(4)/January/year(2028), cdr::Percent::FromPercentage(4.10))
+        .Add(day(4)/January/year(2030), cdr::Percent::FromPercentage(3.80))
+        .FromPoints());
+    model.AddCurve(cdr::CurveBuilder(context)
+        .Jurisdiction("EUR")
+        .Add(day(4)/July/year(2027), cdr::Percent::FromPercentage(2.50))
+        .Add(day(4)/January/year(2029), cdr::Percent::FromPercentage(2.30))
+        .FromPoints());
+
+    std::vector<cdr::DateType> dates;
+    for (cdr::DateType date = day(4)/January/year(2027); date < day(4)/January/year(2031); date = cdr::NextDay(date)) {
+        dates.push_back(date);
+    }
+
+    const cdr::FXPair pair("EUR", "USD");
+    std::vector<f64> prices(dates.size());
+    ASSERT_TRUE(model.ForwardPrices(pair, dates, prices).Succeed());
+    for (u64 i = 0; i < dates.size(); ++i) {
+        EXPECT_NEAR(prices[i], model.ForwardPrice(pair, dates[i]), 1e-12) << i;
+    }
+
+    // Cached factors follow the spot
+    context.SetFxSpot({"EUR", "USD"}, 1.20);
+    const u64 version = model.Version();
+    std::vector<f64> repriced(dates.size());
+    ASSERT_TRUE(model.ForwardPrices(pair, dates, repriced).Succeed());
+    ASSERT_EQ(model.Version(), version);
+    for (u64 i = 0; i < dates.size(); ++i) {
+        EXPECT_NEAR(repriced[i], model.ForwardPrice(pair, dates[i]), 1e-12) << i;
+    }
+
+    // A new curve invalidates them
+    model.AddCurve(cdr::CurveBuilder(context)
+        .Jurisdiction("EUR")
+        .Add(day(4)/July/year(2027), cdr::Percent::FromPercentage(3.00))
+        .FromPoints());
+    ASSERT_NE(model.Version(), version);
+    ASSERT_TRUE(model.ForwardPrices(pair, dates, repriced).Succeed());
+    EXPECT_NEAR(repriced.back(), model.ForwardPrice(pair, dates.back()), 1e-12);
+
+    const std::vector<cdr::DateType> past = {day(3)/January/year(2027)};
+    ASSERT_TRUE(model.ForwardPrices(pair, past, prices).Failed());
+    ASSERT_TRUE(model.ForwardPrices({"EUR", "JPY"}, dates, prices).Failed());
+}
+
+TEST(Model, BuildAll) {
+    using namespace std::chrono;
+
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("USD", year(2027) / January / day(18))
+        ("EUR", year(2027) / April / day(2))
+        ("GBP", year(2027) / May / day(3))
+        ("JPY", year(2027) / January / day(11))
+    ;
+    cdr::MarketContext context(std::move(holiday_storage), day(4)/January/year(2027));
+    context.SetFxSpot({"EUR", "USD"}, 1.10);
+    context.SetFxSpot({"EUR", "JPY"}, 160.);
+
+    // Built by hand in dependency order
+    cdr::Model expected(context);
+    SetUpCurves(context, expected);
+    ASSERT_TRUE(expected.BuildMainCurve("USD").Succeed());
+    ASSERT_TRUE(expected.BuildMainCurve("GBP").Succeed());
+    ASSERT_TRUE(expected.BuildDependentCurve("USD", "EUR").Succeed());
+    ASSERT_TRUE(expected.BuildDependentCurve("EUR", "JPY").Succeed());
+
+    for (u32 concurrency : {1u, 4u}) {
+        cdr::ThreadPool pool(concurrency);
+        cdr::Model model(context);
+        SetUpCurves(context, model);
+
+        auto report = model.BuildAll(pool);
+        ASSERT_TRUE(report.Succeed());
+        ASSERT_TRUE(report.Value().Succeed());
+
+        const auto& curves = report.Value().curves;
+        ASSERT_EQ(curves.size(), 4);
+        ASSERT_EQ(curves[0].jur, "GBP");
+        ASSERT_EQ(curves[1].jur, "USD");
+        ASSERT_EQ(curves[2].jur, "EUR");
+        ASSERT_EQ(curves[2].main, "USD");
+        ASSERT_EQ(curves[3].jur, "JPY");
+        ASSERT_EQ(curves[3].main, "EUR");
+        // Dependents start after their main is done
+        ASSERT_GE(curves[2].start, curves[1].start + curves[1].elapsed);
+        ASSERT_GE(curves[3].start, curves[2].start + curves[2].elapsed);
+
+        for (const auto& jur : {"USD", "GBP", "EUR", "JPY"}) {
+            const auto* built = model.GetCurve(jur);
+            ASSERT_NE(built, nullptr) << jur;
+            ASSERT_FALSE(built->Pillars().empty()) << jur;
+            ASSERT_EQ(built->Pillars(), expected.GetCurve(jur)->Pillars()) << jur;
+        }
+
+        std::ostringstream out;
+        report.Value().Write(out);
+        ASSERT_NE(out.str().find("JPY"), std::string::npos);
+    }
+
+    // A curve can't depend on two curves, or on itself through a cycle
+    cdr::ThreadPool pool(2);
+    cdr::Model two_mains(context);
+    SetUpCurves(context, two_mains);
+    two_mains.AddDependency("GBP", "EUR");
+    ASSERT_EQ(two_mains.BuildAll(pool).GetFailure(), cdr::Error::InvalidInput);
+    ASSERT_EQ(two_mains.GetCurve("USD"), nullptr);
+
+    cdr::Model cycle(context);
+    cycle.AddDependency("EUR", "JPY");
+    cycle.AddDependency("JPY", "EUR");
+    ASSERT_EQ(cycle.BuildAll(pool).GetFailure(), cdr::Error::InvalidInput);
+}
+
+TEST(Model, Recalculate) {
+    using namespace std::chrono;
+
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("USD", year(2027) / January / day(18))
+        ("EUR", year(2027) / April / day(2))
+        ("GBP", year(2027) / May / day(3))
+        ("JPY", year(2027) / January / day(11))
+    ;
+    cdr::MarketContext context(std::move(holiday_storage), day(4)/January/year(2027));
+    context.SetFxSpot({"EUR", "USD"}, 1.10);
+    context.SetFxSpot({"EUR", "JPY"}, 160.);
+
+    cdr::ThreadPool pool(2);
+    cdr::Model model(context);
+    SetUpCurves(context, model);
+
+    const auto rebuilt = [&] {
+        auto report = model.Recalculate(pool);
+        EXPECT_TRUE(report.Succeed());
+        EXPECT_TRUE(report.Value().Succeed());
+        std::map<JurisdictionType, cdr::CurveChanges> changes;
+        for (const auto& curve : report.Value().curves) {
+            changes.emplace(curve.jur, curve.changes);
+        }
+        return changes;
+    };
+    using cdr::CurveChange;
+    using Changes = std::map<JurisdictionType, cdr::CurveChanges>;
+
+    const cdr::CurveChanges added = {CurveChange::kNew};
+    ASSERT_EQ(model.PendingChanges().Value(), (Changes{{"USD", added}, {"GBP", added}, {"EUR", added}, {"JPY", added}}));
+    ASSERT_EQ(rebuilt().size(), 4);
+    ASSERT_TRUE(model.PendingChanges().Value().empty());
+    ASSERT_TRUE(rebuilt().empty());
+
+    // New swaps rebuild the curve and everything built from it
+    const auto* gbp = model.GetCurve("GBP");
+    const auto usd_pillars = model.GetCurve("USD")->Pillars();
+    model.SetSwaps("USD", MakeSwaps(context, "USD", {{12, 4.50}, {60, 3.90}}));
+    ASSERT_EQ(rebuilt(), (Changes{{"USD", {CurveChange::kSwaps}},
+                                  {"EUR", {CurveChange::kMain}},
+                                  {"JPY", {CurveChange::kMain}}}));
+    ASSERT_EQ(model.GetCurve("GBP"), gbp);
+    ASSERT_NE(model.GetCurve("USD")->Pillars(), usd_pillars);
+
+    // A spot moves only the curves built on it
+    context.SetFxSpot({"EUR", "JPY"}, 161.);
+    ASSERT_EQ(rebuilt(), (Changes{{"JPY", {CurveChange::kFxSpot}}}));
+    context.SetFxSpot({"USD", "EUR"}, 1. / 1.12);
+    model.SetForwards("JPY", MakeForwards(context, {"EUR", "JPY"}, {{12, 155.}}));
+    ASSERT_EQ(rebuilt(), (Changes{{"EUR", {CurveChange::kFxSpot}},
+                                  {"JPY", {CurveChange::kForwards, CurveChange::kMain}}}));
+
+    // Curves replaced by hand or built on their own count as changes too
+    ASSERT_TRUE(model.BuildMainCurve("GBP").Succeed());
+    ASSERT_TRUE(rebuilt().empty());
+    model.AddCurve(cdr::CurveBuilder(context)
+        .Jurisdiction("EUR")
+        .Add(day(4)/July/year(2027), cdr::Percent::FromPercentage(3.00))
+        .FromPoints());
+    ASSERT_EQ(rebuilt(), (Changes{{"JPY", {CurveChange::kMain}}}));
+
+    // And so does a new today, for every curve
+    context.SetToday(day(5)/January/year(2027));
+    const auto pending = model.PendingChanges().Value();
+    ASSERT_EQ(pending.size(), 4);
+    ASSERT_EQ(pending.at("GBP"), cdr::CurveChanges{CurveChange::kToday});
+    ASSERT_EQ(pending.at("JPY"), (cdr::CurveChanges{CurveChange::kToday, CurveChange::kMain}));
+    ASSERT_EQ(pending.at("JPY").ToString(), "today,main");
+    ASSERT_EQ(rebuilt().size(), 4);
+    ASSERT_TRUE(rebuilt().empty());
+}
+
+TEST(Model, ForwardPriceSensitivities) {
+    using namespace std::chrono;
+
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("USD", year(2027) / January / day(18))
+        ("EUR", year(2027) / April / day(2))
+        ("GBP", year(2027) / May / day(3))
+        ("JPY", year(2027) / January / day(11))
+    ;
+    cdr::MarketContext context(std::move(holiday_storage), day(4)/January/year(2027));
+    context.SetFxSpot({"EUR", "USD"}, 1.10);
+    context.SetFxSpot({"EUR", "JPY"}, 160.);
+
+    // JPY is built from EUR, which is built from USD. USD has more pillars
+    // than one jet of the bootstrap Jacobian carries.
+    std::vector<std::pair<int, f64>> usd = {{12, 4.40}, {24, 4.10}, {36, 3.95}, {48, 3.85}, {60, 3.80},
+                                            {72, 3.76}, {84, 3.73}, {96, 3.71}, {108, 3.70}, {120, 3.70}};
+    std::vector<std::pair<int, f64>> eur = {{3, 1.105}, {12, 1.12}};
+    std::vector<std::pair<int, f64>> jpy = {{6, 158.}, {24, 150.}};
+    cdr::FXPair pair("EUR", "JPY");
+    const cdr::DateType date = day(4)/October/year(2035);
+
+    cdr::ThreadPool pool(1);
+    const auto price = [&] {
+        cdr::Model model(context);
+        model.SetSwaps("USD", MakeSwaps(context, "USD", usd));
+        model.SetForwards("EUR", MakeForwards(context, {"EUR", "USD"}, eur));
+        model.SetForwards("JPY", MakeForwards(context, {"EUR", "JPY"}, jpy));
+        model.AddDependency("USD", "EUR");
+        model.AddDependency("EUR", "JPY");
+        EXPECT_TRUE(model.BuildAll(pool).Value().Succeed());
+        return model.ForwardPrice(pair, date);
+    };
+    const auto bumped = [&](f64& input, f64 bump) {
+        const f64 value = input;
+        input = value + bump;
+        const f64 up = price();
+        input = value - bump;
+        const f64 down = price();
+        input = value;
+        return (up - down) / (2. * bump);
+    };
+
+    cdr::Model model(context);
+    model.SetSwaps("USD", MakeSwaps(context, "USD", usd));
+    model.SetSwaps("GBP", MakeSwaps(context, "GBP", {{12, 4.00}}));
+    model.SetForwards("EUR", MakeForwards(context, {"EUR", "USD"}, eur));
+    model.SetForwards("JPY", MakeForwards(context, {"EUR", "JPY"}, jpy));
+    model.AddDependency("USD", "EUR");
+    model.AddDependency("EUR", "JPY");
+    ASSERT_TRUE(model.BuildAll(pool).Value().Succeed());
+
+    const auto spot_derivative = [&](const cdr::FXPair& spot_pair, f64 bump) {
+        const f64 value = context.FxSpot(spot_pair);
+        context.SetFxSpot(spot_pair, value + bump);
+        const f64 up = price();
+        context.SetFxSpot(spot_pair, value - bump);
+        const f64 down = price();
+        context.SetFxSpot(spot_pair, value);
+        return (up - down) / (2. * bump);
+    };
+    const auto at = [](const std::map<JurisdictionType, std::vector<f64>>& derivatives,
+                       const JurisdictionType& jur, u64 i) {
+        auto it = derivatives.find(jur);
+        return it == derivatives.end() ? 0. : it->second.at(i);
+    };
+
+    // EUR/USD reads USD directly and through EUR, EUR/JPY only through the
+    // spot date rates of EUR and JPY, which move together
+    for (const auto& priced : {cdr::FXPair("EUR", "USD"), cdr::FXPair("EUR", "JPY")}) {
+        pair = priced;
+        auto sensitivities = model.ForwardPriceSensitivities(pair, date);
+        ASSERT_TRUE(sensitivities.Succeed());
+        const auto& result = sensitivities.Value();
+        ASSERT_NEAR(result.price, model.ForwardPrice(pair, date), 1e-9);
+        ASSERT_FALSE(result.swaps.contains("GBP"));
+        ASSERT_TRUE(result.pillars.empty());
+
+        // Against bump and rebuild, swap quotes in percent
+        for (u64 i = 0; i < usd.size(); ++i) {
+            const f64 expected = bumped(usd[i].second, 1e-4) * 100.;
+            EXPECT_NEAR(at(result.swaps, "USD", i), expected, 1e-4 * std::max(1., std::abs(expected))) << i;
+        }
+        for (u64 i = 0; i < eur.size(); ++i) {
+            const f64 expected = bumped(eur[i].second, 1e-6);
+            EXPECT_NEAR(at(result.forwards, "EUR", i), expected, 1e-4 * std::max(1., std::abs(expected))) << i;
+        }
+        for (u64 i = 0; i < jpy.size(); ++i) {
+            const f64 expected = bumped(jpy[i].second, 1e-4);
+            EXPECT_NEAR(at(result.forwards, "JPY", i), expected, 1e-4 * std::max(1., std::abs(expected))) << i;
+        }
+        for (const auto& spot_pair : {cdr::FXPair("EUR", "USD"), cdr::FXPair("USD", "EUR"),
+                                      cdr::FXPair("EUR", "JPY"), cdr::FXPair("JPY", "EUR")}) {
+            const f64 expected = spot_derivative(spot_pair, context.FxSpot(spot_pair) * 1e-6);
+            EXPECT_NEAR(result.SpotDerivative(spot_pair.Key()), expected, 1e-4 * std::max(1., std::abs(expected)))
+                << spot_pair.first << spot_pair.second;
+        }
+        ASSERT_EQ(result.SpotDerivative(cdr::FXPairKey::Pack("GBP", "USD")), 0.);
+    }
+    ASSERT_NE(at(model.ForwardPriceSensitivities({"EUR", "USD"}, date).Value().swaps, "USD", 1), 0.);
+    ASSERT_NE(at(model.ForwardPriceSensitivities({"EUR", "USD"}, date).Value().swaps, "USD", 8), 0.);
+
+    // Curves must be current
+    context.SetFxSpot({"EUR", "USD"}, 1.11);
+    ASSERT_EQ(model.ForwardPriceSensitivities(pair, date).GetFailure(), cdr::Error::InvalidInput);
+    ASSERT_TRUE(model.Recalculate(pool).Succeed());
+    ASSERT_TRUE(model.ForwardPriceSensitivities(pair, date).Succeed());
+    ASSERT_EQ(model.ForwardPriceSensitivities({"EUR", "CHF"}, date).GetFailure(), cdr::Error::NoData);
+}
+
+TEST(Model, LazyCurves) {
+    using namespace std::chrono;
+
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("USD", year(2027) / January / day(18))
+        ("EUR", year(2027) / April / day(2))
+        ("GBP", year(2027) / May / day(3))
+        ("JPY", year(2027) / January / day(11))
+    ;
+    cdr::MarketContext context(std::move(holiday_storage), day(4)/January/year(2027));
+    context.SetFxSpot({"EUR", "USD"}, 1.10);
+    context.SetFxSpot({"EUR", "JPY"}, 160.);
+
+    cdr::ThreadPool pool(1);
+    cdr::Model eager(context);
+    SetUpCurves(context, eager);
+    ASSERT_TRUE(eager.BuildAll(pool).Value().Succeed());
+    ASSERT_EQ(std::as_const(eager).GetCurve("CHF"), nullptr);
+
+    cdr::Model model(context);
+    SetUpCurves(context, model);
+    ASSERT_EQ(std::as_const(model).GetCurve("USD"), nullptr);
+    model.SetLazyCurves(true);
+    const auto& lazy = model;
+
+    // The first lookup of a dependent builds the chain it depends on only
+    const cdr::Curve* jpy = lazy.GetCurve("JPY");
+    ASSERT_NE(jpy, nullptr);
+    ASSERT_EQ(jpy->Pillars(), eager.GetCurve("JPY")->Pillars());
+    const auto pending = model.PendingChanges().Value();
+    ASSERT_EQ(pending.size(), 1);
+    ASSERT_TRUE(pending.at("GBP").Has(cdr::CurveChange::kNew));
+    ASSERT_EQ(lazy.GetCurve("JPY"), jpy);
+    ASSERT_EQ(lazy.GetCurve("CHF"), nullptr);
+
+    // Concurrent lookups build a curve once
+    std::vector<const cdr::Curve*> found(8, nullptr);
+    std::vector<std::thread> threads;
+    for (u64 i = 0; i < found.size(); ++i) {
+        threads.emplace_back([&, i] {
+            found[i] = lazy.GetCurve("GBP");
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_NE(found.front(), nullptr);
+    ASSERT_TRUE(std::ranges::all_of(found, [&](const auto* curve) { return curve == found.front(); }));
+    ASSERT_EQ(found.front()->Pillars(), eager.GetCurve("GBP")->Pillars());
+    ASSERT_TRUE(model.PendingChanges().Value().empty());
+
+    const cdr::DateType date = day(4)/October/year(2027);
+    ASSERT_DOUBLE_EQ(model.ForwardPrice({"EUR", "JPY"}, date), eager.ForwardPrice({"EUR", "JPY"}, date));
+}
@@ -0,0 +1,566 @@
+#include <cdr/model/replay.h>
+
+#include <cdr/base/check.h>
+#include <cdr/base/mapped_file.h>
+#include <cdr/swaps/irs.h>
+#include <cdr/types/percent.h>
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace cdr {
+
+namespace {
+
+template <typename T>
+[[nodiscard]] bool ParseNumber(std::string_view field, T& value) noexcept {
+    const char* end = field.data() + field.size();
+    const auto [ptr, ec] = std::from_chars(field.data(), end, value);
+    return ec == std::errc() && ptr == end;
+}
+
+// yyyy-mm-dd
+[[nodiscard]] bool ParseDate(std::string_view field, DateType& date) noexcept {
+    i32 y = 0;
+    u32 m = 0;
+    u32 d = 0;
+    if (field.size() != 10 || field[4] != '-' || field[7] != '-') {
+        return false;
+    }
+    if (!ParseNumber(field.substr(0, 4), y) || !ParseNumber(field.substr(5, 2), m)
+        || !ParseNumber(field.substr(8, 2), d)) {
+        return false;
+    }
+    date = std::chrono::year(y) / std::chrono::month(m) / std::chrono::day(d);
+    return date.ok();
+}
+
+[[nodiscard]] bool ParseCode(std::string_view field, u32& code) {
+    if (field.empty() || field.size() > 4) {
+        return false;
+    }
+    code = FXPairKey::PackCode(field);
+    return true;
+}
+
+[[nodiscard]] bool ParseTick(std::string_view line, MarketTick& tick) {
+    std::array<std::string_view, 8> fields;
+    u64 size = 0;
+    while (size < fields.size()) {
+        const u64 comma = line.find(',');
+        fields[size++] = line.substr(0, comma);
+        if (comma == std::string_view::npos) {
+            line = {};
+            break;
+        }
+        line.remove_prefix(comma + 1);
+    }
+    if (!line.empty() || size < 3 || !ParseNumber(fields[0], tick.timestamp_ns)) {
+        return false;
+    }
+
+    const std::string_view kind = fields[1];
+    u32 base = 0;
+    u32 quote = 0;
+    if (kind == "today" && size == 3) {
+        tick.kind = TickKind::kToday;
+        return ParseDate(fields[2], tick.date);
+    }
+    if (kind == "spot" && size == 5) {
+        tick.kind = TickKind::kFxSpot;
+        if (!ParseCode(fields[2], base) || !ParseCode(fields[3], quote)) {
+            return false;
+        }
+        tick.pair = FXPairKey::FromCodes(base, quote);
+        return ParseNumber(fields[4], tick.value) && tick.value > 0.;
+    }
+    if (kind == "swap" && size == 5) {
+        tick.kind = TickKind::kSwapQuote;
+        return ParseCode(fields[2], tick.currency)
+            && ParseNumber(fields[3], tick.tenor_months) && tick.tenor_months > 0
+            && ParseNumber(fields[4], tick.value);
+    }
+    if (kind == "vol" && size == 7) {
+        tick.kind = TickKind::kVolPillar;
+        if (!ParseCode(fields[2], base) || !ParseCode(fields[3], quote)) {
+            return false;
+        }
+        tick.pair = FXPairKey::FromCodes(base, quote);
+        return ParseDate(fields[4], tick.date)
+            && ParseNumber(fields[5], tick.strike) && tick.strike > 0.
+            && ParseNumber(fields[6], tick.value) && tick.value > 0.;
+    }
+    return false;
+}
+
+// A spot or a curve of a pair's currency moves the pair, crosses included:
+// vehicle legs always share a currency with the crossed pair
+[[nodiscard]] bool SharesCurrency(FXPairKey pair, u32 currency) noexcept {
+    return pair.Base() == currency || pair.Quote() == currency;
+}
+
+[[nodiscard]] bool SharesCurrency(FXPairKey pair, FXPairKey other) noexcept {
+    return SharesCurrency(pair, other.Base()) || SharesCurrency(pair, other.Quote());
+}
+
+}  // anonymous namespace
+
+/* Tick files */
+
+Expect<std::vector<MarketTick>, Error> ParseTicksCsv(std::string_view text) {
+    std::vector<MarketTick> ticks;
+    while (!text.empty()) {
+        const u64 eol = text.find('\n');
+        std::string_view line = text.substr(0, eol);
+        text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+
+        MarketTick tick;
+        if (!ParseTick(line, tick)) [[unlikely]] {
+            return ErrorCorruptedData();
+        }
+        ticks.push_back(tick);
+    }
+    return Ok(std::move(ticks));
+}
+
+Expect<std::vector<MarketTick>, Error> ReadTicksCsv(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) [[unlikely]] {
+        return ErrorIOFailure();
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+    return ParseTicksCsv(text.view());
+}
+
+Expect<std::vector<MarketTick>, Error> ReadTicks(const std::filesystem::path& path) {
+    auto file = MappedFile::Open(path);
+    if (file.Failed()) [[unlikely]] {
+        return Failure<Error>(file.GetFailure());
+    }
+    const std::byte* base = file.Value().Data();
+    const u64 size = file.Value().Size();
+
+    if (size < sizeof(TicksFileHeader)) [[unlikely]] {
+        return ErrorCorruptedData();
+    }
+    TicksFileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (header.magic != TicksFileHeader::kMagic || header.version != TicksFileHeader::kVersion
+        || header.ticks_size != (size - sizeof(header)) / sizeof(TickRecord)
+        || (size - sizeof(header)) % sizeof(TickRecord) != 0) [[unlikely]] {
+        return ErrorCorruptedData();
+    }
+
+    std::vector<MarketTick> ticks(header.ticks_size);
+    for (u64 i = 0; i < ticks.size(); ++i) {
+        TickRecord record;
+        std::memcpy(&record, base + sizeof(header) + i * sizeof(record), sizeof(record));
+        if (record.kind > static_cast<u8>(TickKind::kVolPillar)) [[unlikely]] {
+            return ErrorCorruptedData();
+        }
+
+        auto& tick = ticks[i];
+        tick.timestamp_ns = record.timestamp_ns;
+        tick.kind = static_cast<TickKind>(record.kind);
+        tick.pair = FXPairKey::FromCodes(static_cast<u32>(record.pair >> 32), static_cast<u32>(record.pair));
+        tick.currency = record.currency;
+        tick.date = FromDaysSinceEpoch(record.date);
+        tick.tenor_months = record.tenor_months;
+        tick.strike = record.strike;
+        tick.value = record.value;
+    }
+    return Ok(std::move(ticks));
+}
+
+Expect<void, Error> WriteTicks(std::span<const MarketTick> ticks, const std::filesystem::path& path) noexcept {
+    std::vector<std::byte> buffer(sizeof(TicksFileHeader) + ticks.size() * sizeof(TickRecord));
+
+    TicksFileHeader header{};
+    header.magic = TicksFileHeader::kMagic;
+    header.version = TicksFileHeader::kVersion;
+    header.ticks_size = ticks.size();
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    for (u64 i = 0; i < ticks.size(); ++i) {
+        const auto& tick = ticks[i];
+        const TickRecord record{
+            .timestamp_ns = tick.timestamp_ns,
+            .pair = tick.pair.Value(),
+            .strike = tick.strike,
+            .value = tick.value,
+            .date = DaysSinceEpoch(tick.date),
+            .tenor_months = tick.tenor_months,
+            .currency = tick.currency,
+            .kind = static_cast<u8>(tick.kind),
+            .reserved = {},
+        };
+        std::memcpy(buffer.data() + sizeof(header) + i * sizeof(record), &record, sizeof(record));
+    }
+
+    return WriteFileAtomically(path, buffer);
+}
+
+/* LatencyHistogram */
+
+u32 LatencyHistogram::Bucket(u64 ns) noexcept {
+    if (ns < kSubBuckets) {
+        return static_cast<u32>(ns);
+    }
+    // Power of two, then the two bits below the leading one
+    const u32 exponent = static_cast<u32>(std::bit_width(ns)) - 1;
+    const u32 sub = static_cast<u32>(ns >> (exponent - 2)) & (kSubBuckets - 1);
+    return exponent * kSubBuckets + sub;
+}
+
+u64 LatencyHistogram::BucketUpperBound(u32 bucket) noexcept {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    const u32 exponent = bucket / kSubBuckets;
+    const u64 sub = bucket % kSubBuckets;
+    const u64 step = u64{1} << (exponent - 2);
+    return (kSubBuckets + sub) * step + (step - 1);
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds latency) noexcept {
+    const u64 ns = static_cast<u64>(std::max<i64>(latency.count(), 0));
+    ++counts_[Bucket(ns)];
+    ++count_;
+    sum_ += ns;
+    min_ = std::min(min_, ns);
+    max_ = std::max(max_, ns);
+}
+
+std::chrono::nanoseconds LatencyHistogram::Percentile(f64 quantile) const noexcept {
+    if (count_ == 0) {
+        return std::chrono::nanoseconds(0);
+    }
+    const f64 rank = std::ceil(std::clamp(quantile, 0., 1.) * static_cast<f64>(count_));
+    const u64 target = std::clamp<u64>(static_cast<u64>(rank), 1, count_);
+
+    u64 seen = 0;
+    for (u32 bucket = 0; bucket < kBuckets; ++bucket) {
+        seen += counts_[bucket];
+        if (seen >= target) {
+            return std::chrono::nanoseconds(std::clamp(BucketUpperBound(bucket), min_, max_));
+        }
+    }
+    return Max();
+}
+
+/* ReplayReport */
+
+f64 ReplayReport::Throughput() const noexcept {
+    const f64 seconds = std::chrono::duration<f64>(elapsed).count();
+    return seconds > 0. ? static_cast<f64>(ticks) / seconds : 0.;
+}
+
+void ReplayReport::Write(std::ostream& out) const {
+    constexpr std::array<const char*, kReplayStages> kNames = {"apply", "curve", "surface", "reprice", "total"};
+
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+    out << "ticks " << ticks << ", rejected " << rejected
+        << ", elapsed " << std::chrono::duration<f64, std::milli>(elapsed).count() << " ms"
+        << ", throughput " << Throughput() << " ticks/s\n";
+
+    const auto us = [](std::chrono::nanoseconds ns) {
+        return std::chrono::duration<f64, std::micro>(ns).count();
+    };
+    out << std::left << std::setw(10) << "stage" << std::right
+        << std::setw(10) << "count" << std::setw(10) << "mean"
+        << std::setw(10) << "min" << std::setw(10) << "p50" << std::setw(10) << "p90"
+        << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(10) << "max" << "   (us)\n";
+    for (u64 i = 0; i < kReplayStages; ++i) {
+        const auto& stage = stages[i];
+        out << std::left << std::setw(10) << kNames[i] << std::right
+            << std::setw(10) << stage.Count() << std::setw(10) << stage.MeanNs() / 1000.
+            << std::setw(10) << us(stage.Min()) << std::setw(10) << us(stage.Percentile(0.5))
+            << std::setw(10) << us(stage.Percentile(0.9)) << std::setw(10) << us(stage.Percentile(0.99))
+            << std::setw(10) << us(stage.Percentile(0.999)) << std::setw(10) << us(stage.Max()) << '\n';
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+/* MarketReplay */
+
+std::vector<IrsContract> QuotedSwaps(const HolidayStorage& calendar, const JurisdictionType& jur, DateType today,
+                                     const std::map<i32, f64>& quotes) {
+    std::vector<IrsContract> swaps;
+    swaps.reserve(quotes.size());
+    for (const auto& [months, rate] : quotes) {
+        swaps.push_back(IrsBuilderExperimental()
+            .Adjustment(Percent::Zero())
+            .FixedFreq({std::min(months, 12), TimeUnit::Month})
+            .FloatFreq({std::min(months, 3), TimeUnit::Month})
+            .FixedTerm({months, TimeUnit::Month})
+            .FloatTerm({months, TimeUnit::Month})
+            .FixedRate(Percent::FromPercentage(rate))
+            .Notion(1'000'000)
+            .PayFix(false)
+            .PaymentDateShift(2)
+            .StartShift(2)
+            .Stub(IrsContract::Stub::SHORT)
+            .TradeDate(today)
+            .Build(calendar, jur, DateRollingRule::kModifiedFollowing)
+        );
+    }
+    return swaps;
+}
+
+MarketReplay::MarketReplay(MarketContext& context, ReplaySettings settings)
+    : context_(context)
+    , settings_(std::move(settings))
+    , model_(context_)
+{
+    CDR_CHECK(settings_.speed >= 0.) << "replay speed can't be negative";
+
+    for (const auto& pair : settings_.pairs) {
+        prices_.try_emplace(pair.Key());
+    }
+    forward_dates_.reserve(settings_.forward_days);
+    for (DateType date = context_.Today(); forward_dates_.size() < settings_.forward_days; date = NextDay(date)) {
+        forward_dates_.push_back(date);
+    }
+}
+
+const MarketReplay::Surface* MarketReplay::GetSurface(FXPairKey pair) const noexcept {
+    if (auto it = surfaces_.find(pair); it == surfaces_.end()) [[unlikely]] {
+        return nullptr;
+    } else {
+        return &it->second;
+    }
+}
+
+std::span<const f64> MarketReplay::ForwardPrices(FXPairKey pair) const noexcept {
+    if (auto it = prices_.find(pair); it == prices_.end()) [[unlikely]] {
+        return {};
+    } else {
+        return it->second;
+    }
+}
+
+Expect<void, Error> MarketReplay::Apply(const MarketTick& tick) {
+    ++report_.ticks;
+    auto result = Process(tick, Clock::now());
+    if (result.Failed()) [[unlikely]] {
+        ++report_.rejected;
+    }
+    return result;
+}
+
+const ReplayReport& MarketReplay::Run(std::span<const MarketTick> ticks) {
+    const auto start = Clock::now();
+    const i64 first_timestamp = ticks.empty() ? 0 : ticks.front().timestamp_ns;
+
+    for (const auto& tick : ticks) {
+        auto arrival = Clock::now();
+        if (settings_.speed > 0.) {
+            // Ticks arrive on the recorded schedule whether or not the
+            // pipeline keeps up, so a backlog shows up in the total latency
+            const f64 offset = static_cast<f64>(tick.timestamp_ns - first_timestamp) / settings_.speed;
+            arrival = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<f64, std::nano>(offset));
+            std::this_thread::sleep_until(arrival);
+        }
+
+        ++report_.ticks;
+        if (Process(tick, arrival).Failed()) [[unlikely]] {
+            ++report_.rejected;
+        }
+    }
+
+    report_.elapsed += Clock::now() - start;
+    return report_;
+}
+
+Expect<void, Error> MarketReplay::Process(const MarketTick& tick, Clock::time_point arrival) {
+    auto since = Clock::now();
+
+    switch (tick.kind) {
+        case TickKind::kToday: {
+            context_.SetToday(tick.date);
+            forward_dates_.clear();
+            for (DateType date = tick.date; forward_dates_.size() < settings_.forward_days; date = NextDay(date)) {
+                forward_dates_.push_back(date);
+            }
+            break;
+        }
+        case TickKind::kFxSpot: {
+            context_.SetFxSpot(tick.pair, tick.value);
+            break;
+        }
+        case TickKind::kSwapQuote: {
+            swap_quotes_[tick.currency].insert_or_assign(tick.tenor_months, tick.value);
+            break;
+        }
+        case TickKind::kVolPillar: {
+            if (tick.date < context_.Today()) [[unlikely]] {
+                return ErrorDateInAPast();
+            }
+            vol_pillars_[tick.pair].insert_or_assign(std::make_pair(tick.date, tick.strike), tick.value);
+
+            auto& provider = providers_[tick.pair];
+            if (provider == nullptr) {
+                provider = std::make_unique<SurfaceProvider>(context_.Today());
+                for (f64 delta : settings_.pillar_deltas) {
+                    provider->AddPillarDelta(delta).OrCrashProgram();
+                }
+            }
+            if (auto added = provider->AddPillar(tick.date, tick.strike, tick.value); added.Failed()) [[unlikely]] {
+                return added;
+            }
+            break;
+        }
+        default:
+            return ErrorInvalidInput();
+    }
+
+    auto until = Clock::now();
+    Record(ReplayStage::kApply, since, until);
+
+    // Which curves, surfaces and prices the tick moved
+    const bool everything = tick.kind == TickKind::kToday;
+    const auto affects = [&](FXPairKey pair) {
+        switch (tick.kind) {
+            case TickKind::kToday:
+                return true;
+            case TickKind::kFxSpot:
+                return SharesCurrency(pair, tick.pair);
+            case TickKind::kSwapQuote:
+                return SharesCurrency(pair, tick.currency);
+            case TickKind::kVolPillar:
+                return pair == tick.pair;
+        }
+        return false;
+    };
+
+    if (everything || tick.kind == TickKind::kSwapQuote) {
+        since = until;
+        for (const auto& [currency, quotes] : swap_quotes_) {
+            if (everything || currency == tick.currency) {
+                if (auto built = RebuildCurve(currency); built.Failed()) [[unlikely]] {
+                    return built;
+                }
+            }
+        }
+        until = Clock::now();
+        Record(ReplayStage::kCurve, since, until);
+    }
+
+    if (everything) {
+        ResetProviders();
+    }
+    if (std::ranges::any_of(providers_, [&](const auto& entry) { return affects(entry.first); })) {
+        since = until;
+        for (const auto& [pair, provider] : providers_) {
+            if (affects(pair)) {
+                if (auto built = RebuildSurface(pair); built.Failed()) [[unlikely]] {
+                    return built;
+                }
+            }
+        }
+        until = Clock::now();
+        Record(ReplayStage::kSurface, since, until);
+    }
+
+    if (tick.kind != TickKind::kVolPillar
+        && std::ranges::any_of(prices_, [&](const auto& entry) { return affects(entry.first); })) {
+        since = until;
+        for (const auto& [pair, prices] : prices_) {
+            if (affects(pair)) {
+                if (auto priced = Reprice(pair); priced.Failed()) [[unlikely]] {
+                    return priced;
+                }
+            }
+        }
+        until = Clock::now();
+        Record(ReplayStage::kReprice, since, until);
+    }
+
+    Record(ReplayStage::kTotal, std::min(arrival, until), until);
+    return Ok();
+}
+
+Expect<void, Error> MarketReplay::RebuildCurve(u32 currency) {
+    const JurisdictionType jur = FXPairKey::UnpackCode(currency);
+
+    model_.SetSwaps(jur, QuotedSwaps(context_.Calendar(), jur, context_.Today(), swap_quotes_[currency]));
+    return model_.BuildMainCurve(jur);
+}
+
+Expect<void, Error> MarketReplay::RebuildSurface(FXPairKey pair) {
+    // Surfaces wait for the spot and both curves
+    const auto spot = context_.FindFxSpot(pair);
+    const auto* domestic = std::as_const(model_).GetCurve(FXPairKey::UnpackCode(pair.Quote()));
+    const auto* foreign = std::as_const(model_).GetCurve(FXPairKey::UnpackCode(pair.Base()));
+    if (!spot.has_value() || domestic == nullptr || foreign == nullptr) {
+        return Ok();
+    }
+
+    auto& provider = *providers_.at(pair);
+    if (auto updated = provider.UpdateSnapshot(*spot, *domestic, *foreign); updated.Failed()) [[unlikely]] {
+        return updated;
+    }
+    auto surface = provider.ProvideSnapshot();
+    if (surface.Failed()) [[unlikely]] {
+        return std::move(surface).PropagateFailure();
+    }
+    surfaces_.insert_or_assign(pair, std::move(surface.Value()));
+    return Ok();
+}
+
+Expect<void, Error> MarketReplay::Reprice(FXPairKey pair) {
+    // Prices wait for the spot and both curves
+    const FXPair fx_pair = FXPair::FromKey(pair);
+    if (!context_.FindFxSpot(pair).has_value() || std::as_const(model_).GetCurve(fx_pair.first) == nullptr
+        || std::as_const(model_).GetCurve(fx_pair.second) == nullptr) {
+        return Ok();
+    }
+
+    auto& prices = prices_.at(pair);
+    prices.resize(forward_dates_.size());
+    return model_.ForwardPrices(fx_pair, forward_dates_, prices);
+}
+
+void MarketReplay::ResetProviders() {
+    // Providers measure time from their own today, so they start over with
+    // the pillars that haven't expired
+    const DateType today = context_.Today();
+    providers_.clear();
+    surfaces_.clear();
+    for (const auto& [pair, pillars] : vol_pillars_) {
+        auto provider = std::make_unique<SurfaceProvider>(today);
+        for (f64 delta : settings_.pillar_deltas) {
+            provider->AddPillarDelta(delta).OrCrashProgram();
+        }
+        bool any = false;
+        for (const auto& [pillar, volatility] : pillars) {
+            if (pillar.first >= today) {
+                provider->AddPillar(pillar.first, pillar.second, volatility).OrCrashProgram();
+                any = true;
+            }
+        }
+        if (any) {
+            providers_.emplace(pair, std::move(provider));
+        }
+    }
+}
+
+}  // namespace cdr
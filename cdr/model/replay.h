@@ -0,0 +1,270 @@
+#pragma once
+
+#include <cdr/model/internal/export.h>
+#include <cdr/model/model.h>
+#include <cdr/types/types.h>
+#include <cdr/types/errors.h>
+#include <cdr/types/expect.h>
+#include <cdr/calendar/date.h>
+#include <cdr/market/context.h>
+#include <cdr/fx/fx.h>
+#include <cdr/options/volatility.h>
+#include <cdr/swaps/irs.h>
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cdr {
+
+enum class TickKind : u8 {
+    kToday = 0,
+    kFxSpot,
+    kSwapQuote,
+    kVolPillar,
+};
+
+// One recorded market update. Fields the kind doesn't use are left empty.
+struct MarketTick {
+    // Recording clock, only differences between ticks matter
+    i64 timestamp_ns = 0;
+    TickKind kind = TickKind::kToday;
+    // kFxSpot, kVolPillar
+    FXPairKey pair;
+    // kSwapQuote, see FXPairKey::PackCode
+    u32 currency = 0;
+    // kToday: the new today, kVolPillar: expiry
+    DateType date;
+    // kSwapQuote
+    i32 tenor_months = 0;
+    // kVolPillar
+    f64 strike = 0.;
+    // Spot, par swap rate in percent or volatility
+    f64 value = 0.;
+
+    bool operator==(const MarketTick&) const = default;
+};
+
+// Text tick files, one tick per line, timestamps in nanoseconds:
+//
+//   <ts>,today,<yyyy-mm-dd>
+//   <ts>,spot,<base>,<quote>,<spot>
+//   <ts>,swap,<currency>,<tenor in months>,<par rate in percent>
+//   <ts>,vol,<base>,<quote>,<expiry yyyy-mm-dd>,<strike>,<volatility>
+//
+// Empty lines and lines starting with '#' are skipped. Malformed lines fail
+// with Error::CorruptedData.
+[[nodiscard]] CDR_MODEL_EXPORT Expect<std::vector<MarketTick>, Error> ParseTicksCsv(std::string_view text);
+[[nodiscard]] CDR_MODEL_EXPORT Expect<std::vector<MarketTick>, Error> ReadTicksCsv(const std::filesystem::path& path);
+
+// On-disk layout of a binary tick file:
+//
+//   [TicksFileHeader][TickRecord...]
+//
+// Records are fixed size and in replay order, so reading needs no parsing.
+struct TicksFileHeader {
+    static constexpr u32 kMagic = 0x50524443;  // "CDRP"
+    static constexpr u16 kVersion = 1;
+
+    u32 magic;
+    u16 version;
+    u16 reserved;
+
+    u64 ticks_size;
+};
+
+struct TickRecord {
+    i64 timestamp_ns;
+    u64 pair;
+    f64 strike;
+    f64 value;
+    // days since the unix epoch
+    i32 date;
+    i32 tenor_months;
+    u32 currency;
+    u8 kind;
+    u8 reserved[3];
+};
+static_assert(sizeof(TickRecord) == 48);
+
+[[nodiscard]] CDR_MODEL_EXPORT Expect<std::vector<MarketTick>, Error> ReadTicks(const std::filesystem::path& path);
+[[nodiscard]] CDR_MODEL_EXPORT Expect<void, Error> WriteTicks(std::span<const MarketTick> ticks,
+                                                              const std::filesystem::path& path) noexcept;
+
+// Latency histogram with logarithmic buckets, four per power of two of
+// nanoseconds, so percentiles are exact to within 25% at any scale and
+// recording is a couple of bit operations.
+class CDR_MODEL_EXPORT LatencyHistogram final {
+public:
+    static constexpr u32 kSubBuckets = 4;
+    static constexpr u32 kBuckets = 64 * kSubBuckets;
+
+    void Record(std::chrono::nanoseconds latency) noexcept;
+
+    [[nodiscard]] u64 Count() const noexcept {
+        return count_;
+    }
+
+    [[nodiscard]] std::chrono::nanoseconds Min() const noexcept {
+        return std::chrono::nanoseconds(count_ == 0 ? 0 : min_);
+    }
+
+    [[nodiscard]] std::chrono::nanoseconds Max() const noexcept {
+        return std::chrono::nanoseconds(max_);
+    }
+
+    [[nodiscard]] f64 MeanNs() const noexcept {
+        return count_ == 0 ? 0. : static_cast<f64>(sum_) / static_cast<f64>(count_);
+    }
+
+    // Upper bound of the bucket holding the `quantile` of recorded latencies,
+    // never above Max()
+    [[nodiscard]] std::chrono::nanoseconds Percentile(f64 quantile) const noexcept;
+
+private:
+    [[nodiscard]] static u32 Bucket(u64 ns) noexcept;
+    [[nodiscard]] static u64 BucketUpperBound(u32 bucket) noexcept;
+
+private:
+    std::array<u64, kBuckets> counts_{};
+    u64 count_ = 0;
+    u64 sum_ = 0;
+    u64 min_ = ~u64{0};
+    u64 max_ = 0;
+};
+
+enum class ReplayStage : u8 {
+    // Tick applied to the context or to the stored quotes
+    kApply = 0,
+    // Swap contracts rebuilt from quotes and the curve bootstrapped
+    kCurve,
+    // UpdateSnapshot of the affected volatility surfaces
+    kSurface,
+    // Batch forward prices of the affected pairs
+    kReprice,
+    // From the tick's scheduled arrival to the end of repricing
+    kTotal,
+    __NumberOfStages,
+};
+
+constexpr u64 kReplayStages = static_cast<u64>(ReplayStage::__NumberOfStages);
+
+struct CDR_MODEL_EXPORT ReplayReport {
+    std::array<LatencyHistogram, kReplayStages> stages;
+    u64 ticks = 0;
+    // Ticks that failed to apply, e.g. pillars expired before today
+    u64 rejected = 0;
+    std::chrono::nanoseconds elapsed{0};
+
+    [[nodiscard]] const LatencyHistogram& Stage(ReplayStage stage) const noexcept {
+        return stages[static_cast<u64>(stage)];
+    }
+
+    // Ticks per second of wall time
+    [[nodiscard]] f64 Throughput() const noexcept;
+
+    void Write(std::ostream& out) const;
+};
+
+struct ReplaySettings {
+    // Multiple of the recorded rate, 0 replays as fast as possible
+    f64 speed = 0.;
+    // Pairs repriced after every tick that may move them
+    std::vector<FXPair> pairs;
+    // Daily forward grid from today
+    u32 forward_days = 366;
+    // Pillar deltas of the volatility surfaces
+    std::vector<f64> pillar_deltas = {-0.25, -0.10, 0.10, 0.25};
+};
+
+// Swaps bootstrapping the curve of `jur` from par swap quotes as of
+// `today`, by tenor in months: spot starting swaps against 3M floating, with
+// annual fixed coupons (shorter tenors pay once).
+[[nodiscard]] CDR_MODEL_EXPORT std::vector<IrsContract> QuotedSwaps(const HolidayStorage& calendar,
+                                                                   const JurisdictionType& jur, DateType today,
+                                                                   const std::map<i32, f64>& quotes);
+
+// Drives recorded ticks through the pricing pipeline: spots and today into
+// `context`, swap quotes into curves bootstrapped by the model, vol pillars
+// into one VolatilitySurfaceProvider per pair, and forward prices of the
+// configured pairs. Every tick is pushed through all the stages it
+// invalidates before the next one is taken, and each stage is timed.
+//
+// Swap quotes build curves from QuotedSwaps; today's ticks rebuild everything.
+class CDR_MODEL_EXPORT MarketReplay final {
+public:
+    using Surface = VolatilitySurface<>;
+    using SurfaceProvider = VolatilitySurfaceProvider<>;
+
+public:
+    MarketReplay(MarketContext& context, ReplaySettings settings);
+
+    MarketReplay(const MarketReplay&) = delete;
+    MarketReplay& operator=(const MarketReplay&) = delete;
+
+    // Pushes `tick` through the pipeline, stage latencies go to Report()
+    [[nodiscard]] Expect<void, Error> Apply(const MarketTick& tick);
+
+    // Replays `ticks` paced by the speed of the settings. Ticks that fail are
+    // counted as rejected and skipped.
+    const ReplayReport& Run(std::span<const MarketTick> ticks);
+
+    [[nodiscard]] const ReplayReport& Report() const noexcept {
+        return report_;
+    }
+
+    [[nodiscard]] const Model& GetModel() const noexcept {
+        return model_;
+    }
+
+    // returns nullptr if surface is not built yet
+    [[nodiscard]] const Surface* GetSurface(FXPairKey pair) const noexcept;
+
+    // Latest forward prices of a configured pair on ForwardDates(), empty
+    // until the pair could be priced
+    [[nodiscard]] std::span<const f64> ForwardPrices(FXPairKey pair) const noexcept;
+
+    [[nodiscard]] std::span<const DateType> ForwardDates() const noexcept {
+        return forward_dates_;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    [[nodiscard]] Expect<void, Error> Process(const MarketTick& tick, Clock::time_point arrival);
+
+    [[nodiscard]] Expect<void, Error> RebuildCurve(u32 currency);
+    [[nodiscard]] Expect<void, Error> RebuildSurface(FXPairKey pair);
+    [[nodiscard]] Expect<void, Error> Reprice(FXPairKey pair);
+    void ResetProviders();
+
+    void Record(ReplayStage stage, Clock::time_point since, Clock::time_point until) noexcept {
+        report_.stages[static_cast<u64>(stage)].Record(until - since);
+    }
+
+private:
+    MarketContext& context_;
+    ReplaySettings settings_;
+    Model model_;
+
+    // currency -> tenor in months -> par rate in percent
+    std::map<u32, std::map<i32, f64>> swap_quotes_;
+    // pair as quoted -> (expiry, strike) -> volatility
+    std::map<FXPairKey, std::map<std::pair<DateType, f64>, f64>> vol_pillars_;
+    std::map<FXPairKey, std::unique_ptr<SurfaceProvider>> providers_;
+    std::map<FXPairKey, Surface> surfaces_;
+
+    std::vector<DateType> forward_dates_;
+    std::map<FXPairKey, std::vector<f64>> prices_;
+
+    ReplayReport report_;
+};
+
+}  // namespace cdr
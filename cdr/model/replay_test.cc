@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include <cdr/model/replay.h>
+#include <cdr/calendar/date.h>
+#include <cdr/calendar/holiday_storage.h>
+#include <cdr/market/context.h>
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+using namespace std::chrono;
+
+namespace {
+
+constexpr std::string_view kTicks =
+    "# recorded 2027-01-04\n"
+    "0,today,2027-01-04\n"
+    "1000,swap,USD,12,4.40\n"
+    "2000,swap,USD,24,4.10\n"
+    "3000,swap,USD,60,3.80\n"
+    "4000,swap,EUR,12,2.50\n"
+    "5000,swap,EUR,60,2.30\n"
+    "6000,spot,EUR,USD,1.10\n"
+    "7000,vol,EUR,USD,2027-04-05,1.00,0.12\n"
+    "8000,vol,EUR,USD,2027-04-05,1.10,0.10\n"
+    "9000,vol,EUR,USD,2027-04-05,1.20,0.11\n"
+    "10000,vol,EUR,USD,2028-01-04,1.00,0.13\n"
+    "11000,vol,EUR,USD,2028-01-04,1.10,0.11\r\n"
+    "12000,vol,EUR,USD,2028-01-04,1.20,0.12\n"
+    "\n"
+    "13000,spot,USD,EUR,0.8\n";
+
+}  // anonymous namespace
+
+TEST(ReplayTicks, CsvAndBinary) {
+    auto ticks = cdr::ParseTicksCsv(kTicks);
+    ASSERT_TRUE(ticks.Succeed());
+    ASSERT_EQ(ticks.Value().size(), 14);
+
+    const auto& swap = ticks.Value()[3];
+    ASSERT_EQ(swap.kind, cdr::TickKind::kSwapQuote);
+    ASSERT_EQ(swap.timestamp_ns, 3000);
+    ASSERT_EQ(cdr::FXPairKey::UnpackCode(swap.currency), "USD");
+    ASSERT_EQ(swap.tenor_months, 60);
+    ASSERT_EQ(swap.value, 3.80);
+
+    const auto& vol = ticks.Value()[11];
+    ASSERT_EQ(vol.kind, cdr::TickKind::kVolPillar);
+    ASSERT_EQ(vol.pair, cdr::FXPairKey::Pack("EUR", "USD"));
+    ASSERT_EQ(vol.date, day(4)/January/year(2028));
+    ASSERT_EQ(vol.strike, 1.10);
+    ASSERT_EQ(vol.value, 0.11);
+
+    const auto path = std::filesystem::temp_directory_path() / "cdr_replay_ticks.bin";
+    ASSERT_TRUE(cdr::WriteTicks(ticks.Value(), path).Succeed());
+    auto restored = cdr::ReadTicks(path);
+    ASSERT_TRUE(restored.Succeed());
+    ASSERT_EQ(restored.Value(), ticks.Value());
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(cdr::ParseTicksCsv("0,spot,EUR,USD\n").GetFailure(), cdr::Error::CorruptedData);
+    ASSERT_EQ(cdr::ParseTicksCsv("0,swap,USD,0,4.1\n").GetFailure(), cdr::Error::CorruptedData);
+    ASSERT_EQ(cdr::ParseTicksCsv("0,today,2027-02-30\n").GetFailure(), cdr::Error::CorruptedData);
+    ASSERT_EQ(cdr::ReadTicks(std::filesystem::temp_directory_path() / "cdr_replay_missing.bin").GetFailure(),
+              cdr::Error::IOFailure);
+}
+
+TEST(LatencyHistogram, Percentiles) {
+    cdr::LatencyHistogram histogram;
+    ASSERT_EQ(histogram.Percentile(0.5), nanoseconds(0));
+
+    for (i64 ns = 1; ns <= 10'000; ++ns) {
+        histogram.Record(nanoseconds(ns));
+    }
+    ASSERT_EQ(histogram.Count(), 10'000);
+    ASSERT_EQ(histogram.Min(), nanoseconds(1));
+    ASSERT_EQ(histogram.Max(), nanoseconds(10'000));
+    ASSERT_DOUBLE_EQ(histogram.MeanNs(), 5'000.5);
+    ASSERT_EQ(histogram.Percentile(1.), nanoseconds(10'000));
+
+    for (f64 quantile : {0.1, 0.5, 0.9, 0.99}) {
+        const auto exact = static_cast<f64>(quantile * 10'000);
+        const auto estimate = static_cast<f64>(histogram.Percentile(quantile).count());
+        EXPECT_GE(estimate, exact) << quantile;
+        EXPECT_LE(estimate, 1.25 * exact) << quantile;
+    }
+}
+
+TEST(MarketReplay, PipelineFollowsTicks) {
+    const auto ticks = cdr::ParseTicksCsv(kTicks).Value();
+
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("USD", year(2027) / January / day(18))
+        ("EUR", year(2027) / April / day(2))
+    ;
+    cdr::MarketContext context(std::move(holiday_storage), day(4)/January/year(2027));
+    cdr::ReplaySettings settings;
+    settings.pairs = {{"EUR", "USD"}, {"USD", "EUR"}};
+    settings.forward_days = 30;
+    cdr::MarketReplay replay(context, settings);
+
+    const auto& report = replay.Run(ticks);
+    ASSERT_EQ(report.ticks, ticks.size());
+    ASSERT_EQ(report.rejected, 0);
+    ASSERT_EQ(report.Stage(cdr::ReplayStage::kApply).Count(), ticks.size());
+    ASSERT_EQ(report.Stage(cdr::ReplayStage::kTotal).Count(), ticks.size());
+    // Today and every swap quote
+    ASSERT_EQ(report.Stage(cdr::ReplayStage::kCurve).Count(), 6);
+    // Everything but vol pillars moves the forwards
+    ASSERT_EQ(report.Stage(cdr::ReplayStage::kReprice).Count(), 8);
+    ASSERT_GT(report.elapsed, nanoseconds(0));
+
+    const auto& model = replay.GetModel();
+    ASSERT_EQ(model.GetCurve("USD")->Pillars().size(), 3);
+    ASSERT_EQ(model.GetCurve("EUR")->Pillars().size(), 2);
+
+    // Prices follow the last spot, quoted in the other direction
+    const auto eurusd = replay.ForwardPrices(cdr::FXPairKey::Pack("EUR", "USD"));
+    const auto usdeur = replay.ForwardPrices(cdr::FXPairKey::Pack("USD", "EUR"));
+    ASSERT_EQ(eurusd.size(), 30);
+    ASSERT_EQ(replay.ForwardDates().front(), day(4)/January/year(2027));
+    for (u64 i = 0; i < eurusd.size(); ++i) {
+        EXPECT_NEAR(eurusd[i], model.ForwardPrice({"EUR", "USD"}, replay.ForwardDates()[i]), 1e-12);
+        EXPECT_NEAR(eurusd[i] * usdeur[i], 1., 1e-12);
+    }
+    // ...and settle the spot on the spot date
+    ASSERT_EQ(replay.ForwardDates()[2], context.SpotDate({"EUR", "USD"}));
+    ASSERT_DOUBLE_EQ(eurusd[2], 1.25);
+
+    // The surface is rebuilt on the last spot and matches quoted pillars
+    const auto* surface = replay.GetSurface(cdr::FXPairKey::Pack("EUR", "USD"));
+    ASSERT_NE(surface, nullptr);
+    ASSERT_DOUBLE_EQ(surface->Header().spot, 1.25);
+    ASSERT_NEAR(surface->Volatility(day(5)/April/year(2027), 1.10).Value(), 0.10, 1e-12);
+    ASSERT_NEAR(surface->Volatility(day(4)/January/year(2028), 1.20).Value(), 0.12, 1e-12);
+
+    // Spot ticks reprice from the cached forward factors, curves are only read
+    const u64 version = model.Version();
+    cdr::MarketTick spot{.timestamp_ns = 13500, .kind = cdr::TickKind::kFxSpot,
+                         .pair = cdr::FXPairKey::Pack("EUR", "USD"), .value = 1.25};
+    ASSERT_TRUE(replay.Apply(spot).Succeed());
+    ASSERT_EQ(model.Version(), version);
+
+    // Pillars expired by the next today are dropped, new ones before it rejected
+    cdr::MarketTick next_day{.timestamp_ns = 14000, .kind = cdr::TickKind::kToday, .date = day(6)/April/year(2027)};
+    ASSERT_TRUE(replay.Apply(next_day).Succeed());
+    ASSERT_EQ(replay.ForwardDates().front(), day(6)/April/year(2027));
+    ASSERT_NEAR(replay.GetSurface(cdr::FXPairKey::Pack("EUR", "USD"))->Volatility(day(4)/January/year(2028), 1.10).Value(),
+                0.11, 1e-12);
+
+    cdr::MarketTick expired{.timestamp_ns = 15000, .kind = cdr::TickKind::kVolPillar,
+                            .pair = cdr::FXPairKey::Pack("EUR", "USD"), .date = day(5)/April/year(2027),
+                            .strike = 1.10, .value = 0.10};
+    ASSERT_EQ(replay.Apply(expired).GetFailure(), cdr::Error::DateInAPast);
+    ASSERT_EQ(replay.Report().ticks, ticks.size() + 3);
+    ASSERT_EQ(replay.Report().rejected, 1);
+}
+
+TEST(MarketReplay, RecordedPace) {
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("USD", year(2027) / January / day(18))
+        ("EUR", year(2027) / April / day(2))
+    ;
+    cdr::MarketContext context(std::move(holiday_storage), day(4)/January/year(2027));
+    cdr::MarketReplay replay(context, {.speed = 2.});
+
+    std::vector<cdr::MarketTick> ticks;
+    for (i64 i = 0; i <= 10; ++i) {
+        ticks.push_back({.timestamp_ns = i * 2'000'000, .kind = cdr::TickKind::kFxSpot,
+                         .pair = cdr::FXPairKey::Pack("EUR", "USD"), .value = 1.10 + 0.01 * i});
+    }
+
+    // 20ms of recording at twice the recorded rate
+    const auto& report = replay.Run(ticks);
+    ASSERT_EQ(report.ticks, ticks.size());
+    ASSERT_GE(report.elapsed, milliseconds(10));
+    ASSERT_DOUBLE_EQ(context.FxSpot({"EUR", "USD"}), 1.20);
+}
@@ -0,0 +1,112 @@
+#include <cdr/model/snapshot.h>
+
+#include <algorithm>
+#include <cdr/base/check.h>
+
+namespace cdr {
+
+/* MarketSnapshot */
+
+const Curve* MarketSnapshot::GetCurve(const JurisdictionType& jur) const noexcept {
+    if (auto it = curves_.find(jur); it == curves_.end()) [[unlikely]] {
+        return nullptr;
+    } else {
+        return it->second.get();
+    }
+}
+
+const MarketSnapshot::Surface* MarketSnapshot::GetSurface(FXPairKey pair) const noexcept {
+    if (auto it = surfaces_.find(pair); it == surfaces_.end()) [[unlikely]] {
+        return nullptr;
+    } else {
+        return &it->second;
+    }
+}
+
+/* MarketSnapshotBuilder */
+
+MarketSnapshotBuilder::MarketSnapshotBuilder(std::shared_ptr<const HolidayStorage> calendar, u64 calendar_version,
+                                             DateType today)
+    : calendar_(std::move(calendar))
+    , calendar_version_(calendar_version)
+    , today_(today)
+{
+    CDR_CHECK(calendar_ != nullptr) << "calendar is required";
+}
+
+MarketSnapshotBuilder::MarketSnapshotBuilder(const MarketSnapshot& base)
+    : calendar_(base.context_->SharedCalendar())
+    , calendar_version_(base.calendar_version_)
+    , today_(base.Today())
+    , spots_(base.spots_)
+    , vehicles_(base.vehicles_)
+    , surfaces_(base.surfaces_)
+{
+    for (const auto& [jur, curve] : base.curves_) {
+        curves_.emplace(jur, curve->Pillars());
+    }
+}
+
+MarketSnapshotBuilder& MarketSnapshotBuilder::Calendar(std::shared_ptr<const HolidayStorage> calendar, u64 version) {
+    CDR_CHECK(calendar != nullptr) << "calendar is required";
+    calendar_ = std::move(calendar);
+    calendar_version_ = version;
+    return *this;
+}
+
+MarketSnapshotBuilder& MarketSnapshotBuilder::FxSpot(FXPairKey pair, f64 spot) {
+    // A quote of either direction replaces the pair, as in FxSpotTable
+    spots_.insert_or_assign(std::min(pair, pair.Reversed()), std::make_pair(pair, spot));
+    return *this;
+}
+
+MarketSnapshotBuilder& MarketSnapshotBuilder::AddCurve(const Curve& curve) {
+    curves_.insert_or_assign(curve.GetJurisdiction(), curve.Pillars());
+    return *this;
+}
+
+MarketSnapshotBuilder& MarketSnapshotBuilder::AddSurface(FXPairKey pair, const MarketSnapshot::Surface& surface) {
+    surfaces_.insert_or_assign(pair, surface);
+    return *this;
+}
+
+[[nodiscard]] std::unique_ptr<MarketSnapshot> MarketSnapshotBuilder::Build() const {
+    std::unique_ptr<MarketSnapshot> snapshot(new MarketSnapshot());
+    snapshot->calendar_version_ = calendar_version_;
+    snapshot->context_ = std::make_unique<MarketContext>(calendar_, today_);
+    snapshot->spots_ = spots_;
+    snapshot->vehicles_ = vehicles_;
+    snapshot->surfaces_ = surfaces_;
+
+    auto& context = *snapshot->context_;
+    context.SetFxVehicles(vehicles_);
+    for (const auto& [canonical, quote] : spots_) {
+        context.SetFxSpot(quote.first, quote.second);
+    }
+
+    for (const auto& [jur, pillars] : curves_) {
+        CurveBuilder builder(context);
+        builder.Jurisdiction(jur);
+        for (const auto& [date, rate] : pillars) {
+            builder.Add(date, rate);
+        }
+        snapshot->curves_.emplace(jur, builder.FromPoints());
+    }
+
+    return snapshot;
+}
+
+/* MarketSnapshotStore */
+
+u64 MarketSnapshotStore::Publish(std::unique_ptr<MarketSnapshot> snapshot) {
+    CDR_CHECK(snapshot != nullptr) << "nothing to publish";
+
+    std::lock_guard lock(publish_mutex_);
+    const u64 epoch = epoch_.load(std::memory_order_relaxed) + 1;
+    snapshot->epoch_ = epoch;
+    latest_.store(std::shared_ptr<const MarketSnapshot>(std::move(snapshot)), std::memory_order_release);
+    epoch_.store(epoch, std::memory_order_release);
+    return epoch;
+}
+
+}  // namespace cdr
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cdr/model/internal/export.h>
+#include <cdr/types/types.h>
+#include <cdr/calendar/date.h>
+#include <cdr/calendar/holiday_storage.h>
+#include <cdr/market/context.h>
+#include <cdr/fx/fx.h>
+#include <cdr/curve/curve.h>
+#include <cdr/options/volatility.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace cdr {
+
+// Immutable, consistent state of the market: today, calendar, FX spots,
+// curves and volatility surfaces. Curves are bound to a frozen MarketContext
+// owned by the snapshot, so nothing a pricer reads can change while it holds
+// the snapshot. Built by MarketSnapshotBuilder, published by
+// MarketSnapshotStore.
+class CDR_MODEL_EXPORT MarketSnapshot final {
+public:
+    using Surface = VolatilitySurface<>;
+
+public:
+    MarketSnapshot(const MarketSnapshot&) = delete;
+    MarketSnapshot& operator=(const MarketSnapshot&) = delete;
+
+    // Stamped on publication, 0 for snapshots never published
+    [[nodiscard]] u64 Epoch() const noexcept {
+        return epoch_;
+    }
+
+    [[nodiscard]] u64 CalendarVersion() const noexcept {
+        return calendar_version_;
+    }
+
+    [[nodiscard]] DateType Today() const noexcept {
+        return context_->Today();
+    }
+
+    [[nodiscard]] MarketContextView Context() const noexcept {
+        return *context_;
+    }
+
+    [[nodiscard]] const HolidayStorage& Calendar() const noexcept {
+        return context_->Calendar();
+    }
+
+    [[nodiscard]] f64 FxSpot(const FXPair& pair) const {
+        return context_->FxSpot(pair);
+    }
+
+    // returns nullptr is curve is not present
+    [[nodiscard]] const Curve* GetCurve(const JurisdictionType& jur) const noexcept;
+
+    // returns nullptr is surface is not present
+    [[nodiscard]] const Surface* GetSurface(FXPairKey pair) const noexcept;
+
+private:
+    friend class MarketSnapshotBuilder;
+    friend class MarketSnapshotStore;
+
+    MarketSnapshot() = default;
+
+private:
+    u64 epoch_ = 0;
+    u64 calendar_version_ = 0;
+    std::unique_ptr<MarketContext> context_;
+
+    // Inputs kept to derive the next snapshot: quotes by canonical pair and
+    // vehicle currencies
+    std::map<FXPairKey, std::pair<FXPairKey, f64>> spots_;
+    std::vector<CurrencyTag> vehicles_;
+
+    std::map<JurisdictionType, std::unique_ptr<Curve>> curves_;
+    std::map<FXPairKey, Surface> surfaces_;
+};
+
+class CDR_MODEL_EXPORT MarketSnapshotBuilder {
+public:
+    MarketSnapshotBuilder(std::shared_ptr<const HolidayStorage> calendar, u64 calendar_version, DateType today);
+
+    // Next snapshot: starts with everything `base` holds
+    explicit MarketSnapshotBuilder(const MarketSnapshot& base);
+
+    [[maybe_unused]] MarketSnapshotBuilder& Today(DateType today) {
+        today_ = today;
+        return *this;
+    }
+
+    [[maybe_unused]] MarketSnapshotBuilder& Calendar(std::shared_ptr<const HolidayStorage> calendar, u64 version);
+
+    [[maybe_unused]] MarketSnapshotBuilder& FxSpot(FXPairKey pair, f64 spot);
+
+    [[maybe_unused]] MarketSnapshotBuilder& FxSpot(const FXPair& pair, f64 spot) {
+        return FxSpot(pair.Key(), spot);
+    }
+
+    [[maybe_unused]] MarketSnapshotBuilder& FxVehicles(std::vector<CurrencyTag> vehicles) {
+        vehicles_ = std::move(vehicles);
+        return *this;
+    }
+
+    // Pillars of `curve`, rebound to the snapshot's context. Replaces the
+    // curve of the same jurisdiction.
+    [[maybe_unused]] MarketSnapshotBuilder& AddCurve(const Curve& curve);
+
+    [[maybe_unused]] MarketSnapshotBuilder& AddSurface(FXPairKey pair, const MarketSnapshot::Surface& surface);
+
+    [[nodiscard]] std::unique_ptr<MarketSnapshot> Build() const;
+
+private:
+    std::shared_ptr<const HolidayStorage> calendar_;
+    u64 calendar_version_;
+    DateType today_;
+
+    std::map<FXPairKey, std::pair<FXPairKey, f64>> spots_;
+    std::vector<CurrencyTag> vehicles_ = {"USD"};
+    std::map<JurisdictionType, Curve::PointsContainer> curves_;
+    std::map<FXPairKey, MarketSnapshot::Surface> surfaces_;
+};
+
+// Latest published market snapshot.
+//
+// Readers pin the current snapshot with a reference count and keep pricing
+// against it while the feed builds and publishes the next one; a snapshot is
+// freed when the last pricer holding it lets go. Pinning never blocks on
+// publication and publication never waits for readers.
+class CDR_MODEL_EXPORT MarketSnapshotStore {
+public:
+    using Pinned = std::shared_ptr<const MarketSnapshot>;
+
+public:
+    MarketSnapshotStore() = default;
+
+    MarketSnapshotStore(const MarketSnapshotStore&) = delete;
+    MarketSnapshotStore& operator=(const MarketSnapshotStore&) = delete;
+
+    // nullptr until the first publication
+    [[nodiscard]] Pinned Pin() const noexcept {
+        return latest_.load(std::memory_order_acquire);
+    }
+
+    // Stamps the next epoch on `snapshot` and makes it the latest one.
+    // Returns the epoch.
+    u64 Publish(std::unique_ptr<MarketSnapshot> snapshot);
+
+    [[nodiscard]] u64 Epoch() const noexcept {
+        return epoch_.load(std::memory_order_acquire);
+    }
+
+private:
+    std::atomic<std::shared_ptr<const MarketSnapshot>> latest_;
+    std::atomic<u64> epoch_ = 0;
+    std::mutex publish_mutex_;
+};
+
+}  // namespace cdr
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <cdr/model/snapshot.h>
+#include <cdr/types/percent.h>
+#include <cdr/calendar/date.h>
+#include <cdr/curve/curve.h>
+#include <cdr/market/context.h>
+#include <cdr/calendar/holiday_storage.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+
+std::unique_ptr<cdr::MarketSnapshot> MakeSnapshot(const std::shared_ptr<const cdr::HolidayStorage>& calendar) {
+    cdr::MarketContext context(calendar, day(4)/January/year(2027));
+    auto usd = cdr::CurveBuilder(context)
+        .Jurisdiction("USD")
+        .Add(day(4)/April/year(2027), cdr::Percent::FromPercentage(4.40))
+        .Add(day(4)/January/year(2028), cdr::Percent::FromPercentage(4.10))
+        .FromPoints();
+
+    return cdr::MarketSnapshotBuilder(calendar, 1, day(4)/January/year(2027))
+        .FxSpot({"EUR", "USD"}, 1.10)
+        .FxSpot({"USD", "JPY"}, 150.)
+        .AddCurve(*usd)
+        .Build();
+}
+
+}  // anonymous namespace
+
+TEST(MarketSnapshot, PinnedSnapshotsDontChange) {
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("USD", year(2027) / January / day(18))
+        ("EUR", year(2027) / April / day(2))
+    ;
+    const auto calendar = std::make_shared<const cdr::HolidayStorage>(std::move(holiday_storage));
+
+    cdr::MarketSnapshotStore store;
+    ASSERT_EQ(store.Pin(), nullptr);
+    ASSERT_EQ(store.Publish(MakeSnapshot(calendar)), 1);
+
+    const auto pinned = store.Pin();
+    ASSERT_EQ(pinned->Epoch(), 1);
+    ASSERT_EQ(pinned->CalendarVersion(), 1);
+    ASSERT_EQ(pinned->FxSpot({"EUR", "JPY"}), 1.10 * 150.);
+    ASSERT_EQ(pinned->GetSurface(cdr::FXPairKey::Pack("EUR", "USD")), nullptr);
+
+    const auto* curve = pinned->GetCurve("USD");
+    ASSERT_NE(curve, nullptr);
+    ASSERT_EQ(pinned->GetCurve("EUR"), nullptr);
+    const auto rate = curve->Interpolated<cdr::Linear>(day(4)/July/year(2027), pinned->Calendar(), "USD");
+
+    // The feed derives and publishes the next state
+    auto next = cdr::MarketSnapshotBuilder(*pinned)
+        .Today(day(5)/January/year(2027))
+        .FxSpot({"USD", "EUR"}, 0.8)
+        .Build();
+    ASSERT_EQ(store.Publish(std::move(next)), 2);
+
+    const auto latest = store.Pin();
+    ASSERT_EQ(latest->Epoch(), 2);
+    ASSERT_EQ(latest->Today(), day(5)/January/year(2027));
+    ASSERT_EQ(latest->GetCurve("USD")->Today(), day(5)/January/year(2027));
+    ASSERT_EQ(latest->FxSpot({"EUR", "USD"}), 1. / 0.8);
+    ASSERT_EQ(latest->FxSpot({"USD", "JPY"}), 150.);
+    ASSERT_EQ(&latest->Calendar(), &pinned->Calendar());
+
+    // ...while the pinned one keeps its own
+    ASSERT_EQ(pinned->Today(), day(4)/January/year(2027));
+    ASSERT_EQ(curve->Today(), day(4)/January/year(2027));
+    ASSERT_EQ(pinned->FxSpot({"EUR", "USD"}), 1.10);
+    ASSERT_EQ(curve->Interpolated<cdr::Linear>(day(4)/July/year(2027), pinned->Calendar(), "USD"), rate);
+}
+
+TEST(MarketSnapshot, ConcurrentPublication) {
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("USD", year(2027) / January / day(18))
+        ("EUR", year(2027) / April / day(2))
+    ;
+    const auto calendar = std::make_shared<const cdr::HolidayStorage>(std::move(holiday_storage));
+
+    cdr::MarketSnapshotStore store;
+    store.Publish(MakeSnapshot(calendar));
+
+    std::atomic<bool> stop = false;
+    std::thread feed([&] {
+        for (u32 i = 1; !stop.load(std::memory_order_relaxed); ++i) {
+            const auto base = store.Pin();
+            // Spot and today move together, pricers must never see a mix
+            store.Publish(cdr::MarketSnapshotBuilder(*base)
+                .Today(cdr::NextDay(base->Today()))
+                .FxSpot({"EUR", "USD"}, 1. + 0.001 * (i % 100))
+                .Build());
+        }
+    });
+
+    std::vector<std::thread> pricers;
+    std::atomic<u64> inconsistent = 0;
+    for (u32 p = 0; p < 3; ++p) {
+        pricers.emplace_back([&] {
+            u64 last_epoch = 0;
+            for (u32 i = 0; i < 2'000; ++i) {
+                const auto snapshot = store.Pin();
+                const u64 epoch = snapshot->Epoch();
+                const auto expected_today = sys_days{day(4)/January/year(2027)} + days(epoch - 1);
+                const f64 expected_spot = epoch == 1 ? 1.10 : 1. + 0.001 * ((epoch - 1) % 100);
+
+                if (epoch < last_epoch || sys_days{snapshot->Today()} != expected_today
+                    || snapshot->GetCurve("USD")->Today() != snapshot->Today()
+                    || snapshot->FxSpot({"EUR", "USD"}) != expected_spot) {
+                    inconsistent.fetch_add(1, std::memory_order_relaxed);
+                }
+                last_epoch = epoch;
+            }
+        });
+    }
+    for (auto& pricer : pricers) {
+        pricer.join();
+    }
+    stop = true;
+    feed.join();
+
+    ASSERT_EQ(inconsistent.load(), 0);
+}
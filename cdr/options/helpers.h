@@ -17,7 +17,7 @@ struct OptionParams {
     OptionType type;
 };
 
-[[nodiscard]] f64 FxOptionPrice(
+[[nodiscard]] inline f64 FxOptionPrice(
     f64 S,
     f64 K,
     f64 rd,
@@ -40,7 +40,7 @@ struct OptionParams {
     }
 }
 
-[[nodiscard]] f64 FxOptionDelta(
+[[nodiscard]] inline f64 FxOptionDelta(
     f64 S,
     f64 K,
     f64 rd,
@@ -61,7 +61,7 @@ struct OptionParams {
     }
 }
 
-[[nodiscard]] Percent FxOptionDeltaInPercents(
+[[nodiscard]] inline Percent FxOptionDeltaInPercents(
     f64 S,
     f64 K,
     f64 rd,
@@ -75,7 +75,7 @@ struct OptionParams {
     return Percent::FromFraction(delta * S / price);
 }
 
-[[nodiscard]] f64 FxOptionStrikeFromDelta(
+[[nodiscard]] inline f64 FxOptionStrikeFromDelta(
     f64 S,
     f64 rd,
     f64 rf,
@@ -100,7 +100,7 @@ struct OptionParams {
     return K;
 }
 
-[[nodiscard]] f64 FxOptionGamma(
+[[nodiscard]] inline f64 FxOptionGamma(
     f64 S,
     f64 K,
     f64 rd,
@@ -115,7 +115,7 @@ struct OptionParams {
     return df_f * NormalPDF(d1) / (S * sigma * sqrtT);
 }
 
-[[nodiscard]] Percent FxOptionGammaInPercents(
+[[nodiscard]] inline Percent FxOptionGammaInPercents(
     f64 S,
     f64 K,
     f64 rd,
@@ -128,7 +128,7 @@ struct OptionParams {
     return Percent::FromFraction(gamma * S * 0.01);
 }
 
-[[nodiscard]] f64 FxOptionVega(
+[[nodiscard]] inline f64 FxOptionVega(
     f64 S,
     f64 K,
     f64 rd,
@@ -143,7 +143,7 @@ struct OptionParams {
     return df_f * NormalPDF(d1) * S * sqrtT;
 }
 
-[[nodiscard]] Percent FxOptionVegaInPercents(
+[[nodiscard]] inline Percent FxOptionVegaInPercents(
     f64 S,
     f64 K,
     f64 rd,
@@ -156,7 +156,7 @@ struct OptionParams {
     return Percent::FromFraction(vega * sigma * 0.1);
 }
 
-[[nodiscard]] f64 FxOptionTheta(
+[[nodiscard]] inline f64 FxOptionTheta(
     f64 S,
     f64 K,
     f64 rd,
@@ -177,7 +177,7 @@ struct OptionParams {
         - sgn * rd * K * df_d * NormalCDF(sgn * d2);
 }
 
-[[nodiscard]] f64 FxOptionRho(
+[[nodiscard]] inline f64 FxOptionRho(
     f64 S,
     f64 K,
     f64 rd,
@@ -196,7 +196,7 @@ struct OptionParams {
     return sgn * T * K * df_d * NormalCDF(sgn * d2);
 }
 
-[[nodiscard]] f64 FxOptionSigmaFromPrice(
+[[nodiscard]] inline f64 FxOptionSigmaFromPrice(
     f64 S,
     f64 K,
     f64 rd,
@@ -1,7 +1,17 @@
 #pragma once
 
-namespace cdr {
+#include <cdr/types/floats.h>
+
+#include <span>
 
+namespace cdr {
 
+// Interpolation evaluating many points of one smile per call: y[i] is the
+// Evaluate of x[i], NaN where Evaluate fails. See VolatilitySurface::Volatilities.
+template <typename Interpolation>
+concept BatchInterpolation = requires(const void* coefs_ptr, std::span<const f64> xs, std::span<const f64> x,
+                                      std::span<f64> y) {
+    { Interpolation::EvaluateMany(coefs_ptr, xs, x, y) } noexcept;
+};
 
 }  // namespace cdr
@@ -1,6 +1,7 @@
 #include <cdr/options/interpolation/cubic_spline.h>
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -56,6 +57,9 @@ Expect<void, Error> CubicSplineInterpolator::InitState(void* ptr, std::span<cons
         c_row[j].b = (ys[j + 1] - ys[j]) / h[j] - h[j] * (c_row[j + 1].c + 2 * c_row[j].c) / 3;
         c_row[j].d = (c_row[j + 1].c - c_row[j].c) / (3 * h[j]);
     }
+    // The last node is only evaluated at dx = 0, keep it well defined
+    c_row[n - 1].b = c_row[n - 2].b + h[n - 2] * (2 * c_row[n - 2].c + 3 * h[n - 2] * c_row[n - 2].d);
+    c_row[n - 1].d = 0.;
     return Ok();
 }
 
@@ -81,4 +85,50 @@ Expect<f64, Error> CubicSplineInterpolator::Evaluate(const void* ptr, std::span<
     return Ok(res);
 }
 
+/* static */
+void CubicSplineInterpolator::EvaluateMany(const void* ptr, std::span<const f64> xs, std::span<const f64> x,
+                                           std::span<f64> y) noexcept {
+    auto* c_row = static_cast<const SplineCoefficients*>(ptr);
+
+    // As in QuadraticSplineInterpolator::EvaluateMany: gather, then a
+    // vectorizable polynomial over columns
+    constexpr u64 kBlock = 64;
+    f64 dx[kBlock];
+    f64 a[kBlock];
+    f64 b[kBlock];
+    f64 c[kBlock];
+    f64 d[kBlock];
+
+    u64 hint = 0;
+    f64 previous = -std::numeric_limits<f64>::infinity();
+
+    for (u64 first = 0; first < x.size(); first += kBlock) {
+        const u64 size = std::min(kBlock, x.size() - first);
+        for (u64 j = 0; j < size; ++j) {
+            const f64 point = x[first + j];
+            if (xs.empty() || !(point >= xs.front() && point <= xs.back())) [[unlikely]] {
+                dx[j] = b[j] = c[j] = d[j] = 0.;
+                a[j] = std::numeric_limits<f64>::quiet_NaN();
+                continue;
+            }
+            if (point < previous) {
+                hint = 0;
+            }
+            const u64 upper = std::upper_bound(xs.begin() + hint, xs.end(), point) - xs.begin();
+            hint = upper;
+            previous = point;
+
+            const auto& coeffs = c_row[upper - 1];
+            dx[j] = point - xs[upper - 1];
+            a[j] = coeffs.a;
+            b[j] = coeffs.b;
+            c[j] = coeffs.c;
+            d[j] = coeffs.d;
+        }
+        for (u64 j = 0; j < size; ++j) {
+            y[first + j] = a[j] + b[j] * dx[j] + c[j] * dx[j]*dx[j] + d[j] * dx[j]*dx[j]*dx[j];
+        }
+    }
+}
+
 }
@@ -1,7 +1,7 @@
 #pragma once
 
 #include <cdr/types/types.h>
-// #include <cdr/options/interpolation/concept.h>
+#include <cdr/options/interpolation/concept.h>
 #include <cdr/types/errors.h>
 #include <cdr/types/expect.h>
 
@@ -44,6 +44,10 @@ public:
     }
 
     [[nodiscard]] static Expect<f64, Error> Evaluate(const void* coefs_ptr, std::span<const f64> xs, f64 x) noexcept;
+
+    // Evaluate of every x into y, NaN outside of xs. Fastest with increasing x.
+    static void EvaluateMany(const void* coefs_ptr, std::span<const f64> xs, std::span<const f64> x,
+                             std::span<f64> y) noexcept;
 };
 
 }  // namespace cdr
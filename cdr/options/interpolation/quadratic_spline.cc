@@ -1,6 +1,7 @@
 #include <cdr/options/interpolation/quadratic_spline.h>
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 
 
@@ -77,4 +78,49 @@ Expect<f64, Error> QuadraticSplineInterpolator::Evaluate(const void* ptr, std::s
     return Ok(res);
 }
 
+/* static */
+void QuadraticSplineInterpolator::EvaluateMany(const void* ptr, std::span<const f64> xs, std::span<const f64> x,
+                                               std::span<f64> y) noexcept {
+    auto* c_row = static_cast<const SplineCoefficients*>(ptr);
+
+    // Segment lookup gathers the coefficients into columns, so the polynomial
+    // runs over plain arrays and vectorizes
+    constexpr u64 kBlock = 64;
+    f64 dx[kBlock];
+    f64 smile[kBlock];
+    f64 skew[kBlock];
+    f64 base_level[kBlock];
+
+    // Search starts from the previous segment while x increases
+    u64 hint = 0;
+    f64 previous = -std::numeric_limits<f64>::infinity();
+
+    for (u64 first = 0; first < x.size(); first += kBlock) {
+        const u64 size = std::min(kBlock, x.size() - first);
+        for (u64 i = 0; i < size; ++i) {
+            const f64 point = x[first + i];
+            if (xs.empty() || !(point >= xs.front() && point <= xs.back())) [[unlikely]] {
+                dx[i] = smile[i] = skew[i] = 0.;
+                base_level[i] = std::numeric_limits<f64>::quiet_NaN();
+                continue;
+            }
+            if (point < previous) {
+                hint = 0;
+            }
+            const u64 x_idx = std::lower_bound(xs.begin() + hint, xs.end(), point) - xs.begin();
+            hint = x_idx;
+            previous = point;
+
+            const auto& coeffs = c_row[x_idx];
+            dx[i] = point - xs[x_idx];
+            smile[i] = coeffs.smile;
+            skew[i] = coeffs.skew;
+            base_level[i] = coeffs.base_level;
+        }
+        for (u64 i = 0; i < size; ++i) {
+            y[first + i] = (smile[i] * dx[i] + skew[i]) * dx[i] + base_level[i];
+        }
+    }
+}
+
 }
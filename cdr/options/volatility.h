@@ -9,12 +9,16 @@
 #include <cdr/base/aligned_alloc.h>
 #include <cdr/base/hardware_interference_size.h>
 #include <algorithm>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <ranges>
 #include <map>
+#include <span>
 #include <vector>
 #include <cstring>
 #include "cdr/options/interpolation/sabr.h"
+#include <cdr/options/interpolation/concept.h>
 #include <cdr/options/interpolation/quadratic_spline.h>
 #include <cdr/options/interpolation/lerp.h>
 #include <cdr/options/interpolation/flat_forward.h>
@@ -213,8 +217,153 @@ public:
         });
     }
 
+    // Volatility of every (dates[i], strikes[i]) into vols[i]. errors[i] is
+    // empty on success and holds the error of Volatility otherwise, with a
+    // NaN in vols[i]. Queries are grouped by the expiry slice they fall in:
+    // a run of equal dates costs one time lookup, and each smile of the
+    // surface is evaluated once for all strikes of its slice, through
+    // EvaluateMany of the interpolation when it has one.
+    void Volatilities(std::span<const DateType> dates, std::span<const f64> strikes, std::span<f64> vols,
+                      std::span<std::optional<Error>> errors) const {
+        CDR_CHECK(dates.size() == strikes.size()) << "a date per strike";
+        BatchVolatility(strikes, vols, errors, [&](u64 i) -> const DateType& { return dates[i]; });
+    }
+
+    // Volatilities of one expiry on a strike grid
+    void Volatilities(const DateType& date, std::span<const f64> strikes, std::span<f64> vols,
+                      std::span<std::optional<Error>> errors) const {
+        BatchVolatility(strikes, vols, errors, [&](u64) -> const DateType& { return date; });
+    }
+
 private:
 
+    template<typename DateAt>
+    void BatchVolatility(std::span<const f64> strikes, std::span<f64> vols, std::span<std::optional<Error>> errors,
+                         DateAt&& date_at) const {
+        const u64 size = strikes.size();
+        CDR_CHECK(vols.size() >= size && errors.size() >= size) << "output spans are too short";
+
+        std::fill_n(vols.begin(), size, std::numeric_limits<f64>::quiet_NaN());
+        if (header_ptr_ == nullptr) [[unlikely]] {
+            std::fill_n(errors.begin(), size, Error::NoData);
+            return;
+        }
+
+        const auto strikes_span = Strikes();
+        const auto dates_span = Dates();
+        const u64 slices = dates_span.size();
+
+        // Clamped strike, time and slice of every query, failed queries go
+        // to slice `slices`
+        std::vector<f64> clamped(size);
+        std::vector<f64> times(size);
+        std::vector<u32> slice_of(size);
+        std::vector<u32> offsets(slices + 2, 0);
+
+        const DateType* last_date = nullptr;
+        f64 time = 0.;
+        u64 slice = 0;
+        bool time_failed = false;
+
+        for (u64 i = 0; i < size; ++i) {
+            errors[i].reset();
+            slice_of[i] = static_cast<u32>(slices);
+
+            f64 strike = strikes[i];
+            if (strike < strikes_span.front()) {
+                if (strike < strikes_span.front() - kStrikeEpsilon) {
+                    errors[i] = Error::StrikeExtrapolationNotAllowed;
+                }
+                strike = strikes_span.front();
+            } else if (strike > strikes_span.back()) {
+                if (strike > strikes_span.back() + kStrikeEpsilon) {
+                    errors[i] = Error::StrikeExtrapolationNotAllowed;
+                }
+                strike = strikes_span.back();
+            }
+
+            const DateType& date = date_at(i);
+            if (last_date == nullptr || date != *last_date) {
+                last_date = &date;
+                time = Period{Header().today, date}.Act365();
+                time_failed = time < dates_span.front() - kTimeEpsilon || time > dates_span.back() + kTimeEpsilon;
+                const auto date_it = std::ranges::lower_bound(dates_span, time);
+                slice = std::min<u64>(internal::IndexFromIterator(dates_span.begin(), slices, date_it), slices - 1);
+            }
+            if (!errors[i].has_value() && time_failed) {
+                errors[i] = Error::TimeExtrapolationNotAllowed;
+            }
+            if (!errors[i].has_value()) {
+                clamped[i] = strike;
+                times[i] = time;
+                slice_of[i] = static_cast<u32>(slice);
+            }
+            ++offsets[slice_of[i] + 1];
+        }
+
+        // Queries ordered by slice
+        for (u64 s = 0; s < slices; ++s) {
+            offsets[s + 1] += offsets[s];
+        }
+        std::vector<u32> order(offsets[slices]);
+        {
+            std::vector<u32> next(offsets.begin(), offsets.begin() + slices);
+            for (u64 i = 0; i < size; ++i) {
+                if (slice_of[i] < slices) {
+                    order[next[slice_of[i]]++] = static_cast<u32>(i);
+                }
+            }
+        }
+
+        std::vector<f64> slice_strikes;
+        std::vector<f64> near_vols;
+        std::vector<f64> far_vols;
+        for (u64 s = 0; s < slices; ++s) {
+            const std::span<const u32> queries(order.data() + offsets[s], offsets[s + 1] - offsets[s]);
+            if (queries.empty()) {
+                continue;
+            }
+
+            slice_strikes.resize(queries.size());
+            near_vols.resize(queries.size());
+            for (u64 q = 0; q < queries.size(); ++q) {
+                slice_strikes[q] = clamped[queries[q]];
+            }
+            EvaluateSmile(s, slice_strikes, near_vols);
+
+            // Same as InterpolateInTime: exact pillar times need one smile
+            const bool single = slices == 1;
+            const bool interpolate = !single && std::ranges::any_of(queries, [&](u32 i) {
+                return times[i] != dates_span[s];
+            });
+            if (interpolate) {
+                far_vols.resize(queries.size());
+                EvaluateSmile(s + 1, slice_strikes, far_vols);
+            }
+
+            for (u64 q = 0; q < queries.size(); ++q) {
+                const u32 i = queries[q];
+                if (!interpolate || times[i] == dates_span[s]) {
+                    vols[i] = near_vols[q];
+                } else {
+                    vols[i] = FlatForward(times[i], dates_span[s], near_vols[q], dates_span[s + 1], far_vols[q]);
+                }
+            }
+        }
+    }
+
+    void EvaluateSmile(u64 slice, std::span<const f64> strikes, std::span<f64> vols) const noexcept {
+        const auto strikes_span = Strikes();
+        const auto* coefficients = &spline_coefficients_ptr_[slice * header_ptr_->strikes_size];
+        if constexpr (BatchInterpolation<Interpolation>) {
+            Interpolation::EvaluateMany(coefficients, strikes_span, strikes, vols);
+        } else {
+            for (u64 i = 0; i < strikes.size(); ++i) {
+                vols[i] = Interpolation::Evaluate(coefficients, strikes_span, strikes[i]).OrCrashProgram();
+            }
+        }
+    }
+
     [[maybe_unused]] bool Reclaim() noexcept {
         if (!header_ptr_) {
             return false;
@@ -425,7 +574,7 @@ public:
                 row_raw_vols[strike_idx] = output_value;
             }
 
-            Interpolation::InitState(&states_ptr[date_idx * interp_state_aligned_size], strikes_, row_raw_vols)
+            Interpolation::InitState(&states_ptr[date_idx * strikes_size], strikes_, row_raw_vols)
                 .OrCrashProgram();
 
             // --- Precompute delta smile ---
@@ -501,7 +650,7 @@ public:
                 delta_raw_vols[d_idx] = target_vol;
             }
 
-            Interpolation::InitState(&delta_states_ptr[date_idx * delta_interp_state_aligned_size], pillar_deltas_, delta_raw_vols)
+            Interpolation::InitState(&delta_states_ptr[date_idx * deltas_size], pillar_deltas_, delta_raw_vols)
                 .OrCrashProgram();
 
             // --- Precompute delta smile ---
@@ -736,7 +885,25 @@ public:
         });
     }
 
+    // Batch Volatility as in the general surface. Runs of equal dates share
+    // the time lookup, the smile is evaluated point by point.
+    void Volatilities(std::span<const DateType> dates, std::span<const f64> strikes, std::span<f64> vols,
+                      std::span<std::optional<Error>> errors) const {
+        CDR_CHECK(dates.size() == strikes.size()) << "a date per strike";
+        BatchVolatility(strikes, vols, errors, [&](u64 i) -> const DateType& { return dates[i]; });
+    }
+
+    void Volatilities(const DateType& date, std::span<const f64> strikes, std::span<f64> vols,
+                      std::span<std::optional<Error>> errors) const {
+        BatchVolatility(strikes, vols, errors, [&](u64) -> const DateType& { return date; });
+    }
+
 private:
+    struct Slice {
+        f64 time;
+        u64 date_idx;
+    };
+
     [[maybe_unused]] bool Reclaim() noexcept {
         if (!header_ptr_) {
             return false;
@@ -805,8 +972,48 @@ private:
         return Lerp(delta, deltas[i - 1], vols[i - 1], deltas[i], vols[i]);
     }
 
-    template<typename F>
-    [[nodiscard]] Expect<f64, Error> InterpolateInTime(const DateType& date, F&& evaluate_at_idx) const noexcept {
+    template<typename DateAt>
+    void BatchVolatility(std::span<const f64> strikes, std::span<f64> vols, std::span<std::optional<Error>> errors,
+                         DateAt&& date_at) const {
+        const u64 size = strikes.size();
+        CDR_CHECK(vols.size() >= size && errors.size() >= size) << "output spans are too short";
+
+        const DateType* last_date = nullptr;
+        Expect<Slice, Error> slice = ErrorNoData();
+        for (u64 i = 0; i < size; ++i) {
+            vols[i] = std::numeric_limits<f64>::quiet_NaN();
+            errors[i].reset();
+            if (header_ptr_ == nullptr || header_ptr_->dates_size == 0) [[unlikely]] {
+                errors[i] = Error::NoData;
+                continue;
+            }
+
+            f64 strike = strikes[i];
+            if (strike <= 0.0) [[unlikely]] {
+                if (strike < -kStrikeEpsilon) {
+                    errors[i] = Error::StrikeExtrapolationNotAllowed;
+                    continue;
+                }
+                strike = kStrikeEpsilon;
+            }
+
+            const DateType& date = date_at(i);
+            if (last_date == nullptr || date != *last_date) {
+                last_date = &date;
+                slice = FindSlice(date);
+            }
+            if (slice.Failed()) {
+                errors[i] = slice.GetFailure();
+                continue;
+            }
+            vols[i] = InterpolateInSlice(slice.Value(), [&](u64 idx) {
+                const auto& p = states_ptr_[idx];
+                return Interpolation::CalculateHagan<f64>(strike, p.F, p.T, p.alpha, p.rho, p.nu);
+            });
+        }
+    }
+
+    [[nodiscard]] Expect<Slice, Error> FindSlice(const DateType& date) const noexcept {
         const f64 target_time = Period{Header().today, date}.Act365();
         const auto dates_span = Dates();
 
@@ -815,12 +1022,19 @@ private:
         }
 
         auto date_it = std::ranges::lower_bound(dates_span, target_time);
-        u64 date_idx = internal::IndexFromIterator(dates_span.begin(), dates_span.size(), date_it);
+        return Ok(Slice{target_time, internal::IndexFromIterator(dates_span.begin(), dates_span.size(), date_it)});
+    }
+
+    template<typename F>
+    [[nodiscard]] f64 InterpolateInSlice(const Slice& slice, F&& evaluate_at_idx) const noexcept {
+        const auto dates_span = Dates();
+        const f64 target_time = slice.time;
+        const u64 date_idx = slice.date_idx;
 
         const f64 v1 = evaluate_at_idx(date_idx);
 
         if (dates_span[date_idx] == target_time || dates_span.size() == 1) {
-            return Ok<f64>(v1);
+            return v1;
         }
 
         const f64 v2 = evaluate_at_idx(date_idx + 1);
@@ -832,7 +1046,16 @@ private:
         const f64 w2 = v2 * v2 * t2;
 
         const f64 w = w1 + (w2 - w1) * (target_time - t1) / (t2 - t1);
-        return Ok(std::sqrt(std::max(w / target_time, 0.0)));
+        return std::sqrt(std::max(w / target_time, 0.0));
+    }
+
+    template<typename F>
+    [[nodiscard]] Expect<f64, Error> InterpolateInTime(const DateType& date, F&& evaluate_at_idx) const noexcept {
+        const auto slice = FindSlice(date);
+        if (slice.Failed()) [[unlikely]] {
+            return Failure(slice.GetFailure());
+        }
+        return Ok(InterpolateInSlice(slice.Value(), std::forward<F>(evaluate_at_idx)));
     }
 
 private:
@@ -3,14 +3,41 @@
 #include <cdr/curve/curve.h>
 #include <cdr/curve/interpolation/linear.h>
 #include <cdr/options/helpers.h>  // Для FxOptionDelta
+#include <cdr/options/interpolation/cubic_spline.h>
 #include <cdr/options/volatility.h>
 #include <gtest/gtest.h>
 
 #include <cmath>
+#include <optional>
+#include <vector>
 
 using namespace std::chrono;
 using cdr::Percent;
 
+namespace {
+
+// Batch queries must give what Volatility gives point by point
+template <typename Surface>
+void ExpectBatchMatchesScalar(const Surface& surface, const std::vector<DateType>& dates,
+                              const std::vector<double>& strikes) {
+    std::vector<double> vols(dates.size());
+    std::vector<std::optional<cdr::Error>> errors(dates.size());
+    surface.Volatilities(dates, strikes, vols, errors);
+
+    for (size_t i = 0; i < dates.size(); ++i) {
+        const auto expected = surface.Volatility(dates[i], strikes[i]);
+        if (expected.Succeed()) {
+            ASSERT_FALSE(errors[i].has_value()) << i;
+            EXPECT_DOUBLE_EQ(vols[i], expected.Value()) << i;
+        } else {
+            ASSERT_EQ(errors[i], expected.GetFailure()) << i;
+            EXPECT_TRUE(std::isnan(vols[i])) << i;
+        }
+    }
+}
+
+}  // anonymous namespace
+
 TEST(VolatilitySurface, DeltaInterpolationConsistency) {
     cdr::HolidayStorage hs;
     hs.StaticInit()("USD", day(1) / January / year(2026))("EUR", day(1) / January / year(2026));
@@ -83,6 +110,117 @@ TEST(VolatilitySurface, DeltaInterpolationConsistency) {
     EXPECT_TRUE(surface.VolatilityByDelta(expiry, -0.95).Failed());
 }
 
+// Smiles of every expiry are precomputed into one buffer, each must land in
+// its own row
+TEST(VolatilitySurface, SeveralExpiries) {
+    cdr::HolidayStorage hs;
+    hs.StaticInit()("USD", day(1) / January / year(2026))("EUR", day(1) / January / year(2026));
+
+    DateType today = day(1) / January / year(2026);
+    cdr::MarketContext context(std::move(hs), today);
+
+    constexpr double rd_rate = 0.05;
+    constexpr double rf_rate = 0.02;
+    constexpr double spot = 1.10;
+
+    auto domestic = cdr::CurveBuilder(context)
+                        .Jurisdiction("USD")
+                        .Add(day(1) / January / year(2027), Percent::FromPercentage(rd_rate * 100))
+                        .FromPoints();
+    auto foreign = cdr::CurveBuilder(context)
+                       .Jurisdiction("EUR")
+                       .Add(day(1) / January / year(2027), Percent::FromPercentage(rf_rate * 100))
+                       .FromPoints();
+
+    const std::vector<DateType> expiries = {day(1) / February / year(2026), day(1) / April / year(2026),
+                                            day(1) / July / year(2026), day(1) / January / year(2027)};
+    const std::vector<double> strikes = {0.80, 0.90, 1.00, 1.10, 1.20, 1.30, 1.45};
+    auto pillar_vol = [](size_t e, double strike) {
+        return 0.10 + 0.02 * static_cast<double>(e) + 0.4 * (strike - 1.10) * (strike - 1.10);
+    };
+
+    cdr::VolatilitySurfaceProvider provider(today);
+    for (size_t e = 0; e < expiries.size(); ++e) {
+        for (double strike : strikes) {
+            provider.AddPillar(expiries[e], strike, pillar_vol(e, strike)).OrCrashProgram();
+        }
+    }
+    const std::vector<double> pillar_deltas = {-0.25, 0.25};
+    for (double d : pillar_deltas) {
+        provider.AddPillarDelta(d).OrCrashProgram();
+    }
+    ASSERT_TRUE(provider.UpdateSnapshot(spot, *domestic, *foreign).Succeed());
+    auto surface = provider.ProvideSnapshot().Value();
+
+    for (size_t e = 0; e < expiries.size(); ++e) {
+        const DateType expiry = expiries[e];
+
+        // The smile of an expiry goes through its own pillars
+        for (double strike : strikes) {
+            auto vol = surface.Volatility(expiry, strike);
+            ASSERT_TRUE(vol.Succeed()) << e << " " << strike;
+            EXPECT_NEAR(vol.Value(), pillar_vol(e, strike), 1e-12) << e << " " << strike;
+        }
+
+        // and its delta smile matches it
+        const double T = cdr::Period{today, expiry}.Act365();
+        for (double target_delta : pillar_deltas) {
+            auto vol_by_delta = surface.VolatilityByDelta(expiry, target_delta);
+            ASSERT_TRUE(vol_by_delta.Succeed()) << e << " " << target_delta;
+
+            const cdr::OptionType type = target_delta > 0 ? cdr::OptionType::CALL : cdr::OptionType::PUT;
+            auto objective = [&](double K) {
+                const double v = surface.Volatility(expiry, K).Value();
+                return cdr::FxOptionDelta(spot, K, rd_rate, rf_rate, v, T, type) - target_delta;
+            };
+            auto solved = cdr::FindRoot(objective, strikes.front(), strikes.back(), spot);
+            ASSERT_TRUE(solved.Succeed()) << e << " " << target_delta;
+            EXPECT_NEAR(vol_by_delta.Value(), surface.Volatility(expiry, solved.Value()).Value(), 1e-6)
+                << e << " " << target_delta;
+        }
+    }
+}
+
+// The last strike is a spline node of its own, evaluated with dx = 0
+TEST(VolatilitySurface, CubicSplineTopStrike) {
+    cdr::HolidayStorage hs;
+    hs.StaticInit()("USD", day(1) / January / year(2026))("EUR", day(1) / January / year(2026));
+
+    DateType today = day(1) / January / year(2026);
+    cdr::MarketContext context(std::move(hs), today);
+
+    auto domestic = cdr::CurveBuilder(context)
+                        .Jurisdiction("USD")
+                        .Add(day(1) / July / year(2026), Percent::FromPercentage(5))
+                        .FromPoints();
+    auto foreign = cdr::CurveBuilder(context)
+                       .Jurisdiction("EUR")
+                       .Add(day(1) / July / year(2026), Percent::FromPercentage(2))
+                       .FromPoints();
+
+    const DateType expiry = day(1) / April / year(2026);
+    const std::vector<double> strikes = {0.90, 1.00, 1.10, 1.20, 1.30};
+    const std::vector<double> vols = {0.25, 0.18, 0.15, 0.19, 0.24};
+
+    cdr::VolatilitySurfaceProvider<cdr::CubicSplineInterpolator> provider(today);
+    for (size_t i = 0; i < strikes.size(); ++i) {
+        provider.AddPillar(expiry, strikes[i], vols[i]).OrCrashProgram();
+    }
+    provider.AddPillarDelta(-0.25).OrCrashProgram();
+    provider.AddPillarDelta(0.25).OrCrashProgram();
+
+    ASSERT_TRUE(provider.UpdateSnapshot(1.10, *domestic, *foreign).Succeed());
+    auto surface = provider.ProvideSnapshot().Value();
+
+    auto top = surface.Volatility(expiry, strikes.back());
+    ASSERT_TRUE(top.Succeed());
+    EXPECT_NEAR(top.Value(), vols.back(), 1e-12);
+
+    auto bottom = surface.Volatility(expiry, strikes.front());
+    ASSERT_TRUE(bottom.Succeed());
+    EXPECT_NEAR(bottom.Value(), vols.front(), 1e-12);
+}
+
 TEST(SABRVolatilitySurface, DeltaInterpolationConsistency) {
     cdr::HolidayStorage hs;
     hs.StaticInit()("USD", day(1) / January / year(2026))("EUR", day(1) / January / year(2026));
@@ -187,6 +325,89 @@ TEST(SABRVolatilitySurface, DeltaInterpolationConsistency) {
     //
     EXPECT_TRUE(surface.VolatilityByDelta(expiry, 0.95).Failed());
     EXPECT_TRUE(surface.VolatilityByDelta(expiry, -0.95).Failed());
+
+    std::vector<DateType> dates(strikes.size() + 2, expiry);
+    std::vector<double> queries = strikes;
+    queries.push_back(1.12);
+    queries.push_back(2.);
+    ExpectBatchMatchesScalar(surface, dates, queries);
 }
 
+template <typename Interpolation>
+void CheckBatchVolatilities() {
+    cdr::HolidayStorage hs;
+    hs.StaticInit()("USD", day(1) / January / year(2026))("EUR", day(1) / January / year(2026));
+
+    DateType today = day(1) / January / year(2026);
+    cdr::MarketContext context(std::move(hs), today);
+
+    auto domestic = cdr::CurveBuilder(context)
+                        .Jurisdiction("USD")
+                        .Add(day(1) / January / year(2027), Percent::FromPercentage(5.))
+                        .FromPoints();
+    auto foreign = cdr::CurveBuilder(context)
+                       .Jurisdiction("EUR")
+                       .Add(day(1) / January / year(2027), Percent::FromPercentage(2.))
+                       .FromPoints();
+
+    const std::vector<DateType> expiries = {day(1) / February / year(2026), day(1) / May / year(2026),
+                                            day(1) / November / year(2026)};
+    cdr::VolatilitySurfaceProvider<Interpolation> provider(today);
+    for (size_t e = 0; e < expiries.size(); ++e) {
+        for (double strike : {0.90, 1.00, 1.10, 1.20, 1.30}) {
+            const double vol = 0.12 + 0.01 * static_cast<double>(e) + 0.3 * (strike - 1.10) * (strike - 1.10);
+            provider.AddPillar(expiries[e], strike, vol).OrCrashProgram();
+        }
+    }
+    for (double d : {-0.25, -0.10, 0.10, 0.25}) {
+        provider.AddPillarDelta(d).OrCrashProgram();
+    }
+    ASSERT_TRUE(provider.UpdateSnapshot(1.10, *domestic, *foreign).Succeed());
+    auto surface = provider.ProvideSnapshot().Value();
+
+    // Expiries on, between, before and after the pillars, in no order, with
+    // strikes inside, at and beyond the edges of the smile
+    std::vector<DateType> dates;
+    std::vector<double> strikes;
+    const std::vector<DateType> query_dates = {
+        day(1) / May / year(2026), day(15) / March / year(2026), day(1) / February / year(2026),
+        day(20) / January / year(2026), day(1) / November / year(2026), day(1) / December / year(2026),
+        day(2) / August / year(2026), day(15) / March / year(2026),
+    };
+    for (size_t d = 0; d < query_dates.size(); ++d) {
+        for (double strike : {1.25, 0.90, 0.97, 1.10, 1.30 + 0.5e-4, 1.05, 1.31, 0.85, 1.18}) {
+            dates.push_back(query_dates[d]);
+            strikes.push_back(strike + 0.001 * static_cast<double>(d % 3));
+        }
+    }
+    ExpectBatchMatchesScalar(surface, dates, strikes);
 
+    // One expiry on a strike grid
+    std::vector<double> grid;
+    for (double strike = 0.85; strike < 1.35; strike += 0.005) {
+        grid.push_back(strike);
+    }
+    std::vector<double> vols(grid.size());
+    std::vector<std::optional<cdr::Error>> errors(grid.size());
+    const DateType expiry = day(15) / July / year(2026);
+    surface.Volatilities(expiry, grid, vols, errors);
+    for (size_t i = 0; i < grid.size(); ++i) {
+        const auto expected = surface.Volatility(expiry, grid[i]);
+        ASSERT_EQ(errors[i].has_value(), expected.Failed()) << grid[i];
+        if (expected.Succeed()) {
+            EXPECT_DOUBLE_EQ(vols[i], expected.Value()) << grid[i];
+        }
+    }
+
+    // A moved from surface fails every query
+    const auto moved = std::move(surface);
+    std::vector<double> no_vols(1);
+    std::vector<std::optional<cdr::Error>> no_data(1);
+    surface.Volatilities(expiry, std::vector<double>{1.}, no_vols, no_data);
+    ASSERT_EQ(no_data[0], cdr::Error::NoData);
+}
+
+TEST(VolatilitySurface, BatchVolatilities) {
+    CheckBatchVolatilities<cdr::QuadraticSplineInterpolator>();
+    CheckBatchVolatilities<cdr::CubicSplineInterpolator>();
+}
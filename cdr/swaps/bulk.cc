@@ -0,0 +1,94 @@
+#include <cdr/swaps/bulk.h>
+
+#include <cdr/base/check.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace cdr {
+
+void IrsTradeTable::Reserve(u64 trades) {
+    settlement_dates.reserve(trades);
+    maturity_dates.reserve(trades);
+    fixed_freqs.reserve(trades);
+    float_freqs.reserve(trades);
+    fixed_rates.reserve(trades);
+    adjustments.reserve(trades);
+    notionals.reserve(trades);
+    paying_fix.reserve(trades);
+}
+
+void IrsTradeTable::Add(const DateType& settlement, const DateType& maturity, Freq fixed_freq, Freq float_freq,
+                        Percent fixed_rate, Percent adjustment, f64 notional, bool pay_fix) {
+    settlement_dates.push_back(settlement);
+    maturity_dates.push_back(maturity);
+    fixed_freqs.push_back(fixed_freq);
+    float_freqs.push_back(float_freq);
+    fixed_rates.push_back(fixed_rate);
+    adjustments.push_back(adjustment);
+    notionals.push_back(notional);
+    paying_fix.push_back(pay_fix ? 1 : 0);
+}
+
+namespace {
+
+// `build(builder)` finishes a filled IrsBuilder
+template <typename Build>
+[[nodiscard]] std::vector<IrsContract> BuildRows(ThreadPool& pool, const IrsTradeTable& table, u64 grain,
+                                                 Build&& build) {
+    const u64 size = table.Size();
+    CDR_CHECK(table.maturity_dates.size() == size && table.fixed_freqs.size() == size
+              && table.float_freqs.size() == size && table.fixed_rates.size() == size
+              && table.adjustments.size() == size && table.notionals.size() == size
+              && table.paying_fix.size() == size) << "trade table columns must have the same size";
+
+    grain = std::max<u64>(grain, 1);
+    std::vector<std::vector<IrsContract>> chunks((size + grain - 1) / grain);
+
+    pool.ParallelFor(0, size, grain, [&](u64 first, u64 last) {
+        auto& chunk = chunks[first / grain];
+        chunk.reserve(last - first);
+
+        IrsBuilder builder;
+        for (u64 row = first; row < last; ++row) {
+            chunk.push_back(build(builder
+                .SettlementDate(table.settlement_dates[row])
+                .MaturityDate(table.maturity_dates[row])
+                .FixedFreq(table.fixed_freqs[row])
+                .FloatFreq(table.float_freqs[row])
+                .FixedRate(table.fixed_rates[row])
+                .Adjustment(table.adjustments[row])
+                .Notion(table.notionals[row])
+                .PayFix(table.paying_fix[row] != 0)
+            ));
+        }
+    });
+
+    std::vector<IrsContract> result;
+    result.reserve(size);
+    for (auto& chunk : chunks) {
+        std::move(chunk.begin(), chunk.end(), std::back_inserter(result));
+    }
+    return result;
+}
+
+}  // namespace
+
+[[nodiscard]] std::vector<IrsContract> BuildIrsContracts(ThreadPool& pool, const IrsTradeTable& table,
+                                                         const HolidayStorage& hs, const JurisdictionType& jur,
+                                                         DateRollingRule rule, u64 grain) {
+    return BuildRows(pool, table, grain, [&](IrsBuilder& builder) {
+        return builder.Build(hs, jur, rule);
+    });
+}
+
+[[nodiscard]] std::vector<IrsContract> BuildIrsContracts(ThreadPool& pool, IrsScheduleCache& cache,
+                                                         const IrsTradeTable& table, const HolidayStorage& hs,
+                                                         const JurisdictionType& jur, DateRollingRule rule,
+                                                         u64 grain) {
+    return BuildRows(pool, table, grain, [&](IrsBuilder& builder) {
+        return builder.Build(cache, hs, jur, rule);
+    });
+}
+
+}  // namespace cdr
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cdr/swaps/irs.h>
+#include <cdr/base/thread_pool.h>
+#include <cdr/calendar/date.h>
+#include <cdr/calendar/freq.h>
+#include <cdr/calendar/holiday_storage.h>
+#include <cdr/types/integers.h>
+#include <cdr/types/floats.h>
+#include <cdr/types/percent.h>
+#include <cdr/swaps/internal/export.h>
+
+#include <vector>
+
+namespace cdr {
+
+// Columnar table of IrsBuilder parameters, one row per trade
+struct IrsTradeTable {
+    std::vector<DateType> settlement_dates;
+    std::vector<DateType> maturity_dates;
+    std::vector<Freq> fixed_freqs;
+    std::vector<Freq> float_freqs;
+    std::vector<Percent> fixed_rates;
+    std::vector<Percent> adjustments;
+    std::vector<f64> notionals;
+    std::vector<u8> paying_fix;
+
+    [[nodiscard]] u64 Size() const noexcept {
+        return settlement_dates.size();
+    }
+
+    void Reserve(u64 trades);
+
+    void Add(const DateType& settlement, const DateType& maturity, Freq fixed_freq, Freq float_freq,
+             Percent fixed_rate, Percent adjustment, f64 notional, bool pay_fix);
+};
+
+inline constexpr u64 kDefaultBuildGrain = 256;
+
+// Builds one IrsContract per row of `table` (same as IrsBuilder::Build) in
+// parallel on `pool`. Contracts are returned in row order.
+[[nodiscard]] CDR_SWAPS_EXPORT std::vector<IrsContract> BuildIrsContracts(
+    ThreadPool& pool, const IrsTradeTable& table, const HolidayStorage& hs, const JurisdictionType& jur,
+    DateRollingRule rule = DateRollingRule::kFollowing, u64 grain = kDefaultBuildGrain);
+
+// Same, but rows with equal schedule terms share one schedule from `cache`
+[[nodiscard]] CDR_SWAPS_EXPORT std::vector<IrsContract> BuildIrsContracts(
+    ThreadPool& pool, IrsScheduleCache& cache, const IrsTradeTable& table, const HolidayStorage& hs,
+    const JurisdictionType& jur, DateRollingRule rule = DateRollingRule::kFollowing,
+    u64 grain = kDefaultBuildGrain);
+
+}  // namespace cdr
@@ -0,0 +1,338 @@
+#include <cdr/swaps/exposure.h>
+#include <cdr/swaps/internal/projection.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <cdr/base/check.h>
+
+namespace cdr {
+
+namespace {
+
+// Initial discount factor at `day` with the rate read at `curve_day`, the
+// discounting SwapPortfolio::Price uses
+[[nodiscard]] f64 InitialDiscountFactor(const CurveGrid& grid, i32 day, i32 curve_day) noexcept {
+    return internal::DiscountFactor<f64>(grid.Rate(curve_day), grid.Time(day));
+}
+
+}  // namespace
+
+/* HullWhite */
+
+HullWhite::HullWhite(const CurveGrid& grid, HullWhiteParams params)
+    : grid_(&grid)
+    , params_(params)
+{
+    CDR_CHECK(params_.mean_reversion > 0.) << "mean reversion must be positive";
+    CDR_CHECK(params_.volatility >= 0.) << "volatility must be non-negative";
+}
+
+[[nodiscard]] f64 HullWhite::B(f64 t, f64 maturity) const noexcept {
+    const f64 a = params_.mean_reversion;
+    return -std::expm1(-a * (maturity - t)) / a;
+}
+
+[[nodiscard]] f64 HullWhite::C(f64 t, f64 maturity) const noexcept {
+    const f64 a = params_.mean_reversion;
+    const f64 variance = params_.volatility * params_.volatility;
+    const f64 b = B(t, maturity);
+    const f64 decay = -std::expm1(-a * t);
+    return -variance * -std::expm1(-2. * a * t) * b * b / (4. * a) - variance * decay * decay * b / (2. * a * a);
+}
+
+[[nodiscard]] f64 HullWhite::ZeroBond(i32 day, i32 curve_day, i32 maturity_day, i32 maturity_curve_day,
+                                      f64 x) const noexcept {
+    const f64 t = grid_->Time(day);
+    const f64 maturity = grid_->Time(maturity_day);
+    const f64 initial_ratio =
+        InitialDiscountFactor(*grid_, maturity_day, maturity_curve_day) / InitialDiscountFactor(*grid_, day, curve_day);
+    return initial_ratio * std::exp(C(t, maturity) - B(t, maturity) * x);
+}
+
+[[nodiscard]] f64 HullWhite::Decay(f64 dt) const noexcept {
+    return std::exp(-params_.mean_reversion * dt);
+}
+
+[[nodiscard]] f64 HullWhite::StdDev(f64 dt) const noexcept {
+    const f64 a = params_.mean_reversion;
+    return params_.volatility * std::sqrt(-std::expm1(-2. * a * dt) / (2. * a));
+}
+
+[[nodiscard]] HullWhitePaths SimulateHullWhite(ThreadPool& pool, const HullWhite& model,
+                                               std::span<const i32> days, u64 paths, u64 seed, u64 grain) {
+    HullWhitePaths result;
+    result.steps = days.size();
+    result.paths = paths;
+    result.states.resize(days.size() * paths);
+
+    std::vector<f64> decays(days.size());
+    std::vector<f64> deviations(days.size());
+    f64 previous = 0.;
+    for (u64 step = 0; step < days.size(); ++step) {
+        const f64 time = model.Grid().Time(days[step]);
+        CDR_CHECK(time >= previous) << "simulation days must be increasing and not before today";
+        decays[step] = model.Decay(time - previous);
+        deviations[step] = model.StdDev(time - previous);
+        previous = time;
+    }
+
+    pool.ParallelFor(0, paths, std::max<u64>(grain, 1), [&](u64 first, u64 last) {
+        for (u64 path = first; path < last; ++path) {
+            // seed_seq keeps the low 32 bits of every word, so both 64-bit
+            // values enter as two words each
+            std::seed_seq seq{static_cast<u32>(seed), static_cast<u32>(seed >> 32),
+                              static_cast<u32>(path), static_cast<u32>(path >> 32)};
+            std::mt19937_64 engine(seq);
+            std::normal_distribution<f64> normal;
+
+            f64 x = 0.;
+            for (u64 step = 0; step < days.size(); ++step) {
+                x = x * decays[step] + deviations[step] * normal(engine);
+                result.states[step * paths + path] = x;
+            }
+        }
+    });
+
+    return result;
+}
+
+/* ExposureEngine */
+
+// Revalues a SwapPortfolio on simulated paths with the conventions of
+// SwapPortfolio::Price, the exposure date playing the role of today.
+//
+// Zero bonds are only needed on the days the book refers to, so these days
+// are collected once into slots. Per exposure date B and C are tabulated per
+// slot and shared by all paths, per path the bonds of every slot are
+// reconstructed with one exp and shared by all trades.
+class ExposureEngine final {
+public:
+    ExposureEngine(const SwapPortfolio& book, const HullWhite& model, std::span<const i32> days)
+        : book_(book)
+        , grid_(model.Grid())
+        , days_(days)
+    {
+        auto add_days = [&](const std::vector<i32>& column) {
+            slot_days_.insert(slot_days_.end(), column.begin(), column.end());
+        };
+        add_days(book_.since_days_);
+        add_days(book_.until_days_);
+        add_days(book_.pay_days_);
+        std::sort(slot_days_.begin(), slot_days_.end());
+        slot_days_.erase(std::unique(slot_days_.begin(), slot_days_.end()), slot_days_.end());
+
+        slots_.assign(static_cast<u64>(grid_.LastDay() - grid_.FirstDay()) + 1, 0);
+        for (u32 slot = 0; slot < slot_days_.size(); ++slot) {
+            slots_[static_cast<u64>(slot_days_[slot] - grid_.FirstDay())] = slot;
+        }
+
+        b_.resize(days_.size() * slot_days_.size());
+        c_.resize(days_.size() * slot_days_.size());
+        for (u64 step = 0; step < days_.size(); ++step) {
+            const f64 t = grid_.Time(days_[step]);
+            for (u64 slot = 0; slot < slot_days_.size(); ++slot) {
+                const f64 maturity = grid_.Time(slot_days_[slot]);
+                b_[step * slot_days_.size() + slot] = model.B(t, maturity);
+                c_[step * slot_days_.size() + slot] = model.C(t, maturity);
+            }
+        }
+    }
+
+    // Book value of every path in [first, last) on every exposure date
+    void Value(const HullWhitePaths& states, u64 first, u64 last, std::span<f64> values) const {
+        const u64 slots = slot_days_.size();
+        std::vector<f64> bonds(slots);
+        std::vector<f64> coupons(book_.CashflowsSize());
+
+        for (u64 path = first; path < last; ++path) {
+            // Periods started before the first exposure date fix on the
+            // initial curve
+            FixCoupons(std::numeric_limits<i32>::min(), days_.front(), coupons, [&](i32 day, i32 curve_day) {
+                return InitialDiscountFactor(grid_, day, curve_day);
+            });
+
+            for (u64 step = 0; step < days_.size(); ++step) {
+                const i32 step_day = days_[step];
+                const f64 x = states.At(step, path);
+                const f64* b = b_.data() + step * slots;
+                const f64* c = c_.data() + step * slots;
+
+                const u32 first_slot = static_cast<u32>(
+                    std::lower_bound(slot_days_.begin(), slot_days_.end(), step_day) - slot_days_.begin());
+                for (u64 slot = first_slot; slot < slots; ++slot) {
+                    bonds[slot] = std::exp(c[slot] - b[slot] * x);
+                }
+
+                // P(t, T) / P(0, T) * P(0, t): the initial discount factor of
+                // the cashflow times the bond adjustment of the path
+                const f64 inv_start = 1. / InitialDiscountFactor(grid_, step_day, step_day);
+                auto path_df = [&](i32 day, i32 curve_day) {
+                    return InitialDiscountFactor(grid_, day, curve_day) * bonds[Slot(day)] * inv_start;
+                };
+
+                values[step * states.paths + path] = ValueBook(step_day, coupons, path_df);
+
+                // Periods starting before the next exposure date fix on this
+                // one
+                const i32 next_day = step + 1 < days_.size() ? days_[step + 1] : step_day;
+                FixCoupons(step_day, next_day, coupons, path_df);
+            }
+        }
+    }
+
+private:
+    [[nodiscard]] u32 Slot(i32 day) const noexcept {
+        return slots_[static_cast<u64>(day - grid_.FirstDay())];
+    }
+
+    // Fixes unknown coupons of float periods with `since` in [from, to)
+    template <typename DiscountFn>
+    void FixCoupons(i32 from, i32 to, std::span<f64> coupons, DiscountFn&& df) const {
+        for (u64 trade = 0; trade < book_.Size(); ++trade) {
+            const u64 float_begin = book_.leg_offsets_[2 * trade + 1];
+            const u64 float_end = book_.leg_offsets_[2 * trade + 2];
+            const f64 notional = book_.notionals_[trade];
+            const f64 adjustment = book_.adjustments_[trade];
+
+            internal::ForwardProjector<f64, i32> projector;
+            for (u64 k = float_begin; k < float_end; ++k) {
+                const i32 since = book_.since_days_[k];
+                if (since < from || since >= to || !std::isnan(book_.known_payments_[k])) {
+                    continue;
+                }
+                const f64 forward = projector.Forward(since, book_.until_days_[k], book_.accruals_[k],
+                    [&] { return df(since, book_.projection_start_days_[k]); },
+                    [&] { return df(book_.until_days_[k], book_.projection_days_[k]); });
+                coupons[k] = (forward + adjustment) * notional;
+            }
+        }
+    }
+
+    template <typename DiscountFn>
+    [[nodiscard]] f64 ValueBook(i32 step_day, std::span<const f64> coupons, DiscountFn&& df) const {
+        const f64 step_time = grid_.Time(step_day);
+        auto discounted_time = [&](u64 k) {
+            const i32 pay_day = book_.pay_days_[k];
+            return (grid_.Time(pay_day) - step_time) * df(pay_day, book_.discount_days_[k]);
+        };
+        auto expired = [&](u64 k) {
+            return book_.until_days_[k] < step_day || book_.pay_days_[k] < step_day;
+        };
+
+        f64 total = 0.;
+        for (u64 trade = 0; trade < book_.Size(); ++trade) {
+            const u64 fixed_begin = book_.leg_offsets_[2 * trade];
+            const u64 float_begin = book_.leg_offsets_[2 * trade + 1];
+            const u64 float_end = book_.leg_offsets_[2 * trade + 2];
+            const f64 notional = book_.notionals_[trade];
+            const f64 adjustment = book_.adjustments_[trade];
+
+            f64 fixed_annuity = 0.;
+            for (u64 k = fixed_begin; k < float_begin; ++k) {
+                if (!expired(k)) {
+                    fixed_annuity += discounted_time(k);
+                }
+            }
+
+            f64 float_pv = 0.;
+            internal::ForwardProjector<f64, i32> projector;
+            for (u64 k = float_begin; k < float_end; ++k) {
+                if (expired(k)) {
+                    continue;
+                }
+                const i32 since = book_.since_days_[k];
+                f64 payment = book_.known_payments_[k];
+                if (std::isnan(payment)) {
+                    if (since < step_day) {
+                        payment = coupons[k];
+                    } else {
+                        const f64 forward = projector.Forward(since, book_.until_days_[k], book_.accruals_[k],
+                            [&] { return df(since, book_.projection_start_days_[k]); },
+                            [&] { return df(book_.until_days_[k], book_.projection_days_[k]); });
+                        payment = (forward + adjustment) * notional;
+                    }
+                }
+                float_pv += payment * discounted_time(k);
+            }
+
+            const f64 fixed_pv = fixed_annuity * book_.fixed_rates_[trade] * notional;
+            total += book_.signs_[trade] * (float_pv - fixed_pv);
+        }
+        return total;
+    }
+
+private:
+    const SwapPortfolio& book_;
+    const CurveGrid& grid_;
+    std::span<const i32> days_;
+
+    // distinct days of the book and slot of every grid day
+    std::vector<i32> slot_days_;
+    std::vector<u32> slots_;
+    // step-major B(t, T) and C(t, T) of every slot
+    std::vector<f64> b_;
+    std::vector<f64> c_;
+};
+
+/* SimulateExposure */
+
+[[nodiscard]] ExposureProfile SimulateExposure(ThreadPool& pool, const SwapPortfolio& book, const Curve& curve,
+                                               const ExposureSettings& settings) {
+    CDR_CHECK(!settings.dates.empty()) << "no exposure dates";
+    CDR_CHECK(settings.paths > 0) << "no paths to simulate";
+    CDR_CHECK(settings.pfe_quantile >= 0. && settings.pfe_quantile <= 1.) << "quantile must be in [0, 1]";
+
+    const i32 today_day = DaysSinceEpoch(curve.Today());
+
+    std::vector<i32> days;
+    days.reserve(settings.dates.size());
+    for (const auto& date : settings.dates) {
+        const i32 day = DaysSinceEpoch(date);
+        CDR_CHECK(day >= today_day && (days.empty() || day > days.back()))
+            << "exposure dates must be increasing and not before today";
+        days.push_back(day);
+    }
+
+    ExposureProfile profile;
+    profile.dates = settings.dates;
+    profile.paths = settings.paths;
+    profile.values.assign(days.size() * settings.paths, 0.);
+    profile.expected_exposure.assign(days.size(), 0.);
+    profile.potential_future_exposure.assign(days.size(), 0.);
+
+    if (book.Empty()) [[unlikely]] {
+        return profile;
+    }
+
+    const auto grid = CurveGrid::Build(curve, book.FirstDay(today_day), std::max(book.LastDay(today_day), days.back()));
+    const HullWhite model(grid, settings.model);
+    const auto states = SimulateHullWhite(pool, model, days, settings.paths, settings.seed, settings.grain);
+
+    const ExposureEngine engine(book, model, days);
+    pool.ParallelFor(0, settings.paths, std::max<u64>(settings.grain, 1), [&](u64 first, u64 last) {
+        engine.Value(states, first, last, profile.values);
+    });
+
+    pool.ParallelFor(0, days.size(), 1, [&](u64 first, u64 last) {
+        std::vector<f64> exposures(settings.paths);
+        for (u64 step = first; step < last; ++step) {
+            f64 sum = 0.;
+            for (u64 path = 0; path < settings.paths; ++path) {
+                exposures[path] = std::max(profile.Value(step, path), 0.);
+                sum += exposures[path];
+            }
+            profile.expected_exposure[step] = sum / static_cast<f64>(settings.paths);
+
+            const f64 rank = std::ceil(settings.pfe_quantile * static_cast<f64>(settings.paths));
+            const u64 idx = std::min<u64>(rank > 0. ? static_cast<u64>(rank) - 1 : 0, settings.paths - 1);
+            std::nth_element(exposures.begin(), exposures.begin() + static_cast<i64>(idx), exposures.end());
+            profile.potential_future_exposure[step] = exposures[idx];
+        }
+    });
+
+    return profile;
+}
+
+}  // namespace cdr
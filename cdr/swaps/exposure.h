@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cdr/swaps/portfolio.h>
+#include <cdr/base/thread_pool.h>
+#include <cdr/calendar/date.h>
+#include <cdr/curve/curve.h>
+#include <cdr/types/integers.h>
+#include <cdr/types/floats.h>
+#include <cdr/swaps/internal/export.h>
+
+#include <span>
+#include <vector>
+
+namespace cdr {
+
+struct HullWhiteParams {
+    f64 mean_reversion = 0.03;
+    f64 volatility = 0.01;
+};
+
+// One-factor Hull-White short rate r(t) = x(t) + alpha(t), where
+//
+//   dx = -a x dt + sigma dW,  x(0) = 0
+//
+// and alpha(t) fits the initial term structure exactly. Initial discount
+// factors P(0, T) = exp(-r(T') * T) come from a `CurveGrid`, the rate being
+// read at the curve day T' the book looks T up at (see SwapPortfolio), so
+// zero bonds are reconstructed in closed form for any grid day:
+//
+//   P(t, T) = P(0, T) / P(0, t) * exp(C(t, T) - B(t, T) x)
+//   B(t, T) = (1 - e^{-a(T - t)}) / a
+//   C(t, T) = -sigma^2 (1 - e^{-2at}) B^2 / 4a - sigma^2 (1 - e^{-at})^2 B / 2a^2
+//
+// Times are Act/Act ISDA year fractions from the grid's today.
+class CDR_SWAPS_EXPORT HullWhite final {
+public:
+    // `grid` must outlive the model, mean reversion must be positive
+    HullWhite(const CurveGrid& grid, HullWhiteParams params);
+
+    [[nodiscard]] const HullWhiteParams& Params() const noexcept {
+        return params_;
+    }
+
+    [[nodiscard]] const CurveGrid& Grid() const noexcept {
+        return *grid_;
+    }
+
+    [[nodiscard]] f64 B(f64 t, f64 maturity) const noexcept;
+    [[nodiscard]] f64 C(f64 t, f64 maturity) const noexcept;
+
+    // P(t, T) with the rates of t and T read at `curve_day` and
+    // `maturity_curve_day`, the discounting of the exposure engine
+    [[nodiscard]] f64 ZeroBond(i32 day, i32 curve_day, i32 maturity_day, i32 maturity_curve_day,
+                               f64 x) const noexcept;
+
+    // Exact transition of x over `dt`: x' = x * Decay(dt) + StdDev(dt) * N(0, 1)
+    [[nodiscard]] f64 Decay(f64 dt) const noexcept;
+    [[nodiscard]] f64 StdDev(f64 dt) const noexcept;
+
+private:
+    const CurveGrid* grid_;
+    HullWhiteParams params_;
+};
+
+// Simulated states x(t) of `paths` scenarios on `steps` dates, stored
+// step-major: the states of one date are contiguous.
+struct HullWhitePaths {
+    u64 steps = 0;
+    u64 paths = 0;
+    std::vector<f64> states;
+
+    [[nodiscard]] f64 At(u64 step, u64 path) const noexcept {
+        return states[step * paths + path];
+    }
+
+    [[nodiscard]] std::span<const f64> Step(u64 step) const noexcept {
+        return std::span<const f64>(states).subspan(step * paths, paths);
+    }
+};
+
+// Scenario `p` only depends on `seed` and `p`, so paths are reproducible for
+// any pool size and any number of paths
+[[nodiscard]] CDR_SWAPS_EXPORT HullWhitePaths SimulateHullWhite(ThreadPool& pool, const HullWhite& model,
+                                                                std::span<const i32> days, u64 paths,
+                                                                u64 seed, u64 grain = 64);
+
+struct ExposureSettings {
+    // Strictly increasing, not before today
+    std::vector<DateType> dates;
+    u64 paths = 1'000;
+    u64 seed = 42;
+    f64 pfe_quantile = 0.95;
+    u64 grain = 64;
+    HullWhiteParams model;
+};
+
+// Netted book exposure profile: book value of every path on every date and
+// its statistics per date
+struct ExposureProfile {
+    std::vector<DateType> dates;
+    u64 paths = 0;
+    // step-major, see HullWhitePaths
+    std::vector<f64> values;
+    // mean of max(V, 0)
+    std::vector<f64> expected_exposure;
+    // `pfe_quantile` quantile of max(V, 0)
+    std::vector<f64> potential_future_exposure;
+
+    [[nodiscard]] f64 Value(u64 step, u64 path) const noexcept {
+        return values[step * paths + path];
+    }
+};
+
+// Revalues `book` on every simulated path at every exposure date. Zero
+// bonds of one date are reconstructed once per path on the day grid and
+// shared by all trades. Float periods starting between two exposure dates
+// fix at the earlier one; periods started before today use their seasoned
+// coupon or the initial curve.
+[[nodiscard]] CDR_SWAPS_EXPORT ExposureProfile SimulateExposure(ThreadPool& pool, const SwapPortfolio& book,
+                                                                const Curve& curve,
+                                                                const ExposureSettings& settings);
+
+}  // namespace cdr
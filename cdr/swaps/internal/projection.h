@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cdr/types/floats.h>
+#include <cdr/types/integers.h>
+#include <cdr/calendar/date.h>
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+
+namespace cdr::internal {
+
+// Index of the first period of `leg` ending today or later. Periods are
+// ordered by Until(), so the ones already paid form a prefix.
+template <typename PaymentPeriod>
+[[nodiscard]] inline u64 FirstAlivePeriod(std::span<const PaymentPeriod> leg, const DateType& today) {
+    auto begin = std::lower_bound(leg.begin(), leg.end(), today,
+                                  [](const PaymentPeriod& period, const DateType& today) {
+                                      return period.Until() < today;
+                                  });
+    return static_cast<u64>(begin - leg.begin());
+}
+
+// DF(date) = exp(-r * (ActActISDATime(date) - ActActISDATime(today))), the
+// same discounting the legs use for payments
+template <typename T>
+[[nodiscard]] inline T DiscountFactor(const T& rate, f64 time) noexcept {
+    using std::exp;
+    return exp(-rate * time);
+}
+
+// Simply compounded forward over an accrual period. Degenerate periods
+// accrue nothing.
+template <typename T>
+[[nodiscard]] inline T ForwardRate(const T& start_df, const T& end_df, f64 accrual) noexcept {
+    if (accrual <= 0.) [[unlikely]] {
+        return T(0.);
+    }
+    return (start_df / end_df - 1.) / accrual;
+}
+
+// Forwards of consecutive float periods. A period starting where the
+// previous one ended reuses its end discount factor, so a regular leg costs
+// one discount factor per coupon. `Key` identifies period boundaries (a date
+// or a day number), `start_df()` and `end_df()` compute the discount factors
+// at the boundaries of the current period and are only called when needed.
+template <typename T, typename Key>
+class ForwardProjector {
+public:
+    template <typename StartDF, typename EndDF>
+    [[nodiscard]] T Forward(const Key& since, const Key& until, f64 accrual, StartDF&& start_df, EndDF&& end_df) {
+        const T start = has_boundary_ && since == boundary_ ? boundary_df_ : start_df();
+        const T end = end_df();
+
+        has_boundary_ = true;
+        boundary_ = until;
+        boundary_df_ = end;
+
+        return ForwardRate(start, end, accrual);
+    }
+
+private:
+    bool has_boundary_ = false;
+    Key boundary_{};
+    T boundary_df_ = T(0.);
+};
+
+}  // namespace cdr::internal
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <ceres/jet.h>
+#include <cdr/swaps/irs.h>
+#include <cdr/types/floats.h>
+
+#include <cmath>
+
+namespace cdr::internal {
+
+// Derivatives are taken with respect to a single parallel shift of zero rates
+using RiskJet = ceres::Jet<f64, 1>;
+
+[[nodiscard]] inline RiskJet ParallelShiftJet() noexcept {
+    return RiskJet(0., 0);
+}
+
+// DCF(today, settlement) * DF(settlement) under a shifted zero rate
+template <typename T>
+[[nodiscard]] inline T DiscountedTime(f64 rate, f64 time, const T& shift) noexcept {
+    using std::exp;
+    return time * exp(-(rate + shift) * time);
+}
+
+// Float coupon on a forward projected from shifted discount factors
+template <typename T>
+[[nodiscard]] inline T ProjectedCoupon(const T& forward, f64 adjustment, f64 notional) noexcept {
+    return (forward + adjustment) * notional;
+}
+
+// `annuity` is the sum of DiscountedTime over alive fixed periods
+[[nodiscard]] inline SwapRisk MakeSwapRisk(const RiskJet& annuity, const RiskJet& pv_float,
+                                           f64 fixed_rate, f64 notional, bool pay_fix) noexcept {
+    const RiskJet pv_fixed = annuity * fixed_rate * notional;
+    const RiskJet npv = pay_fix ? pv_float - pv_fixed : pv_fixed - pv_float;
+
+    SwapRisk risk;
+    risk.npv = npv.a;
+    risk.pv_fixed = pv_fixed.a;
+    risk.pv_float = pv_float.a;
+    risk.annuity = annuity.a;
+    risk.par_rate = annuity.a == 0. ? 0. : pv_float.a / (notional * annuity.a);
+    risk.dv01 = npv.v[0] * SwapRisk::kBasisPoint;
+    risk.pv01 = annuity.a * notional * SwapRisk::kBasisPoint;
+    return risk;
+}
+
+}  // namespace cdr::internal
@@ -1,170 +1,418 @@
 #include <cdr/swaps/irs.h>
+#include <cdr/swaps/internal/projection.h>
+#include <cdr/swaps/internal/risk.h>
 
-#include <queue>
+#include <algorithm>
+#include <cmath>
 #include <utility>
 #include <cdr/base/check.h>
 #include <cdr/calendar/date.h>
 #include <cdr/curve/interpolation/linear.h>
+#include <cdr/types/keys.h>
 
 namespace cdr {
 
+namespace {
+
+using internal::FirstAlivePeriod;
+
+// DCF(today, settlement) * DF(settlement)
+[[nodiscard]] f64 DiscountedTime(const Curve& curve, const IrsPaymentPeriod& period, f64 today_time) {
+    const f64 time = period.SettlementTime() - today_time;
+    const f64 rate = curve.Interpolated<Linear>(period.DiscountDate()).Fraction();
+    return time * std::exp(-rate * time);
+}
+
+using DateProjector = internal::ForwardProjector<f64, DateType>;
+
+// Forward over the accrual period of `period`. Calls for consecutive
+// periods of a leg share the boundary discount factor through `projector`.
+[[nodiscard]] f64 ProjectForward(DateProjector& projector, const Curve& curve, const IrsPaymentPeriod& period,
+                                 f64 today_time) {
+    auto discount_at = [&](const DateType& curve_date, f64 time) {
+        return internal::DiscountFactor(curve.Interpolated<Linear>(curve_date).Fraction(), time - today_time);
+    };
+    return projector.Forward(period.Since(), period.Until(), period.Accrual(),
+                             [&] { return discount_at(period.ProjectionStartDate(), period.AccrualStartTime()); },
+                             [&] { return discount_at(period.ProjectionDate(), period.AccrualEndTime()); });
+}
+
+// Sum of payment * DCF(today, settlement) * DF(settlement) over float periods
+// ending today or later. `payment_of(idx, period)` returns the coupon of the
+// `idx`-th float period or nullopt if it is unknown.
+template <typename PaymentOf>
+[[nodiscard]] std::optional<f64> FloatLegPV(std::span<const IrsPaymentPeriod> float_leg, const Curve& curve,
+                                            PaymentOf&& payment_of) {
+    const f64 today_time = ActActISDATime(curve.Today());
+    f64 result = 0.;
+
+    for (u64 idx = FirstAlivePeriod(float_leg, curve.Today()); idx < float_leg.size(); ++idx) {
+        const auto& payment_period = float_leg[idx];
+        std::optional<f64> payment = payment_of(idx, payment_period);
+        if (!payment.has_value()) {
+            return std::nullopt;
+        }
+        result += *payment * DiscountedTime(curve, payment_period, today_time);
+    }
+
+    return result;
+}
+
+}  // namespace
+
 [[nodiscard]] std::optional<f64> IrsContract::NPV(const Curve& curve) const noexcept {
     auto pv_fixed = PVFixed(curve);
     auto pv_float = PVFloat(curve);
     if (!pv_fixed.has_value() || !pv_float.has_value()) [[unlikely]] {
         return std::nullopt;
     }
-    std::optional<f64> res = std::make_optional<f64>(*pv_float - *pv_fixed);
-    if (!PayFix()) [[unlikely]] {
-        *res *= -1;
-    }
-    return res;
+    return SignedNPV(*pv_fixed, *pv_float);
 }
 
 [[nodiscard]] std::optional<f64> IrsContract::PVFixed(const Curve& curve) const noexcept {
     auto fixed_leg = FixedLeg();
-    Period period = {curve.Today(), curve.Today()};
-    auto& [today, settlement_date] = period;
+    const f64 today_time = ActActISDATime(curve.Today());
 
     f64 result = 0.;
 
-    for (const auto& payment_period : fixed_leg) {
-        if (payment_period.Until() < today) {
-            continue;
-        }
-        settlement_date = payment_period.SettlementDate();
-        auto rate = curve.Interpolated<Linear>(settlement_date, curve.Calendar(), jurisdiction_);
-        result += DayCountFraction(period) * curve.ZeroRatesToDiscount(settlement_date, rate).Fraction();
+    for (u64 idx = FirstAlivePeriod(fixed_leg, curve.Today()); idx < fixed_leg.size(); ++idx) {
+        result += DiscountedTime(curve, fixed_leg[idx], today_time);
     }
 
     return result * fixed_rate_.Fraction() * notional_;
 }
 
 [[nodiscard]] std::optional<f64> IrsContract::PVFloat(const Curve& curve) const noexcept {
-    auto float_leg = FloatLeg();
-    Period period = {curve.Today(), curve.Today()};
-    auto& [today, settlement_date] = period;
+    return FloatLegPV(FloatLeg(), curve, [this](u64 idx, const IrsPaymentPeriod&) {
+        return FloatPayment(idx);
+    });
+}
 
-    auto begin = std::lower_bound(float_leg.begin(), float_leg.end(), today,
-                                 [](const IrsPaymentPeriod& period, const DateType& today) {
-                                    return period.Until() < today;
-                                 });
-    f64 result = 0.;
+[[nodiscard]] f64 IrsContract::PVFloat(const Curve& curve, std::span<const f64> payments) const noexcept {
+    CDR_CHECK(payments.size() == FloatLeg().size()) << "one payment per float period expected";
+    return *FloatLegPV(FloatLeg(), curve, [payments](u64 idx, const IrsPaymentPeriod&) {
+        return std::optional<f64>(payments[idx]);
+    });
+}
 
-    for (const auto& payment_period : float_leg) {
-        if (payment_period.Until() < today) {
-            continue;
+[[nodiscard]] f64 IrsContract::ProjectedPVFloat(const Curve& curve) const noexcept {
+    const f64 today_time = ActActISDATime(curve.Today());
+    DateProjector projector;
+    return *FloatLegPV(FloatLeg(), curve, [&](u64 idx, const IrsPaymentPeriod& period) {
+        if (idx < seasoned_periods_) {
+            return std::optional<f64>(float_payments_[idx]);
         }
-        settlement_date = payment_period.SettlementDate();
-        if (!payment_period.HasKnownPayment()) {
-            return std::nullopt;
+        return std::optional<f64>(ProjectedPayment(ProjectForward(projector, curve, period, today_time)));
+    });
+}
+
+[[nodiscard]] f64 IrsContract::ProjectedNPV(const Curve& curve) const noexcept {
+    return ProjectedNPV<f64>(curve.Today(), [&](const DateType& curve_date) {
+        return curve.Interpolated<Linear>(curve_date).Fraction();
+    });
+}
+
+[[nodiscard]] SwapRisk IrsContract::Risk(const Curve& curve) const noexcept {
+    const auto shift = internal::ParallelShiftJet();
+    const f64 today_time = ActActISDATime(curve.Today());
+
+    internal::RiskJet annuity(0.);
+    auto fixed_leg = FixedLeg();
+    for (u64 idx = FirstAlivePeriod(fixed_leg, curve.Today()); idx < fixed_leg.size(); ++idx) {
+        const auto& period = fixed_leg[idx];
+        const f64 rate = curve.Interpolated<Linear>(period.DiscountDate()).Fraction();
+        annuity += internal::DiscountedTime(rate, period.SettlementTime() - today_time, shift);
+    }
+
+    auto discount_at = [&](const DateType& curve_date, f64 time) {
+        const f64 rate = curve.Interpolated<Linear>(curve_date).Fraction();
+        return internal::DiscountFactor<internal::RiskJet>(rate + shift, time - today_time);
+    };
+
+    internal::RiskJet pv_float(0.);
+    internal::ForwardProjector<internal::RiskJet, DateType> projector;
+    auto float_leg = FloatLeg();
+    for (u64 idx = FirstAlivePeriod(float_leg, curve.Today()); idx < float_leg.size(); ++idx) {
+        const auto& period = float_leg[idx];
+        const f64 discount_rate = curve.Interpolated<Linear>(period.DiscountDate()).Fraction();
+        const auto discounted_time = internal::DiscountedTime(discount_rate, period.SettlementTime() - today_time, shift);
+
+        if (idx < seasoned_periods_) {
+            pv_float += float_payments_[idx] * discounted_time;
+            continue;
         }
-        auto rate = curve.Interpolated<Linear>(settlement_date, curve.Calendar(), jurisdiction_);
-        result += *payment_period.Payment() * DayCountFraction(period) * curve.ZeroRatesToDiscount(settlement_date, rate).Fraction();
+
+        const auto forward = projector.Forward(period.Since(), period.Until(), period.Accrual(),
+            [&] { return discount_at(period.ProjectionStartDate(), period.AccrualStartTime()); },
+            [&] { return discount_at(period.ProjectionDate(), period.AccrualEndTime()); });
+        pv_float += internal::ProjectedCoupon(forward, adjustment_.Fraction(), notional_) * discounted_time;
     }
 
-    return result;
+    return internal::MakeSwapRisk(annuity, pv_float, fixed_rate_.Fraction(), notional_, paying_fix_);
+}
+
+void IrsContract::ProjectFloatLeg(const Curve& curve, std::span<f64> payments) const noexcept {
+    auto leg = FloatLeg();
+    CDR_CHECK(payments.size() == leg.size()) << "one payment per float period expected";
+
+    std::copy_n(float_payments_.begin(), seasoned_periods_, payments.begin());
+
+    const f64 today_time = ActActISDATime(curve.Today());
+    DateProjector projector;
+    for (u64 idx = seasoned_periods_; idx < leg.size(); ++idx) {
+        payments[idx] = ProjectedPayment(ProjectForward(projector, curve, leg[idx], today_time));
+    }
 }
 
 void IrsContract::ApplyCurve(const Curve& curve) noexcept {
-    auto leg = FloatLegMut();
+    float_payments_.resize(FloatLeg().size());
+    ProjectFloatLeg(curve, float_payments_);
+}
+
+[[nodiscard]] Expect<void, Error> IrsContract::ApplyFixings(const FixingSeries& fixings, const DateType& today) {
+    auto leg = FloatLeg();
 
-    for (auto& period : leg) {
-        auto rate = curve.Interpolated<Linear>(period.Until(), curve.Calendar(), jurisdiction_);
-        f64 payment = (rate + adjustment_).Apply(notional_);
-        period.SetPayment(payment);
+    u64 seasoned = 0;
+    while (seasoned < leg.size() && leg[seasoned].Since() < today) {
+        ++seasoned;
     }
+
+    std::vector<f64> payments(leg.size(), std::numeric_limits<f64>::quiet_NaN());
+    for (u64 idx = 0; idx < seasoned; ++idx) {
+        auto fixing = fixings.Find(leg[idx].Since());
+        if (!fixing.has_value()) [[unlikely]] {
+            return ErrorNoData();
+        }
+        payments[idx] = ProjectedPayment(*fixing);
+    }
+
+    // projected coupons of the remaining periods stay valid
+    for (u64 idx = std::max<u64>(seasoned, seasoned_periods_); idx < float_payments_.size(); ++idx) {
+        payments[idx] = float_payments_[idx];
+    }
+
+    float_payments_ = std::move(payments);
+    seasoned_periods_ = static_cast<u32>(seasoned);
+    return Ok();
 }
 
-/* IrsBuilder */
+void IrsSchedule::Precompute(const HolidayStorage& hs) {
+    auto curve_date = [&](const DateType& date) {
+        return Linear::LookupDate(date, hs, jurisdiction_);
+    };
 
-[[nodiscard]] IrsContract IrsBuilder::Build(const HolidayStorage& hs, const JurisdictionType& jur, DateRollingRule rule) {
+    for (auto& period : periods_) {
+        period.accrual_ = DayCountFraction(period.bounds_);
+        period.settlement_time_ = ActActISDATime(period.settlement_date_);
+        period.accrual_start_time_ = ActActISDATime(period.Since());
+        period.accrual_end_time_ = ActActISDATime(period.Until());
+        period.discount_date_ = curve_date(period.settlement_date_);
+        period.projection_start_date_ = curve_date(period.Since());
+        period.projection_date_ = curve_date(period.Until());
+    }
+}
 
-    CDR_CHECK(maturity_date_.has_value()) << "must be defined";
-    CDR_CHECK(settlement_date_.has_value()) << "must be defined";
-    CDR_CHECK(fixed_rate_.has_value()) << "must be defined";
-    CDR_CHECK(adjustment_.has_value()) << "must be defined";
-    CDR_CHECK(notional_.has_value()) << "must be defined";
-    CDR_CHECK(paying_fix_.has_value()) << "must be defined";
-    CDR_CHECK(fixed_freq_.has_value()) << "must be defined";
-    CDR_CHECK(float_freq_.has_value()) << "must be defined";
-    CDR_CHECK(!jur.empty()) << "must be non-empty";
+[[nodiscard]] f64 IrsContract::ProjectedPayment(f64 forward) const noexcept {
+    return (forward + adjustment_.Fraction()) * notional_;
+}
+
+[[nodiscard]] f64 IrsContract::SignedNPV(f64 pv_fixed, f64 pv_float) const noexcept {
+    f64 res = pv_float - pv_fixed;
+    if (!PayFix()) [[unlikely]] {
+        res *= -1;
+    }
+    return res;
+}
 
-    static constexpr u32 kRandomReservationConstant = 10;
-    IrsContract result(fixed_rate_.value(), paying_fix_.value());
+/* IrsScheduleCache */
 
-    std::vector<IrsPaymentPeriod> sched;
-    sched.reserve(kRandomReservationConstant);
-    auto period = Period(settlement_date_.value(), maturity_date_.value());
-    auto compare_dates = [&sched](const u32 left_idx, const u32 right_idx) {
-        return sched[left_idx].Since() > sched[right_idx].Since();
+[[nodiscard]] std::size_t IrsScheduleTermsHash::operator()(const IrsScheduleTerms& terms) const noexcept {
+    auto days = [](const DateType& date) {
+        return SysDays{date}.time_since_epoch().count();
     };
-    std::priority_queue<u32, std::vector<u32>, decltype(compare_dates)> chronological_order(compare_dates);
 
-    f64 fixed_payment = fixed_rate_->Apply(notional_.value());
-    u32 idx = 0;
+    std::size_t seed = 0;
+    internal::CombineHashes(seed, days(terms.settlement_date));
+    internal::CombineHashes(seed, days(terms.maturity_date));
+    internal::CombineHashes(seed, terms.fixed_freq);
+    internal::CombineHashes(seed, terms.float_freq);
+    internal::CombineHashes(seed, terms.jurisdiction);
+    internal::CombineHashes(seed, terms.rule);
+    return seed;
+}
 
-    std::optional<DateType> since = std::nullopt;
-    std::optional<DateType> until = std::nullopt;
+[[nodiscard]] u64 IrsScheduleCache::Size() const {
+    std::lock_guard lock(mutex_);
+    return schedules_.size();
+}
 
-    for (const auto& date : hs.BusinessDays(period.WithFrequency(fixed_freq_.value()), jur, rule)) {
-        // TODO: check that date provided
-        since = std::exchange(until, date.Value());
-        if (!since) [[unlikely]] {
-            continue;
-        }
+[[nodiscard]] u64 IrsScheduleCache::MemoryUsage() const {
+    std::lock_guard lock(mutex_);
+    u64 result = 0;
+    for (const auto& [_, schedule] : schedules_) {
+        result += schedule->MemoryUsage();
+    }
+    return result;
+}
 
-        auto payment_period = Period{since.value(), std::min(until.value(), maturity_date_.value())};
-        sched.emplace_back(payment_period, fixed_payment * DayCountFraction(payment_period));
-        chronological_order.push(idx++);
+void IrsScheduleCache::Clear() {
+    std::lock_guard lock(mutex_);
+    schedules_.clear();
+}
 
-        if (payment_period.Until() == maturity_date_) {
-            break;
-        }
+/* IrsBuilder */
+
+namespace {
+
+void StepScheduleDate(DateType& date, Freq freq) {
+    switch (freq) {
+    case Freq::kAnnualy:
+        AddMonths(date, 12);
+        break;
+    case Freq::kSemiAnnualy:
+        AddMonths(date, 6);
+        break;
+    case Freq::kQuarterly:
+        AddMonths(date, 3);
+        break;
+    case Freq::kMonthly:
+        AddMonths(date, 1);
+        break;
+    case Freq::kDaily:
+        date = NextDay(date);
+        break;
     }
+}
 
-    since = std::nullopt;
-    until = std::nullopt;
-    u64 fixed_last = sched.size();
+[[nodiscard]] u64 ExpectedPeriods(const Period& period, Freq freq) {
+    const f64 days = static_cast<f64>(std::max(period.Days(), 0));
+    switch (freq) {
+    case Freq::kAnnualy:
+        return static_cast<u64>(days / 365.) + 2;
+    case Freq::kSemiAnnualy:
+        return static_cast<u64>(days / 182.) + 2;
+    case Freq::kQuarterly:
+        return static_cast<u64>(days / 90.) + 2;
+    case Freq::kMonthly:
+        return static_cast<u64>(days / 28.) + 2;
+    case Freq::kDaily:
+        return static_cast<u64>(days) + 1;
+    }
+    return 0;
+}
+
+// Appends periods between consecutive adjusted dates of `period.WithFrequency(freq)`,
+// the same schedule BusinessDays() yields, without a coroutine frame per leg.
+void AppendLeg(std::vector<IrsPaymentPeriod>& sched, const Period& period, Freq freq, const HolidayStorage& hs,
+               const JurisdictionType& jur, DateRollingRule rule) {
+    std::optional<DateType> since = std::nullopt;
+    std::optional<DateType> until = std::nullopt;
 
-    for (const auto& date : hs.BusinessDays(period.WithFrequency(float_freq_.value()), jur, rule)) {
-        // TODO: check that date provided
-        since = std::exchange(until, date.Value());
+    for (DateType date = period.Since(); date <= period.Until(); StepScheduleDate(date, freq)) {
+        DateType adjusted = hs.AdjustWorkDay(jur, date, rule);
+        if (until.has_value() && adjusted == *until) {
+            continue;
+        }
+
+        since = std::exchange(until, adjusted);
         if (!since) [[unlikely]] {
             continue;
         }
 
-        auto payment_period = Period{since.value(), std::min(until.value(), maturity_date_.value())};
+        auto payment_period = Period{since.value(), std::min(until.value(), period.Until())};
         sched.emplace_back(payment_period);
-        chronological_order.push(idx++);
 
-        if (payment_period.Until() == maturity_date_) {
+        if (payment_period.Until() == period.Until()) {
             break;
         }
     }
+}
 
-    u32 last = IrsPaymentPeriod::kNotInitialized;
-    u32 curr = IrsPaymentPeriod::kNotInitialized;
-    result.chrono_start_idx_ = chronological_order.top();
+}  // namespace
 
-    while (!chronological_order.empty()) {
-        last = std::exchange(curr, chronological_order.top());
-        chronological_order.pop();
 
-        sched[curr].chrono_prev_idx_ = last;
+[[nodiscard]] IrsContract IrsBuilder::Build(const HolidayStorage& hs, const JurisdictionType& jur, DateRollingRule rule) {
+    return MakeContract(BuildSchedule(hs, jur, rule));
+}
 
-        if (last == IrsPaymentPeriod::kNotInitialized) [[unlikely]] {
-            continue;
+[[nodiscard]] IrsContract IrsBuilder::Build(IrsScheduleCache& cache, const HolidayStorage& hs,
+                                            const JurisdictionType& jur, DateRollingRule rule) {
+    CDR_CHECK(maturity_date_.has_value()) << "must be defined";
+    CDR_CHECK(settlement_date_.has_value()) << "must be defined";
+    CDR_CHECK(fixed_freq_.has_value()) << "must be defined";
+    CDR_CHECK(float_freq_.has_value()) << "must be defined";
+
+    const IrsScheduleTerms terms{
+        .settlement_date = *settlement_date_,
+        .maturity_date = *maturity_date_,
+        .fixed_freq = *fixed_freq_,
+        .float_freq = *float_freq_,
+        .jurisdiction = jur,
+        .rule = rule,
+    };
+    return MakeContract(cache.FindOrBuild(terms, [&] {
+        return BuildSchedule(hs, jur, rule);
+    }));
+}
+
+[[nodiscard]] std::shared_ptr<const IrsSchedule> IrsBuilder::BuildSchedule(const HolidayStorage& hs,
+                                                                          const JurisdictionType& jur,
+                                                                          DateRollingRule rule) const {
+    CDR_CHECK(maturity_date_.has_value()) << "must be defined";
+    CDR_CHECK(settlement_date_.has_value()) << "must be defined";
+    CDR_CHECK(fixed_freq_.has_value()) << "must be defined";
+    CDR_CHECK(float_freq_.has_value()) << "must be defined";
+    CDR_CHECK(!jur.empty()) << "must be non-empty";
+
+    std::shared_ptr<IrsSchedule> result(new IrsSchedule());
+
+    const auto period = Period(settlement_date_.value(), maturity_date_.value());
+
+    auto& sched = result->periods_;
+    sched.reserve(ExpectedPeriods(period, *fixed_freq_) + ExpectedPeriods(period, *float_freq_));
+
+    AppendLeg(sched, period, *fixed_freq_, hs, jur, rule);
+    const u64 fixed_last = sched.size();
+    AppendLeg(sched, period, *float_freq_, hs, jur, rule);
+
+    // Both legs are already ordered by Since(), so the chronological order is a merge of the two
+    u32 fixed_idx = 0;
+    u32 float_idx = static_cast<u32>(fixed_last);
+    u32 prev = IrsPaymentPeriod::kNotInitialized;
+    const u32 size = static_cast<u32>(sched.size());
+
+    while (fixed_idx < fixed_last || float_idx < size) {
+        u32 curr = 0;
+        if (float_idx == size || (fixed_idx < fixed_last && sched[fixed_idx].Since() <= sched[float_idx].Since())) {
+            curr = fixed_idx++;
+        } else {
+            curr = float_idx++;
         }
-        sched[last].chrono_next_idx_ = curr;
+
+        sched[curr].chrono_prev_idx_ = prev;
+        if (prev == IrsPaymentPeriod::kNotInitialized) [[unlikely]] {
+            result->chrono_start_idx_ = curr;
+        } else {
+            sched[prev].chrono_next_idx_ = curr;
+        }
+        prev = curr;
     }
 
-    result.jurisdiction_ = jur;
-    result.chrono_last_idx_ = last;
-    result.notional_ = *notional_;
-    result.payment_periods_ = std::move(sched);
-    result.fixed_leg_ = result.payment_periods_.data();
-    result.float_leg_ = result.payment_periods_.data() + fixed_last;
+    result->jurisdiction_ = jur;
+    result->chrono_last_idx_ = prev == IrsPaymentPeriod::kNotInitialized ? 0 : prev;
+    result->float_begin_ = static_cast<u32>(fixed_last);
+    result->Precompute(hs);
+
+    return result;
+}
+
+[[nodiscard]] IrsContract IrsBuilder::MakeContract(std::shared_ptr<const IrsSchedule> schedule) {
+    CDR_CHECK(fixed_rate_.has_value()) << "must be defined";
+    CDR_CHECK(adjustment_.has_value()) << "must be defined";
+    CDR_CHECK(notional_.has_value()) << "must be defined";
+    CDR_CHECK(paying_fix_.has_value()) << "must be defined";
+
+    IrsContract result(std::move(schedule), *fixed_rate_, *adjustment_, *notional_, *paying_fix_);
 
     Reset();
     return result;
@@ -202,8 +450,8 @@ void IrsBuilder::Reset() {
     CDR_CHECK(fixed_freq_->number > 0) << "must be positive";
     CDR_CHECK(float_freq_->number > 0) << "must be positive";
 
-    IrsContract result(fixed_rate_.value_or(Percent::Zero()), *paying_fix_);
-    std::vector<IrsPaymentPeriod> sched;
+    std::shared_ptr<IrsSchedule> schedule(new IrsSchedule());
+    auto& sched = schedule->periods_;
 
     // --------- fixed leg ------------
 
@@ -271,13 +519,13 @@ void IrsBuilder::Reset() {
 
     // -------------------------------
 
-    result.jurisdiction_ = jur;
-    result.payment_periods_ = std::move(sched);
-    result.fixed_leg_ = result.payment_periods_.data();
-    result.float_leg_ = result.payment_periods_.data() + float_begin;
-    result.adjustment_ = *adjustment_;
-    result.notional_ = *notional_;
-    // result.chrono_last_idx_ = last;
+    schedule->jurisdiction_ = jur;
+    schedule->float_begin_ = float_begin;
+    schedule->Precompute(hs);
+    // schedule->chrono_last_idx_ = last;
+
+    IrsContract result(std::move(schedule), fixed_rate_.value_or(Percent::Zero()), *adjustment_, *notional_,
+                       *paying_fix_);
 
     Reset();
     return result;
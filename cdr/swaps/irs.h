@@ -1,14 +1,22 @@
 #pragma once
 
+#include <cmath>
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <span>
+#include <unordered_map>
 #include <cdr/types/percent.h>
 #include <cdr/calendar/date.h>
 #include <cdr/calendar/holiday_storage.h>
 #include <cdr/curve/curve.h>
+#include <cdr/market/fixings.h>
 #include <cdr/types/concepts.h>
+#include <cdr/types/errors.h>
+#include <cdr/types/expect.h>
 #include <cdr/swaps/internal/export.h>
+#include <cdr/swaps/internal/projection.h>
 
 namespace cdr {
 
@@ -20,14 +28,14 @@ public:
 
     friend class IrsBuilder;
     friend class IrsBuilderExperimental;
+    friend class IrsSchedule;
 
 public:
 
     IrsPaymentPeriod() = default;
-    explicit IrsPaymentPeriod(const Period& bounds, const std::optional<f64>& payment = std::nullopt)
+    explicit IrsPaymentPeriod(const Period& bounds)
         : bounds_(bounds)
         , settlement_date_(bounds_.Until())
-        , payment_(payment)
         , chrono_prev_idx_(kNotInitialized)
         , chrono_next_idx_(kNotInitialized)
     {}
@@ -44,35 +52,175 @@ public:
         return settlement_date_;
     }
 
-    [[nodiscard]] bool ChronoFirstPayment() const noexcept {
-        return chrono_prev_idx_ == kNotInitialized;
+    // Schedule data below is computed once when the contract is built
+
+    // Act/Act ISDA accrual fraction of [Since(), Until()]
+    [[nodiscard]] f64 Accrual() const noexcept {
+        return accrual_;
     }
 
-    [[nodiscard]] bool ChronoLastPayment() const noexcept {
-        return chrono_next_idx_ == kNotInitialized;
+    // ActActISDATime(SettlementDate()), year fraction to payment is
+    // SettlementTime() - ActActISDATime(today)
+    [[nodiscard]] f64 SettlementTime() const noexcept {
+        return settlement_time_;
+    }
+
+    // ActActISDATime of Since() and Until()
+    [[nodiscard]] f64 AccrualStartTime() const noexcept {
+        return accrual_start_time_;
+    }
+
+    [[nodiscard]] f64 AccrualEndTime() const noexcept {
+        return accrual_end_time_;
+    }
+
+    // Business days the curve is read at to discount the payment and to
+    // project the floating coupon, which is the forward between the
+    // discount factors at ProjectionStartDate() and ProjectionDate()
+    [[nodiscard]] const DateType& DiscountDate() const noexcept {
+        return discount_date_;
+    }
+
+    [[nodiscard]] const DateType& ProjectionStartDate() const noexcept {
+        return projection_start_date_;
     }
 
-    [[nodiscard]] bool HasKnownPayment() const noexcept {
-        return payment_.has_value();
+    [[nodiscard]] const DateType& ProjectionDate() const noexcept {
+        return projection_date_;
     }
 
-    void SetPayment(f64 payment) noexcept {
-        payment_ = payment;
+    [[nodiscard]] bool ChronoFirstPayment() const noexcept {
+        return chrono_prev_idx_ == kNotInitialized;
     }
 
-    [[nodiscard]] std::optional<f64> Payment() const noexcept {
-        return payment_;
+    [[nodiscard]] bool ChronoLastPayment() const noexcept {
+        return chrono_next_idx_ == kNotInitialized;
     }
 
 private:
     Period bounds_;
     DateType settlement_date_;
-    std::optional<f64> payment_;
+    DateType discount_date_;
+    DateType projection_start_date_;
+    DateType projection_date_;
+    f64 accrual_ = 0.;
+    f64 settlement_time_ = 0.;
+    f64 accrual_start_time_ = 0.;
+    f64 accrual_end_time_ = 0.;
     u32 chrono_prev_idx_;
     u32 chrono_next_idx_;
 };
 
 
+// Immutable payment schedule of both legs, shared by every contract with the
+// same terms. Holds no trade state, so one instance may back any number of
+// contracts (and threads) at once.
+class CDR_SWAPS_EXPORT IrsSchedule final {
+public:
+    friend class IrsBuilder;
+    friend class IrsBuilderExperimental;
+    friend class IrsContract;
+
+    [[nodiscard]] std::span<const IrsPaymentPeriod> FixedLeg() const noexcept {
+        return std::span<const IrsPaymentPeriod>(periods_).first(float_begin_);
+    }
+
+    [[nodiscard]] std::span<const IrsPaymentPeriod> FloatLeg() const noexcept {
+        return std::span<const IrsPaymentPeriod>(periods_).subspan(float_begin_);
+    }
+
+    [[nodiscard]] const JurisdictionType& Jurisdiction() const noexcept {
+        return jurisdiction_;
+    }
+
+    // Heap and inline bytes owned by the schedule
+    [[nodiscard]] u64 MemoryUsage() const noexcept {
+        return sizeof(*this) + periods_.capacity() * sizeof(IrsPaymentPeriod) + jurisdiction_.capacity();
+    }
+
+private:
+    IrsSchedule() = default;
+
+    void Precompute(const HolidayStorage& hs);
+
+private:
+    JurisdictionType jurisdiction_;
+    std::vector<IrsPaymentPeriod> periods_;
+    // legs are stored as offsets into one vector
+    u32 float_begin_ = 0;
+    u32 chrono_start_idx_ = 0;
+    u32 chrono_last_idx_ = 0;
+};
+
+// Terms IrsBuilder derives a schedule from
+struct IrsScheduleTerms {
+    DateType settlement_date;
+    DateType maturity_date;
+    Freq fixed_freq;
+    Freq float_freq;
+    JurisdictionType jurisdiction;
+    DateRollingRule rule;
+
+    bool operator==(const IrsScheduleTerms&) const = default;
+};
+
+struct CDR_SWAPS_EXPORT IrsScheduleTermsHash {
+    [[nodiscard]] std::size_t operator()(const IrsScheduleTerms& terms) const noexcept;
+};
+
+// Flyweight store of schedules. Contracts built through the same cache with
+// equal terms reference one IrsSchedule. Schedules depend on the calendar,
+// so a cache must only be used with one HolidayStorage. Thread-safe.
+class CDR_SWAPS_EXPORT IrsScheduleCache final {
+public:
+    [[nodiscard]] u64 Size() const;
+
+    // Heap bytes of all cached schedules
+    [[nodiscard]] u64 MemoryUsage() const;
+
+    void Clear();
+
+private:
+    friend class IrsBuilder;
+
+    template <typename Make>
+    [[nodiscard]] std::shared_ptr<const IrsSchedule> FindOrBuild(const IrsScheduleTerms& terms, Make&& make) {
+        {
+            std::lock_guard lock(mutex_);
+            if (auto it = schedules_.find(terms); it != schedules_.end()) {
+                return it->second;
+            }
+        }
+        // Built outside the lock; a concurrent builder of the same terms loses the race
+        std::shared_ptr<const IrsSchedule> schedule = make();
+        std::lock_guard lock(mutex_);
+        return schedules_.try_emplace(terms, std::move(schedule)).first->second;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<IrsScheduleTerms, std::shared_ptr<const IrsSchedule>, IrsScheduleTermsHash> schedules_;
+};
+
+// Valuation and first order rate risk of a swap, computed in one pass.
+struct SwapRisk {
+    static constexpr f64 kBasisPoint = 0.0001;
+
+    f64 npv = 0.;
+    f64 pv_fixed = 0.;
+    f64 pv_float = 0.;
+    // Sum of DCF(today, settlement) * DF over alive fixed periods, so that
+    // pv_fixed == fixed rate * notional * annuity
+    f64 annuity = 0.;
+    // Fixed rate that makes the swap worth zero
+    f64 par_rate = 0.;
+    // NPV change for a +1bp parallel shift of zero rates (projection and
+    // discounting), from the exact derivative rather than a bump
+    f64 dv01 = 0.;
+    // Fixed leg value of 1bp of fixed rate
+    f64 pv01 = 0.;
+};
+
 class CDR_SWAPS_EXPORT IrsContract final {
 public:
     enum class Stub {SHORT, LONG};
@@ -81,19 +229,53 @@ public:
     friend class IrsBuilderExperimental;
 
     [[nodiscard]] std::span<const IrsPaymentPeriod> FixedLeg() const noexcept {
-        return {fixed_leg_, float_leg_};
+        return schedule_->FixedLeg();
     }
 
     [[nodiscard]] std::span<const IrsPaymentPeriod> FloatLeg() const noexcept {
-        return {float_leg_, payment_periods_.data() + payment_periods_.size()};
+        return schedule_->FloatLeg();
+    }
+
+    [[nodiscard]] const IrsSchedule& Schedule() const noexcept {
+        return *schedule_;
+    }
+
+    [[nodiscard]] const std::shared_ptr<const IrsSchedule>& SharedSchedule() const noexcept {
+        return schedule_;
     }
 
     [[nodiscard]] DateType GetHorizonDate() const {
-        return payment_periods_.front().Since();
+        return schedule_->periods_.front().Since();
     }
 
     [[nodiscard]] DateType GetMaturityDate() const {
-        return payment_periods_.back().Until();
+        return schedule_->periods_.back().Until();
+    }
+
+    // Contractual coupon of the `idx`-th fixed period: rate * notional *
+    // Act/Act ISDA accrual of the period, paid on its settlement date. This
+    // is cashflow data, it is not the amount PVFixed discounts.
+    [[nodiscard]] f64 FixedPayment(u64 idx) const noexcept {
+        return fixed_rate_.Apply(notional_) * FixedLeg()[idx].Accrual();
+    }
+
+    // Coupon of the `idx`-th float period: realised by ApplyFixings or
+    // projected by the last ApplyCurve, nullopt if neither was applied
+    [[nodiscard]] std::optional<f64> FloatPayment(u64 idx) const noexcept {
+        if (float_payments_.empty() || std::isnan(float_payments_[idx])) {
+            return std::nullopt;
+        }
+        return float_payments_[idx];
+    }
+
+    // Number of leading float periods whose coupons come from fixings
+    [[nodiscard]] u64 SeasonedPeriods() const noexcept {
+        return seasoned_periods_;
+    }
+
+    // Bytes owned by the contract itself, shared schedule excluded
+    [[nodiscard]] u64 MemoryUsage() const noexcept {
+        return sizeof(*this) + float_payments_.capacity() * sizeof(f64);
     }
 
     [[nodiscard]] const Percent& FixedRate() const noexcept {
@@ -108,42 +290,98 @@ public:
         return notional_;
     }
 
+    [[nodiscard]] const Percent& Adjustment() const noexcept {
+        return adjustment_;
+    }
+
+    [[nodiscard]] const JurisdictionType& Jurisdiction() const noexcept {
+        return schedule_->Jurisdiction();
+    }
+
     [[nodiscard]] DateType SettlementDate() const noexcept {
         CDR_CHECK(!FloatLeg().empty()) << "must be not empty";
         return FloatLeg().back().SettlementDate();
     }
 
+    // Ends of the chronological order of both legs
+    [[nodiscard]] const IrsPaymentPeriod& ChronoFirstPeriod() const noexcept {
+        return schedule_->periods_[schedule_->chrono_start_idx_];
+    }
+
+    [[nodiscard]] const IrsPaymentPeriod& ChronoLastPeriod() const noexcept {
+        return schedule_->periods_[schedule_->chrono_last_idx_];
+    }
+
+    // Pricing reads the curve at the business days fixed when the contract
+    // was built, so the curve is expected to share that calendar.
+    // Coupons set by ApplyFixings are kept.
     void ApplyCurve(const Curve& curve) noexcept;
 
+    // Sets coupons of float periods that started before `today` from the
+    // index fixing published on their Since() date. Such seasoned coupons
+    // are used as is by every pricing method instead of being projected.
+    // Fails with Error::NoData if one of the fixings is missing.
+    [[nodiscard]] Expect<void, Error> ApplyFixings(const FixingSeries& fixings, const DateType& today);
+
+    // Leg PVs follow the library's valuation convention, which curves are
+    // bootstrapped against: a period alive today contributes its coupon rate
+    // * notional * DCF(today, settlement) * DF(settlement) on the fixed leg,
+    // and its float coupon * DCF(today, settlement) * DF(settlement) on the
+    // float leg. The fixed leg never reads FixedPayment. Risk, SwapPortfolio
+    // and CashflowLadder use the same convention and are authoritative for
+    // valuation; FixedPayment is authoritative for cashflows.
     [[nodiscard]] std::optional<f64> PVFixed(const Curve& curve) const noexcept;
     [[nodiscard]] std::optional<f64> PVFloat(const Curve& curve) const noexcept;
     [[nodiscard]] std::optional<f64> NPV(const Curve& curve) const noexcept;
 
+    // Non-mutating pricing path. Float coupons are projected from `curve`
+    // instead of being read from the stored payments, so a shared contract
+    // may be priced against any number of curves from many threads at once.
+    // Results are the same as ApplyCurve(curve) followed by PVFloat/NPV.
+
+    // Writes float coupons into `payments`, one per float period
+    void ProjectFloatLeg(const Curve& curve, std::span<f64> payments) const noexcept;
+
+    [[nodiscard]] f64 PVFloat(const Curve& curve, std::span<const f64> payments) const noexcept;
+    [[nodiscard]] f64 ProjectedPVFloat(const Curve& curve) const noexcept;
+    [[nodiscard]] f64 ProjectedNPV(const Curve& curve) const noexcept;
+
+    // NPV, leg PVs, annuity, par rate, DV01 and PV01 in one pass over the
+    // schedule. Float coupons are projected from `curve`, as in ProjectedNPV.
+    [[nodiscard]] SwapRisk Risk(const Curve& curve) const noexcept;
+
+    // Same as ProjectedNPV and the annuity of Risk, but every zero rate is
+    // read as `rate_at(curve_date)` instead of from a curve. `T` may be a
+    // ceres::Jet to differentiate the results with respect to whatever the
+    // rates are computed from, e.g. the pillars of the curve.
+    template <typename T, typename RateAt>
+    [[nodiscard]] T Annuity(const DateType& today, RateAt&& rate_at) const;
+    template <typename T, typename RateAt>
+    [[nodiscard]] T ProjectedNPV(const DateType& today, RateAt&& rate_at) const;
+
 private:
 
-    IrsContract(Percent fixed_rate, bool paying_fix)
-        : fixed_rate_(fixed_rate)
+    IrsContract(std::shared_ptr<const IrsSchedule> schedule, Percent fixed_rate, Percent adjustment,
+                f64 notional, bool paying_fix)
+        : schedule_(std::move(schedule))
+        , fixed_rate_(fixed_rate)
+        , adjustment_(adjustment)
+        , notional_(notional)
         , paying_fix_(paying_fix)
     {}
 
-    [[nodiscard]] std::span<IrsPaymentPeriod> FixedLegMut() const noexcept {
-        return {fixed_leg_, float_leg_};
-    }
-
-    [[nodiscard]] std::span<IrsPaymentPeriod> FloatLegMut() const noexcept {
-        return {float_leg_, payment_periods_.data() + payment_periods_.size()};
-    }
+    [[nodiscard]] f64 ProjectedPayment(f64 forward) const noexcept;
+    [[nodiscard]] f64 SignedNPV(f64 pv_fixed, f64 pv_float) const noexcept;
 
 private:
-    JurisdictionType jurisdiction_;
-    std::vector<IrsPaymentPeriod> payment_periods_;
-    IrsPaymentPeriod* fixed_leg_ = nullptr;
-    IrsPaymentPeriod* float_leg_ = nullptr;
+    // Dates are shared, everything below is trade state
+    std::shared_ptr<const IrsSchedule> schedule_;
+    // float coupons set by ApplyFixings and ApplyCurve, NaN while unknown
+    std::vector<f64> float_payments_;
+    u32 seasoned_periods_ = 0;
     Percent fixed_rate_;
     Percent adjustment_;
     f64 notional_;
-    u32 chrono_start_idx_ = 0;
-    u32 chrono_last_idx_ = 0;
     bool paying_fix_ = false;
 };
 
@@ -197,8 +435,18 @@ public:
     [[nodiscard]] IrsContract Build(const HolidayStorage& hs, const std::string& jur,
                                     DateRollingRule rule = DateRollingRule::kFollowing);
 
+    // Same as Build, but the schedule is taken from `cache` when a contract
+    // with the same terms was built through it before
+    [[nodiscard]] IrsContract Build(IrsScheduleCache& cache, const HolidayStorage& hs, const std::string& jur,
+                                    DateRollingRule rule = DateRollingRule::kFollowing);
+
     void Reset();
 
+private:
+    [[nodiscard]] std::shared_ptr<const IrsSchedule> BuildSchedule(const HolidayStorage& hs, const std::string& jur,
+                                                                   DateRollingRule rule) const;
+    [[nodiscard]] IrsContract MakeContract(std::shared_ptr<const IrsSchedule> schedule);
+
 private:
     std::optional<DateType> maturity_date_;
     std::optional<DateType> settlement_date_;
@@ -293,6 +541,52 @@ private:
     std::optional<bool> paying_fix_;
 };
 
+template <typename T, typename RateAt>
+[[nodiscard]] T IrsContract::Annuity(const DateType& today, RateAt&& rate_at) const {
+    using std::exp;
+    const f64 today_time = ActActISDATime(today);
+    auto fixed_leg = FixedLeg();
+
+    T result(0.);
+    for (u64 idx = internal::FirstAlivePeriod(fixed_leg, today); idx < fixed_leg.size(); ++idx) {
+        const auto& period = fixed_leg[idx];
+        const f64 time = period.SettlementTime() - today_time;
+        result += time * exp(-rate_at(period.DiscountDate()) * time);
+    }
+    return result;
+}
+
+template <typename T, typename RateAt>
+[[nodiscard]] T IrsContract::ProjectedNPV(const DateType& today, RateAt&& rate_at) const {
+    using std::exp;
+    const f64 today_time = ActActISDATime(today);
+    auto discount_at = [&](const DateType& curve_date, f64 time) {
+        return internal::DiscountFactor<T>(rate_at(curve_date), time - today_time);
+    };
+
+    const T pv_fixed = Annuity<T>(today, rate_at) * fixed_rate_.Fraction() * notional_;
+
+    T pv_float(0.);
+    internal::ForwardProjector<T, DateType> projector;
+    auto float_leg = FloatLeg();
+    for (u64 idx = internal::FirstAlivePeriod(float_leg, today); idx < float_leg.size(); ++idx) {
+        const auto& period = float_leg[idx];
+        T payment(0.);
+        if (idx < seasoned_periods_) {
+            payment = T(float_payments_[idx]);
+        } else {
+            const T forward = projector.Forward(period.Since(), period.Until(), period.Accrual(),
+                [&] { return discount_at(period.ProjectionStartDate(), period.AccrualStartTime()); },
+                [&] { return discount_at(period.ProjectionDate(), period.AccrualEndTime()); });
+            payment = (forward + adjustment_.Fraction()) * notional_;
+        }
+        const f64 time = period.SettlementTime() - today_time;
+        pv_float += payment * (time * exp(-rate_at(period.DiscountDate()) * time));
+    }
+
+    return paying_fix_ ? pv_float - pv_fixed : pv_fixed - pv_float;
+}
+
 static_assert(Contract<IrsContract>);
 
 } // namespace cdr
@@ -0,0 +1,138 @@
+#include <cdr/swaps/ladder.h>
+
+#include <cdr/base/check.h>
+#include <cdr/curve/interpolation/linear.h>
+#include <cdr/swaps/internal/projection.h>
+
+#include <cmath>
+
+namespace cdr {
+
+void CashflowLadder::Add(const IrsContract& contract) {
+    Apply(contract, 1.);
+}
+
+void CashflowLadder::Remove(const IrsContract& contract) {
+    Apply(contract, -1.);
+}
+
+void CashflowLadder::Apply(const IrsContract& contract, f64 direction) {
+    auto& rungs = ladders_[contract.Jurisdiction()];
+
+    // NPV = sign * (float - fixed), where sign is +1 for the fixed rate payer
+    const f64 sign = (contract.PayFix() ? 1. : -1.) * direction;
+    const f64 notional = contract.Notional();
+    const f64 fixed_amount = -sign * contract.FixedRate().Fraction() * notional;
+    const f64 spread_amount = sign * contract.Adjustment().Fraction() * notional;
+
+    auto update = [&](const IrsPaymentPeriod& period, f64 amount, f64 projected_notional) {
+        const Key key{period.SettlementDate(), period.Until(), period.Since()};
+        auto it = rungs.find(key);
+
+        if (it == rungs.end()) {
+            CDR_CHECK(direction > 0.) << "removing a cashflow that was never added";
+            it = rungs.emplace_hint(it, key, Bucket{
+                .discount_date = period.DiscountDate(),
+                .projection_start_date = period.ProjectionStartDate(),
+                .projection_date = period.ProjectionDate(),
+                .accrual_start_time = period.AccrualStartTime(),
+                .accrual_end_time = period.AccrualEndTime(),
+                .accrual = period.Accrual(),
+            });
+        }
+
+        auto& bucket = it->second;
+        bucket.amount += amount;
+        bucket.projected_notional += projected_notional;
+
+        if (direction > 0.) {
+            ++bucket.cashflows;
+        } else if (--bucket.cashflows == 0) {
+            // drop the rounding residue together with the bucket
+            rungs.erase(it);
+        }
+    };
+
+    for (const auto& period : contract.FixedLeg()) {
+        update(period, fixed_amount, 0.);
+    }
+
+    const auto float_leg = contract.FloatLeg();
+    for (u64 idx = 0; idx < float_leg.size(); ++idx) {
+        if (idx < contract.SeasonedPeriods()) {
+            // realised coupons are plain amounts
+            update(float_leg[idx], sign * *contract.FloatPayment(idx), 0.);
+        } else {
+            update(float_leg[idx], spread_amount, sign * notional);
+        }
+    }
+
+    if (rungs.empty()) {
+        ladders_.erase(contract.Jurisdiction());
+    }
+}
+
+[[nodiscard]] const CashflowLadder::Rungs& CashflowLadder::Ladder(const JurisdictionType& jur) const {
+    static const Rungs kEmpty;
+    auto it = ladders_.find(jur);
+    return it == ladders_.end() ? kEmpty : it->second;
+}
+
+[[nodiscard]] u64 CashflowLadder::DatesSize(const JurisdictionType& jur) const {
+    u64 result = 0;
+    const DateType* prev = nullptr;
+    for (const auto& [key, _] : Ladder(jur)) {
+        if (prev == nullptr || *prev != key.settlement) {
+            ++result;
+        }
+        prev = &key.settlement;
+    }
+    return result;
+}
+
+[[nodiscard]] f64 CashflowLadder::PV(const Curve& curve) const {
+    return PV(curve, curve.GetJurisdiction());
+}
+
+[[nodiscard]] f64 CashflowLadder::PV(const Curve& curve, const JurisdictionType& jur) const {
+    const auto& rungs = Ladder(jur);
+    const DateType today = curve.Today();
+    const f64 today_time = ActActISDATime(today);
+
+    f64 result = 0.;
+
+    // Buckets are ordered by settlement date, so one DF serves a whole run of them
+    const DateType* settlement = nullptr;
+    f64 discounted_time = 0.;
+    internal::ForwardProjector<f64, DateType> projector;
+    auto discount_at = [&](const DateType& curve_date, f64 time) {
+        return internal::DiscountFactor(curve.Interpolated<Linear>(curve_date).Fraction(), time - today_time);
+    };
+
+    for (const auto& [key, bucket] : rungs) {
+        if (key.until < today) {
+            continue;
+        }
+
+        if (settlement == nullptr || *settlement != key.settlement) {
+            settlement = &key.settlement;
+            const f64 time = ActActISDATime(key.settlement) - today_time;
+            const f64 rate = curve.Interpolated<Linear>(bucket.discount_date).Fraction();
+            discounted_time = time * std::exp(-rate * time);
+        }
+
+        f64 amount = bucket.amount;
+        if (bucket.projected_notional != 0.) {
+            const f64 forward = projector.Forward(
+                key.since, key.until, bucket.accrual,
+                [&] { return discount_at(bucket.projection_start_date, bucket.accrual_start_time); },
+                [&] { return discount_at(bucket.projection_date, bucket.accrual_end_time); });
+            amount += bucket.projected_notional * forward;
+        }
+        result += amount * discounted_time;
+    }
+
+    return result;
+}
+
+}  // namespace cdr
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cdr/swaps/irs.h>
+#include <cdr/curve/curve.h>
+#include <cdr/calendar/date.h>
+#include <cdr/types/integers.h>
+#include <cdr/types/floats.h>
+#include <cdr/swaps/internal/export.h>
+
+#include <compare>
+#include <map>
+
+namespace cdr {
+
+// Book-level cashflow ladder.
+//
+// Cashflows of many swaps are netted per jurisdiction into buckets keyed by
+// (settlement date, accrual period). A bucket keeps a fixed amount (fixed
+// coupons and float spreads) and the notional its floating coupons are
+// projected on, so the value of a bucket is
+//
+//   DCF(today, settlement) * DF(settlement) * (amount + notional * F(since, until))
+//
+// where F is the simple forward rate over the accrual period, projected
+// from the discount factors at its start and end dates. Buckets sharing a
+// settlement date share its discount factor, and a float bucket starting
+// where the previous one ended reuses its end discount factor. A ladder of
+// regular legs on common dates is then priced with one discount factor per
+// settlement date and one per accrual boundary, instead of three per
+// cashflow. Trades may be added and removed at any time; buckets left
+// without cashflows are dropped.
+class CDR_SWAPS_EXPORT CashflowLadder final {
+public:
+    struct Key {
+        DateType settlement;
+        DateType until;
+        DateType since;
+
+        auto operator<=>(const Key&) const = default;
+    };
+
+    struct Bucket {
+        DateType discount_date;
+        DateType projection_start_date;
+        DateType projection_date;
+        f64 accrual_start_time = 0.;
+        f64 accrual_end_time = 0.;
+        f64 accrual = 0.;
+        f64 amount = 0.;
+        f64 projected_notional = 0.;
+        u64 cashflows = 0;
+    };
+
+    using Rungs = std::map<Key, Bucket>;
+
+public:
+    // Seasoned float coupons enter as plain amounts, so a contract must be
+    // removed in the same state (fixings applied or not) it was added in
+    void Add(const IrsContract& contract);
+    void Remove(const IrsContract& contract);
+
+    void Clear() noexcept {
+        ladders_.clear();
+    }
+
+    [[nodiscard]] const Rungs& Ladder(const JurisdictionType& jur) const;
+
+    // Number of distinct settlement dates of a jurisdiction
+    [[nodiscard]] u64 DatesSize(const JurisdictionType& jur) const;
+
+    // Sum of IrsContract::ProjectedNPV over the trades of the curve's jurisdiction
+    [[nodiscard]] f64 PV(const Curve& curve) const;
+
+    // Same for the trades of `jur` priced with `curve`
+    [[nodiscard]] f64 PV(const Curve& curve, const JurisdictionType& jur) const;
+
+private:
+    void Apply(const IrsContract& contract, f64 direction);
+
+private:
+    std::map<JurisdictionType, Rungs> ladders_;
+};
+
+}  // namespace cdr
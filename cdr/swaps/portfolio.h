@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cdr/swaps/irs.h>
+#include <cdr/curve/curve.h>
+#include <cdr/types/integers.h>
+#include <cdr/types/floats.h>
+#include <cdr/swaps/internal/export.h>
+
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace cdr {
+
+// Zero rates and Act/Act ISDA year fractions from today of a curve, sampled
+// on every calendar day of [FirstDay(), LastDay()]. Days are counted since
+// the unix epoch.
+// Rates follow `Linear` between pillars and stay flat outside of them.
+class CDR_SWAPS_EXPORT CurveGrid final {
+public:
+    [[nodiscard]] static CurveGrid Build(const Curve& curve, i32 first_day, i32 last_day);
+
+    [[nodiscard]] i32 FirstDay() const noexcept {
+        return first_day_;
+    }
+
+    [[nodiscard]] i32 LastDay() const noexcept {
+        return first_day_ + static_cast<i32>(rates_.size()) - 1;
+    }
+
+    [[nodiscard]] i32 TodayDay() const noexcept {
+        return today_day_;
+    }
+
+    [[nodiscard]] f64 Rate(i32 day) const noexcept {
+        return rates_[day - first_day_];
+    }
+
+    [[nodiscard]] f64 Time(i32 day) const noexcept {
+        return times_[day - first_day_];
+    }
+
+    // Copy of the grid with every zero rate moved by `shift` (as a fraction)
+    [[nodiscard]] CurveGrid Shifted(f64 shift) const;
+
+private:
+    CurveGrid() = default;
+
+private:
+    std::vector<f64> rates_;
+    std::vector<f64> times_;
+    i32 first_day_ = 0;
+    i32 today_day_ = 0;
+};
+
+struct PortfolioValuation {
+    std::vector<f64> npv;
+    std::vector<f64> pv_fixed;
+    std::vector<f64> pv_float;
+};
+
+// Book of interest rate swaps stored as flat columns.
+//
+// Cashflows of trade `i` live in [LegOffsets()[2i], LegOffsets()[2i + 1]) for
+// the fixed leg and in [LegOffsets()[2i + 1], LegOffsets()[2i + 2]) for the
+// floating one. Curve lookup days come from the schedule data precomputed by
+// the builders, so pricing only touches the columns and a `CurveGrid`.
+// Results match IrsContract::ApplyCurve + NPV.
+class CDR_SWAPS_EXPORT SwapPortfolio final {
+public:
+    SwapPortfolio() {
+        leg_offsets_.push_back(0);
+    }
+
+    void Reserve(u64 trades, u64 cashflows);
+
+    // Returns index of the trade inside of the portfolio
+    u64 Add(const IrsContract& contract);
+
+    void Clear() noexcept;
+
+    [[nodiscard]] u64 Size() const noexcept {
+        return notionals_.size();
+    }
+
+    [[nodiscard]] u64 CashflowsSize() const noexcept {
+        return pay_days_.size();
+    }
+
+    [[nodiscard]] bool Empty() const noexcept {
+        return notionals_.empty();
+    }
+
+    [[nodiscard]] std::span<const u64> LegOffsets() const noexcept {
+        return leg_offsets_;
+    }
+
+    // Day range a grid must cover to price the book as of `today_day`
+    [[nodiscard]] i32 FirstDay(i32 today_day) const noexcept;
+    [[nodiscard]] i32 LastDay(i32 today_day) const noexcept;
+
+    [[nodiscard]] CurveGrid Prepare(const Curve& curve) const;
+
+    [[nodiscard]] PortfolioValuation Price(const Curve& curve) const;
+
+    // Prices trades [first, last) against a prepared grid. Output spans are
+    // indexed by trade number and must hold at least `last` elements.
+    void PriceRange(const CurveGrid& grid, u64 first, u64 last,
+                    std::span<f64> npv, std::span<f64> pv_fixed, std::span<f64> pv_float) const noexcept;
+
+    // Batch IrsContract::Risk: one SwapRisk per trade
+    [[nodiscard]] std::vector<SwapRisk> Risk(const Curve& curve) const;
+
+    void RiskRange(const CurveGrid& grid, u64 first, u64 last, std::span<SwapRisk> risk) const noexcept;
+
+private:
+    // Scenario revaluation in exposure.cc walks the columns directly
+    friend class ExposureEngine;
+
+    // per trade columns
+    std::vector<f64> notionals_;
+    std::vector<f64> fixed_rates_;
+    std::vector<f64> adjustments_;
+    std::vector<f64> signs_;
+    std::vector<u64> leg_offsets_;
+
+    // per cashflow columns, days since epoch
+    std::vector<i32> since_days_;
+    std::vector<i32> until_days_;
+    std::vector<i32> pay_days_;
+    std::vector<i32> discount_days_;
+    std::vector<i32> projection_start_days_;
+    std::vector<i32> projection_days_;
+    std::vector<f64> accruals_;
+    // coupons of seasoned float periods, NaN for projected ones
+    std::vector<f64> known_payments_;
+
+    i32 min_day_ = std::numeric_limits<i32>::max();
+    i32 max_day_ = std::numeric_limits<i32>::min();
+};
+
+}  // namespace cdr
@@ -0,0 +1,378 @@
+#include <gtest/gtest.h>
+#include <cdr/swaps/irs.h>
+#include <cdr/swaps/portfolio.h>
+#include <cdr/swaps/valuation.h>
+#include <cdr/swaps/ladder.h>
+#include <cdr/swaps/exposure.h>
+#include <cdr/types/percent.h>
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include <cdr/calendar/date.h>
+#include <cdr/curve/curve.h>
+#include <cdr/market/context.h>
+
+namespace {
+
+using namespace std::chrono;
+using namespace cdr::literals;
+
+cdr::MarketContext MakeContext() {
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("USD", year(2027) / January / day(1))
+        ("USD", year(2027) / May / day(31))
+        ("USD", year(2027) / July / day(5))
+        ("USD", year(2027) / December / day(24))
+        ("USD", year(2028) / January / day(3))
+    ;
+    return cdr::MarketContext(std::move(holiday_storage), day(4)/January/year(2027));
+}
+
+std::unique_ptr<cdr::Curve> MakeCurve(const cdr::MarketContext& context) {
+    return cdr::CurveBuilder(context)
+        .Jurisdiction("USD")
+        .Add(day(11)/January/year(2027), cdr::Percent::FromPercentage(4.30))
+        .Add(day(5)/April/year(2027), cdr::Percent::FromPercentage(4.45))
+        .Add(day(5)/October/year(2027), cdr::Percent::FromPercentage(4.20))
+        .Add(day(4)/January/year(2029), cdr::Percent::FromPercentage(3.90))
+        .Add(day(4)/January/year(2032), cdr::Percent::FromPercentage(3.75))
+        .Add(day(4)/January/year(2037), cdr::Percent::FromPercentage(3.95))
+        .FromPoints()
+    ;
+}
+
+std::vector<cdr::IrsContract> MakeBook(const cdr::MarketContext& context) {
+    std::vector<cdr::IrsContract> book;
+    for (int years = 1; years <= 10; ++years) {
+        book.push_back(cdr::IrsBuilderExperimental()
+            .Adjustment(cdr::Percent::FromPercentage(0.05 * years))
+            .FixedFreq({6, cdr::TimeUnit::Month})
+            .FloatFreq({3, cdr::TimeUnit::Month})
+            .FixedTerm({years, cdr::TimeUnit::Year})
+            .FloatTerm({years, cdr::TimeUnit::Year})
+            .FixedRate(cdr::Percent::FromPercentage(3.5 + 0.1 * years))
+            .Notion(1'000'000 * years)
+            .PayFix(years % 2 == 0)
+            .PaymentDateShift(2)
+            .StartShift(2)
+            .Stub(cdr::IrsContract::Stub::SHORT)
+            .TradeDate(day(4)/January/year(2027))
+            .Build(context.Calendar(), "USD", cdr::DateRollingRule::kModifiedFollowing)
+        );
+    }
+    return book;
+}
+
+}  // anonymous namespace
+
+TEST(SwapPortfolio, MatchesContractPricing) {
+    auto context = MakeContext();
+    auto curve = MakeCurve(context);
+    auto book = MakeBook(context);
+
+    cdr::SwapPortfolio portfolio;
+    for (const auto& irs : book) {
+        portfolio.Add(irs);
+    }
+    ASSERT_EQ(portfolio.Size(), book.size());
+
+    const auto valuation = portfolio.Price(*curve);
+    ASSERT_EQ(valuation.npv.size(), book.size());
+
+    for (u64 i = 0; i < book.size(); ++i) {
+        auto& irs = book[i];
+        irs.ApplyCurve(*curve);
+
+        const auto npv = irs.NPV(*curve);
+        const auto pv_fixed = irs.PVFixed(*curve);
+        const auto pv_float = irs.PVFloat(*curve);
+        ASSERT_TRUE(npv.has_value() && pv_fixed.has_value() && pv_float.has_value());
+
+        EXPECT_NEAR(valuation.npv[i], *npv, 1e-6) << "trade " << i;
+        EXPECT_NEAR(valuation.pv_fixed[i], *pv_fixed, 1e-6) << "trade " << i;
+        EXPECT_NEAR(valuation.pv_float[i], *pv_float, 1e-6) << "trade " << i;
+    }
+}
+
+TEST(SwapPortfolio, SkipsExpiredPeriods) {
+    auto context = MakeContext();
+    auto book = MakeBook(context);
+
+    cdr::SwapPortfolio portfolio;
+    for (const auto& irs : book) {
+        portfolio.Add(irs);
+    }
+
+    context.SetToday(day(4)/January/year(2029));
+    auto curve = MakeCurve(context);
+    const auto valuation = portfolio.Price(*curve);
+
+    for (u64 i = 0; i < book.size(); ++i) {
+        auto& irs = book[i];
+        irs.ApplyCurve(*curve);
+
+        const auto npv = irs.NPV(*curve);
+        ASSERT_TRUE(npv.has_value());
+        EXPECT_NEAR(valuation.npv[i], *npv, 1e-6) << "trade " << i;
+    }
+    EXPECT_EQ(valuation.npv[0], 0.);
+}
+
+TEST(SwapPortfolio, Clear) {
+    auto context = MakeContext();
+    auto curve = MakeCurve(context);
+    auto book = MakeBook(context);
+
+    cdr::SwapPortfolio portfolio;
+    portfolio.Reserve(book.size(), 0);
+    for (const auto& irs : book) {
+        portfolio.Add(irs);
+    }
+    ASSERT_FALSE(portfolio.Empty());
+
+    portfolio.Clear();
+    ASSERT_TRUE(portfolio.Empty());
+    ASSERT_EQ(portfolio.CashflowsSize(), 0);
+    ASSERT_EQ(portfolio.LegOffsets().size(), 1);
+    ASSERT_TRUE(portfolio.Price(*curve).npv.empty());
+}
+
+TEST(SwapPortfolio, ParallelValuation) {
+    auto context = MakeContext();
+    auto curve = MakeCurve(context);
+    auto book = MakeBook(context);
+
+    cdr::SwapPortfolio portfolio;
+    for (u32 copy = 0; copy < 20; ++copy) {
+        for (const auto& irs : book) {
+            portfolio.Add(irs);
+        }
+    }
+
+    auto flat = cdr::CurveBuilder(context)
+        .Jurisdiction("USD")
+        .Add(day(4)/January/year(2029), cdr::Percent::FromPercentage(4.))
+        .FromPoints()
+    ;
+
+    const std::vector<const cdr::Curve*> curves = {curve.get(), flat.get()};
+    const std::vector<f64> shifts = {-0.0001, 0., 0.0001};
+
+    cdr::ThreadPool single(1);
+    cdr::ThreadPool pool(4);
+    const auto sequential = cdr::ValueBook(single, portfolio, curves, shifts, 16);
+    const auto parallel = cdr::ValueBook(pool, portfolio, curves, shifts, 16);
+
+    ASSERT_EQ(parallel.curves, 2);
+    ASSERT_EQ(parallel.scenarios, 3);
+
+    for (u64 c = 0; c < curves.size(); ++c) {
+        const auto expected = portfolio.Price(*curves[c]);
+        ASSERT_EQ(parallel.At(c, 1).npv, expected.npv);
+
+        for (u64 s = 0; s < shifts.size(); ++s) {
+            ASSERT_EQ(parallel.At(c, s).npv, sequential.At(c, s).npv);
+            ASSERT_EQ(parallel.Total(c, s), sequential.Total(c, s));
+        }
+    }
+
+    // A parallel shift must move the value of the book
+    ASSERT_NE(parallel.Total(0, 0), parallel.Total(0, 2));
+}
+
+TEST(SwapPortfolio, BatchRisk) {
+    auto context = MakeContext();
+    auto curve = MakeCurve(context);
+    auto book = MakeBook(context);
+
+    cdr::SwapPortfolio portfolio;
+    for (const auto& irs : book) {
+        portfolio.Add(irs);
+    }
+
+    const auto risk = portfolio.Risk(*curve);
+    ASSERT_EQ(risk.size(), book.size());
+
+    for (u64 i = 0; i < book.size(); ++i) {
+        const auto expected = book[i].Risk(*curve);
+        EXPECT_NEAR(risk[i].npv, expected.npv, 1e-6) << "trade " << i;
+        EXPECT_NEAR(risk[i].annuity, expected.annuity, 1e-12) << "trade " << i;
+        EXPECT_NEAR(risk[i].par_rate, expected.par_rate, 1e-12) << "trade " << i;
+        EXPECT_NEAR(risk[i].dv01, expected.dv01, 1e-6) << "trade " << i;
+        EXPECT_NEAR(risk[i].pv01, expected.pv01, 1e-6) << "trade " << i;
+    }
+}
+
+TEST(CashflowLadder, IncrementalPV) {
+    auto context = MakeContext();
+    auto curve = MakeCurve(context);
+    auto book = MakeBook(context);
+
+    cdr::CashflowLadder ladder;
+    for (const auto& irs : book) {
+        ladder.Add(irs);
+    }
+    // Same schedules twice: buckets are shared, not duplicated
+    const u64 dates = ladder.DatesSize("USD");
+    for (const auto& irs : book) {
+        ladder.Add(irs);
+    }
+    ASSERT_EQ(ladder.DatesSize("USD"), dates);
+
+    f64 expected = 0.;
+    for (const auto& irs : book) {
+        expected += 2. * irs.ProjectedNPV(*curve);
+    }
+    ASSERT_NEAR(ladder.PV(*curve), expected, 1e-6);
+
+    for (u64 i = 0; i < book.size(); i += 2) {
+        ladder.Remove(book[i]);
+        expected -= book[i].ProjectedNPV(*curve);
+    }
+    ASSERT_NEAR(ladder.PV(*curve), expected, 1e-6);
+
+    for (const auto& irs : book) {
+        ladder.Remove(irs);
+    }
+    for (u64 i = 1; i < book.size(); i += 2) {
+        ladder.Remove(book[i]);
+    }
+    ASSERT_TRUE(ladder.Ladder("USD").empty());
+    ASSERT_EQ(ladder.PV(*curve), 0.);
+}
+
+TEST(Exposure, HullWhiteZeroBonds) {
+    auto context = MakeContext();
+    auto curve = MakeCurve(context);
+    const i32 today = cdr::DaysSinceEpoch(context.Today());
+    const auto grid = cdr::CurveGrid::Build(*curve, today, today + 12 * 366);
+
+    const cdr::HullWhite model(grid, {.mean_reversion = 0.05, .volatility = 0.012});
+    const f64 a = model.Params().mean_reversion;
+    const f64 sigma = model.Params().volatility;
+
+    // Variance of the integrated short rate over [t, T]
+    const auto variance = [&](f64 t, f64 maturity) {
+        const f64 tau = maturity - t;
+        return sigma * sigma / (a * a)
+            * (tau + 2. / a * std::exp(-a * tau) - 0.5 / a * std::exp(-2. * a * tau) - 1.5 / a);
+    };
+    for (f64 t : {0., 0.5, 2., 7.}) {
+        for (f64 tau : {0.25, 1., 5., 10.}) {
+            const f64 maturity = t + tau;
+            EXPECT_NEAR(model.B(t, maturity), -std::expm1(-a * tau) / a, 1e-14) << t << ' ' << tau;
+            const f64 expected = 0.5 * (variance(t, maturity) - variance(0., maturity) + variance(0., t));
+            EXPECT_NEAR(model.C(t, maturity), expected, 1e-12) << t << ' ' << tau;
+        }
+    }
+
+    // Bonds of today are the initial curve, bonds maturing now are worth one
+    for (i32 maturity : {today + 30, today + 365, today + 3650}) {
+        EXPECT_NEAR(model.ZeroBond(today, today, maturity, maturity, 0.),
+                    std::exp(-grid.Rate(maturity) * grid.Time(maturity)), 1e-14);
+        EXPECT_NEAR(model.ZeroBond(maturity, maturity, maturity, maturity, 0.03), 1., 1e-14);
+    }
+    // Rates are read at the curve days, times at the calendar days
+    {
+        const i32 saturday = cdr::DaysSinceEpoch(day(6)/February/year(2027));
+        const i32 monday = saturday + 2;
+        ASSERT_NE(grid.Rate(saturday), grid.Rate(monday));
+        EXPECT_NEAR(model.ZeroBond(today, today, saturday, monday, 0.),
+                    std::exp(-grid.Rate(monday) * grid.Time(saturday)), 1e-14);
+        EXPECT_NEAR(model.ZeroBond(saturday, monday, saturday, monday, 0.03), 1., 1e-14);
+    }
+
+    // Simulated states have the mean and variance of x
+    const std::vector<i32> days = {today + 91, today + 365, today + 5 * 365};
+    const u64 paths = 20'000;
+    cdr::ThreadPool pool(2);
+    const auto simulated = cdr::SimulateHullWhite(pool, model, days, paths, 7);
+
+    // The upper half of the seed is not dropped
+    const auto high_seed = cdr::SimulateHullWhite(pool, model, days, 4, 7 + (u64{1} << 32));
+    ASSERT_NE(high_seed.At(0, 0), simulated.At(0, 0));
+    for (u64 step = 0; step < days.size(); ++step) {
+        f64 sum = 0.;
+        f64 sum_squares = 0.;
+        for (f64 x : simulated.Step(step)) {
+            sum += x;
+            sum_squares += x * x;
+        }
+        const f64 deviation = model.StdDev(grid.Time(days[step]));
+        const f64 mean = sum / paths;
+        EXPECT_NEAR(mean, 0., 4. * deviation / std::sqrt(f64(paths))) << step;
+        EXPECT_NEAR(sum_squares / paths - mean * mean, deviation * deviation, 0.05 * deviation * deviation) << step;
+    }
+}
+
+TEST(Exposure, DeterministicModelMatchesPricing) {
+    auto context = MakeContext();
+    auto curve = MakeCurve(context);
+    auto book = MakeBook(context);
+
+    cdr::SwapPortfolio portfolio;
+    for (const auto& irs : book) {
+        portfolio.Add(irs);
+    }
+
+    cdr::ExposureSettings settings;
+    settings.dates = {day(4)/January/year(2027), day(4)/July/year(2027), day(4)/January/year(2030)};
+    settings.paths = 16;
+    settings.model.volatility = 0.;
+
+    cdr::ThreadPool pool(2);
+    const auto profile = cdr::SimulateExposure(pool, portfolio, *curve, settings);
+    ASSERT_EQ(profile.values.size(), settings.dates.size() * settings.paths);
+
+    f64 expected = 0.;
+    for (f64 npv : portfolio.Price(*curve).npv) {
+        expected += npv;
+    }
+    // Without volatility every path follows the initial curve
+    for (u64 step = 0; step < settings.dates.size(); ++step) {
+        for (u64 path = 1; path < settings.paths; ++path) {
+            ASSERT_EQ(profile.Value(step, path), profile.Value(step, 0));
+        }
+        EXPECT_DOUBLE_EQ(profile.expected_exposure[step], std::max(profile.Value(step, 0), 0.));
+    }
+    EXPECT_NEAR(profile.Value(0, 0), expected, 1e-6);
+}
+
+TEST(Exposure, ReproducibleProfile) {
+    auto context = MakeContext();
+    auto curve = MakeCurve(context);
+    auto book = MakeBook(context);
+
+    cdr::SwapPortfolio portfolio;
+    for (const auto& irs : book) {
+        portfolio.Add(irs);
+    }
+
+    cdr::ExposureSettings settings;
+    for (int months = 3; months <= 123; months += 3) {
+        settings.dates.push_back(day(4)/January/year(2027) + std::chrono::months(months));
+    }
+    settings.paths = 200;
+    settings.grain = 16;
+    settings.model = {.mean_reversion = 0.05, .volatility = 0.01};
+
+    cdr::ThreadPool single(1);
+    cdr::ThreadPool pool(3);
+    const auto sequential = cdr::SimulateExposure(single, portfolio, *curve, settings);
+    const auto parallel = cdr::SimulateExposure(pool, portfolio, *curve, settings);
+    ASSERT_EQ(sequential.values, parallel.values);
+
+    bool spread = false;
+    for (u64 step = 0; step < settings.dates.size(); ++step) {
+        EXPECT_GE(parallel.expected_exposure[step], 0.);
+        EXPECT_GE(parallel.potential_future_exposure[step], parallel.expected_exposure[step]);
+        spread |= parallel.Value(step, 0) != parallel.Value(step, 1);
+    }
+    ASSERT_TRUE(spread);
+
+    // The book has run off after its last maturity
+    EXPECT_EQ(parallel.expected_exposure.back(), 0.);
+}
@@ -1,11 +1,20 @@
 #include <gtest/gtest.h>
 #include <cdr/swaps/irs.h>
+#include <cdr/swaps/bulk.h>
+#include <cdr/swaps/ladder.h>
+#include <cdr/swaps/portfolio.h>
+#include <cdr/market/fixings.h>
 #include <cdr/types/percent.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
 
 #include <cdr/calendar/date.h>
 #include <cdr/curve/curve.h>
+#include <cdr/market/context.h>
 
 TEST(Swaps, Basic) {
     using namespace std::chrono;
@@ -44,16 +53,89 @@ TEST(Swaps, Basic) {
       .Build(context.Calendar(), "RUS")
     ;
 
-    for (const cdr::IrsPaymentPeriod& payment : irs.FixedLeg()) {
-        ASSERT_TRUE(payment.HasKnownPayment());
+    for (u64 idx = 0; idx < irs.FixedLeg().size(); ++idx) {
+        const auto& period = irs.FixedLeg()[idx];
+        ASSERT_DOUBLE_EQ(irs.FixedPayment(idx),
+                         0.24 * 2'000'000 * cdr::DayCountFraction({period.Since(), period.Until()}));
     }
 
-    for (const cdr::IrsPaymentPeriod& payment : irs.FloatLeg()) {
-        ASSERT_FALSE(payment.HasKnownPayment());
+    for (u64 idx = 0; idx < irs.FloatLeg().size(); ++idx) {
+        ASSERT_FALSE(irs.FloatPayment(idx).has_value());
     }
 
     auto pv_fixed = irs.PVFixed(*curve);
     ASSERT_TRUE(pv_fixed.has_value());
+
+    // On a zero curve each alive period adds rate * notional * DCF(today,
+    // settlement), not its FixedPayment, see IrsContract::PVFixed
+    f64 times = 0.;
+    for (const cdr::IrsPaymentPeriod& period : irs.FixedLeg()) {
+        if (period.Until() >= today) {
+            times += cdr::DayCountFraction({today, period.SettlementDate()});
+        }
+    }
+    ASSERT_GT(times, 0.);
+    ASSERT_NEAR(*pv_fixed, 0.24 * 2'000'000 * times, 1e-6);
+}
+
+TEST(Swaps, BuilderKeepsAdjustment) {
+    using namespace std::chrono;
+
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("RUS", year(2025) / January / day(1))
+    ;
+
+    cdr::IrsContract irs = cdr::IrsBuilder()
+      .FixedRate(cdr::Percent::FromFraction(0.24))
+      .PayFix(true)
+      .Notion(2'000'000)
+      .FixedFreq(cdr::Freq::kQuarterly)
+      .FloatFreq(cdr::Freq::kAnnualy)
+      .MaturityDate(day(1) / January / year(2025))
+      .SettlementDate(day(1) / January / year(2023))
+      .Adjustment(cdr::Percent::FromPercentage(0.5))
+      .Build(holiday_storage, "RUS")
+    ;
+
+    ASSERT_EQ(irs.Adjustment(), cdr::Percent::FromPercentage(0.5));
+}
+
+TEST(Swaps, ChronologicalEnds) {
+    using namespace std::chrono;
+
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("RUS", year(2025) / January / day(1))
+    ;
+
+    cdr::IrsContract irs = cdr::IrsBuilder()
+      .FixedRate(cdr::Percent::FromFraction(0.24))
+      .PayFix(true)
+      .Notion(2'000'000)
+      .FixedFreq(cdr::Freq::kAnnualy)
+      .FloatFreq(cdr::Freq::kQuarterly)
+      .MaturityDate(day(1) / January / year(2025))
+      .SettlementDate(day(1) / January / year(2023))
+      .Adjustment(cdr::Percent::Zero())
+      .Build(holiday_storage, "RUS")
+    ;
+
+    DateType first = irs.FixedLeg().front().Since();
+    DateType last = irs.FixedLeg().front().Since();
+    for (const cdr::IrsPaymentPeriod& period : irs.FixedLeg()) {
+        first = std::min(first, period.Since());
+        last = std::max(last, period.Since());
+    }
+    for (const cdr::IrsPaymentPeriod& period : irs.FloatLeg()) {
+        first = std::min(first, period.Since());
+        last = std::max(last, period.Since());
+    }
+
+    ASSERT_TRUE(irs.ChronoFirstPeriod().ChronoFirstPayment());
+    ASSERT_EQ(irs.ChronoFirstPeriod().Since(), first);
+    ASSERT_TRUE(irs.ChronoLastPeriod().ChronoLastPayment());
+    ASSERT_EQ(irs.ChronoLastPeriod().Since(), last);
 }
 
 TEST(Basic, Experimental) {
@@ -101,3 +183,367 @@ TEST(Basic, Experimental) {
     ASSERT_EQ(swap.FixedLeg().back().Since(), tomorrow);
     ASSERT_EQ(swap.FixedLeg().back().Until(), jan12);
 }
+
+TEST(Swaps, ConstPricing) {
+    using namespace std::chrono;
+
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("USD", year(2027) / January / day(1))
+        ("USD", year(2027) / July / day(5))
+    ;
+    cdr::MarketContext context(std::move(holiday_storage), day(4)/January/year(2027));
+
+    auto low = cdr::CurveBuilder(context)
+        .Jurisdiction("USD")
+        .Add(day(5)/April/year(2027), cdr::Percent::FromPercentage(3.5))
+        .Add(day(4)/January/year(2030), cdr::Percent::FromPercentage(3.25))
+        .FromPoints()
+    ;
+    auto high = cdr::CurveBuilder(context)
+        .Jurisdiction("USD")
+        .Add(day(5)/April/year(2027), cdr::Percent::FromPercentage(5.))
+        .Add(day(4)/January/year(2030), cdr::Percent::FromPercentage(4.5))
+        .FromPoints()
+    ;
+
+    const cdr::IrsContract irs = cdr::IrsBuilderExperimental()
+        .Adjustment(cdr::Percent::FromPercentage(0.1))
+        .FixedFreq({6, cdr::TimeUnit::Month})
+        .FloatFreq({3, cdr::TimeUnit::Month})
+        .FixedTerm({3, cdr::TimeUnit::Year})
+        .FloatTerm({3, cdr::TimeUnit::Year})
+        .FixedRate(cdr::Percent::FromPercentage(4.))
+        .Notion(1'000'000)
+        .PayFix(true)
+        .PaymentDateShift(2)
+        .StartShift(2)
+        .Stub(cdr::IrsContract::Stub::SHORT)
+        .TradeDate(context.Today())
+        .Build(context.Calendar(), "USD")
+    ;
+
+    auto expected = [&irs](const cdr::Curve& curve) {
+        cdr::IrsContract copy = irs;
+        copy.ApplyCurve(curve);
+        return std::make_pair(*copy.NPV(curve), *copy.PVFloat(curve));
+    };
+    const auto [low_npv, low_float] = expected(*low);
+    const auto [high_npv, high_float] = expected(*high);
+    ASSERT_NE(low_npv, high_npv);
+
+    // The shared contract is only read, so both curves may price it at once
+    f64 npv[2] = {};
+    f64 pv_float[2] = {};
+    std::thread other([&] {
+        npv[1] = irs.ProjectedNPV(*high);
+        pv_float[1] = irs.ProjectedPVFloat(*high);
+    });
+    npv[0] = irs.ProjectedNPV(*low);
+    pv_float[0] = irs.ProjectedPVFloat(*low);
+    other.join();
+
+    ASSERT_DOUBLE_EQ(npv[0], low_npv);
+    ASSERT_DOUBLE_EQ(npv[1], high_npv);
+    ASSERT_DOUBLE_EQ(pv_float[0], low_float);
+    ASSERT_DOUBLE_EQ(pv_float[1], high_float);
+
+    std::vector<f64> payments(irs.FloatLeg().size());
+    irs.ProjectFloatLeg(*high, payments);
+    ASSERT_DOUBLE_EQ(irs.PVFloat(*high, payments), high_float);
+
+    for (u64 idx = 0; idx < irs.FloatLeg().size(); ++idx) {
+        ASSERT_FALSE(irs.FloatPayment(idx).has_value());
+    }
+}
+
+TEST(Swaps, Risk) {
+    using namespace std::chrono;
+
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("USD", year(2027) / January / day(1))
+        ("USD", year(2027) / July / day(5))
+    ;
+    cdr::MarketContext context(std::move(holiday_storage), day(4)/January/year(2027));
+
+    auto make_curve = [&](f64 shift) {
+        return cdr::CurveBuilder(context)
+            .Jurisdiction("USD")
+            .Add(day(5)/April/year(2027), cdr::Percent::FromFraction(0.035 + shift))
+            .Add(day(4)/January/year(2029), cdr::Percent::FromFraction(0.04 + shift))
+            .Add(day(4)/January/year(2032), cdr::Percent::FromFraction(0.0375 + shift))
+            .FromPoints()
+        ;
+    };
+    auto make_swap = [&](cdr::Percent fixed_rate) {
+        return cdr::IrsBuilderExperimental()
+            .Adjustment(cdr::Percent::FromPercentage(0.1))
+            .FixedFreq({6, cdr::TimeUnit::Month})
+            .FloatFreq({3, cdr::TimeUnit::Month})
+            .FixedTerm({5, cdr::TimeUnit::Year})
+            .FloatTerm({5, cdr::TimeUnit::Year})
+            .FixedRate(fixed_rate)
+            .Notion(10'000'000)
+            .PayFix(false)
+            .PaymentDateShift(2)
+            .StartShift(2)
+            .Stub(cdr::IrsContract::Stub::SHORT)
+            .TradeDate(context.Today())
+            .Build(context.Calendar(), "USD")
+        ;
+    };
+
+    auto curve = make_curve(0.);
+    const auto irs = make_swap(cdr::Percent::FromPercentage(3.));
+    const cdr::SwapRisk risk = irs.Risk(*curve);
+
+    ASSERT_NEAR(risk.npv, irs.ProjectedNPV(*curve), 1e-6);
+    ASSERT_NEAR(risk.pv_fixed, *irs.PVFixed(*curve), 1e-6);
+    ASSERT_NEAR(risk.pv_float, irs.ProjectedPVFloat(*curve), 1e-6);
+    ASSERT_NEAR(risk.pv_fixed, 0.03 * 10'000'000 * risk.annuity, 1e-6);
+    ASSERT_NEAR(risk.pv01, risk.pv_fixed / 0.03 * cdr::SwapRisk::kBasisPoint, 1e-6);
+
+    // Central difference of a real parallel bump of the pillars
+    auto up = make_curve(cdr::SwapRisk::kBasisPoint);
+    auto down = make_curve(-cdr::SwapRisk::kBasisPoint);
+    const f64 bumped_dv01 = (irs.ProjectedNPV(*up) - irs.ProjectedNPV(*down)) / 2.;
+    ASSERT_NEAR(risk.dv01, bumped_dv01, 1e-3 * std::abs(bumped_dv01));
+
+    const auto at_par = make_swap(cdr::Percent::FromFraction(risk.par_rate));
+    ASSERT_NEAR(at_par.ProjectedNPV(*curve), 0., 1e-6);
+}
+
+TEST(Swaps, BulkBuild) {
+    using namespace std::chrono;
+
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("USD", year(2027) / January / day(1))
+        ("USD", year(2027) / July / day(5))
+        ("USD", year(2028) / January / day(3))
+    ;
+
+    cdr::IrsTradeTable table;
+    table.Reserve(300);
+    for (u32 i = 0; i < 300; ++i) {
+        const DateType settlement = SysDays{day(4)/January/year(2027)} + days(i % 40);
+        const DateType maturity = SysDays{settlement} + days(365 * (1 + i % 7) + i % 11);
+        table.Add(settlement, maturity,
+                  i % 2 == 0 ? cdr::Freq::kSemiAnnualy : cdr::Freq::kAnnualy,
+                  i % 3 == 0 ? cdr::Freq::kQuarterly : cdr::Freq::kMonthly,
+                  cdr::Percent::FromPercentage(3. + 0.01 * i), cdr::Percent::FromPercentage(0.1),
+                  1'000'000. + i, i % 5 == 0);
+    }
+
+    cdr::ThreadPool pool(3);
+    const auto contracts = cdr::BuildIrsContracts(pool, table, holiday_storage, "USD",
+                                                  cdr::DateRollingRule::kModifiedFollowing, 16);
+    ASSERT_EQ(contracts.size(), table.Size());
+
+    cdr::IrsBuilder builder;
+    for (u64 i = 0; i < table.Size(); ++i) {
+        const auto expected = builder
+            .SettlementDate(table.settlement_dates[i])
+            .MaturityDate(table.maturity_dates[i])
+            .FixedFreq(table.fixed_freqs[i])
+            .FloatFreq(table.float_freqs[i])
+            .FixedRate(table.fixed_rates[i])
+            .Adjustment(table.adjustments[i])
+            .Notion(table.notionals[i])
+            .PayFix(table.paying_fix[i] != 0)
+            .Build(holiday_storage, "USD", cdr::DateRollingRule::kModifiedFollowing)
+        ;
+        const auto& actual = contracts[i];
+
+        ASSERT_EQ(actual.Notional(), expected.Notional());
+        ASSERT_EQ(actual.PayFix(), expected.PayFix());
+        ASSERT_EQ(actual.Adjustment().Fraction(), 0.001);
+        ASSERT_EQ(actual.FixedLeg().size(), expected.FixedLeg().size());
+        ASSERT_EQ(actual.FloatLeg().size(), expected.FloatLeg().size());
+
+        for (u64 k = 0; k < actual.FixedLeg().size(); ++k) {
+            ASSERT_EQ(actual.FixedLeg()[k].Since(), expected.FixedLeg()[k].Since());
+            ASSERT_EQ(actual.FixedLeg()[k].Until(), expected.FixedLeg()[k].Until());
+            ASSERT_EQ(actual.FixedPayment(k), expected.FixedPayment(k));
+        }
+
+        // Periods are chained chronologically through both legs
+        u64 first_periods = 0;
+        u64 last_periods = 0;
+        for (const auto& leg : {actual.FixedLeg(), actual.FloatLeg()}) {
+            for (u64 k = 0; k < leg.size(); ++k) {
+                if (k + 1 < leg.size()) {
+                    ASSERT_EQ(leg[k].Until(), leg[k + 1].Since());
+                }
+                ASSERT_LE(leg[k].Until(), table.maturity_dates[i]);
+                first_periods += leg[k].ChronoFirstPayment();
+                last_periods += leg[k].ChronoLastPayment();
+            }
+        }
+        ASSERT_EQ(first_periods, 1);
+        ASSERT_EQ(last_periods, 1);
+    }
+}
+
+TEST(Swaps, SharedSchedules) {
+    using namespace std::chrono;
+
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("USD", year(2027) / January / day(1))
+        ("USD", year(2027) / July / day(5))
+    ;
+    cdr::MarketContext context(std::move(holiday_storage), day(4)/January/year(2027));
+    auto curve = cdr::CurveBuilder(context)
+        .Jurisdiction("USD")
+        .Add(day(5)/April/year(2027), cdr::Percent::FromPercentage(3.5))
+        .Add(day(4)/January/year(2032), cdr::Percent::FromPercentage(4.))
+        .FromPoints()
+    ;
+
+    // 20 distinct schedules behind 1'000 trades
+    cdr::IrsTradeTable table;
+    for (u32 i = 0; i < 1'000; ++i) {
+        const DateType settlement = SysDays{day(4)/January/year(2027)} + days(i % 4);
+        const DateType maturity = SysDays{settlement} + days(365 * (1 + i % 5));
+        table.Add(settlement, maturity, cdr::Freq::kSemiAnnualy, cdr::Freq::kQuarterly,
+                  cdr::Percent::FromPercentage(3. + 0.001 * i), cdr::Percent::FromPercentage(0.1),
+                  1'000'000. + i, i % 2 == 0);
+    }
+
+    cdr::ThreadPool pool(3);
+    cdr::IrsScheduleCache cache;
+    const auto shared = cdr::BuildIrsContracts(pool, cache, table, context.Calendar(), "USD",
+                                               cdr::DateRollingRule::kModifiedFollowing, 64);
+    const auto owned = cdr::BuildIrsContracts(pool, table, context.Calendar(), "USD",
+                                              cdr::DateRollingRule::kModifiedFollowing, 64);
+    ASSERT_EQ(cache.Size(), 20);
+    ASSERT_EQ(shared[0].SharedSchedule(), shared[20].SharedSchedule());
+    ASSERT_NE(shared[0].SharedSchedule(), shared[1].SharedSchedule());
+
+    u64 owned_bytes = 0;
+    u64 shared_bytes = cache.MemoryUsage();
+    for (u64 i = 0; i < table.Size(); ++i) {
+        ASSERT_EQ(shared[i].ProjectedNPV(*curve), owned[i].ProjectedNPV(*curve));
+        owned_bytes += owned[i].MemoryUsage() + owned[i].Schedule().MemoryUsage();
+        shared_bytes += shared[i].MemoryUsage();
+    }
+    ASSERT_LT(shared_bytes * 5, owned_bytes);
+
+    // Projected coupons are trade state and leave the shared schedule untouched
+    auto irs = shared[0];
+    irs.ApplyCurve(*curve);
+    ASSERT_TRUE(irs.FloatPayment(0).has_value());
+    ASSERT_FALSE(shared[20].FloatPayment(0).has_value());
+    ASSERT_DOUBLE_EQ(*irs.NPV(*curve), shared[0].ProjectedNPV(*curve));
+}
+
+TEST(Swaps, ForwardProjection) {
+    using namespace std::chrono;
+
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("USD", year(2027) / January / day(1))
+    ;
+    cdr::MarketContext context(std::move(holiday_storage), day(4)/January/year(2027));
+
+    const f64 rate = 0.04;
+    auto flat = cdr::CurveBuilder(context)
+        .Jurisdiction("USD")
+        .Add(day(4)/January/year(2030), cdr::Percent::FromFraction(rate))
+        .FromPoints()
+    ;
+
+    auto irs = cdr::IrsBuilder()
+        .FixedRate(cdr::Percent::FromPercentage(4.))
+        .PayFix(true)
+        .Notion(1'000'000)
+        .FixedFreq(cdr::Freq::kAnnualy)
+        .FloatFreq(cdr::Freq::kQuarterly)
+        .SettlementDate(day(6)/January/year(2027))
+        .MaturityDate(day(6)/January/year(2029))
+        .Adjustment(cdr::Percent::FromPercentage(0.1))
+        .Build(context.Calendar(), "USD", cdr::DateRollingRule::kModifiedFollowing)
+    ;
+    irs.ApplyCurve(*flat);
+
+    // On a flat continuously compounded curve the simple forward over a
+    // period only depends on its length
+    const auto leg = irs.FloatLeg();
+    for (u64 idx = 0; idx < leg.size(); ++idx) {
+        const auto& period = leg[idx];
+        const f64 length = period.AccrualEndTime() - period.AccrualStartTime();
+        const f64 forward = (std::exp(rate * length) - 1.) / period.Accrual();
+        ASSERT_NEAR(*irs.FloatPayment(idx), (forward + 0.001) * 1'000'000, 1e-6) << "period " << idx;
+        ASSERT_GT(forward, rate);
+    }
+}
+
+TEST(Swaps, SeasonedCoupons) {
+    using namespace std::chrono;
+
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("USD", year(2026) / July / day(3))
+        ("USD", year(2027) / January / day(1))
+    ;
+    const DateType today = day(4)/January/year(2027);
+    cdr::MarketContext context(std::move(holiday_storage), today);
+    auto curve = cdr::CurveBuilder(context)
+        .Jurisdiction("USD")
+        .Add(day(5)/April/year(2027), cdr::Percent::FromPercentage(3.5))
+        .Add(day(4)/January/year(2030), cdr::Percent::FromPercentage(4.))
+        .FromPoints()
+    ;
+
+    cdr::FixingsStore store;
+    for (DateType date = day(1)/January/year(2026); date < today; date = cdr::NextDay(date)) {
+        const auto offset = (SysDays{date} - SysDays{day(1)/January/year(2026)}).count();
+        ASSERT_TRUE(store.Append("SOFR", date, 0.05 - 1e-5 * static_cast<f64>(offset)).Succeed());
+    }
+    const auto fixings = *store.Find("SOFR");
+
+    auto irs = cdr::IrsBuilder()
+        .FixedRate(cdr::Percent::FromPercentage(4.))
+        .PayFix(true)
+        .Notion(1'000'000)
+        .FixedFreq(cdr::Freq::kSemiAnnualy)
+        .FloatFreq(cdr::Freq::kQuarterly)
+        .SettlementDate(day(6)/April/year(2026))
+        .MaturityDate(day(6)/April/year(2029))
+        .Adjustment(cdr::Percent::FromPercentage(0.1))
+        .Build(context.Calendar(), "USD", cdr::DateRollingRule::kModifiedFollowing)
+    ;
+    const f64 projected_npv = irs.ProjectedNPV(*curve);
+
+    ASSERT_TRUE(irs.ApplyFixings(fixings, today).Succeed());
+    ASSERT_EQ(irs.SeasonedPeriods(), 3);
+    for (u64 idx = 0; idx < irs.SeasonedPeriods(); ++idx) {
+        const auto fixing = fixings.Find(irs.FloatLeg()[idx].Since());
+        ASSERT_DOUBLE_EQ(*irs.FloatPayment(idx), (*fixing + 0.001) * 1'000'000);
+    }
+    ASSERT_FALSE(irs.FloatPayment(irs.SeasonedPeriods()).has_value());
+
+    // The live period is fixed, later ones are still projected
+    const f64 seasoned_npv = irs.ProjectedNPV(*curve);
+    ASSERT_NE(seasoned_npv, projected_npv);
+
+    irs.ApplyCurve(*curve);
+    ASSERT_NEAR(*irs.NPV(*curve), seasoned_npv, 1e-6);
+    ASSERT_NEAR(irs.Risk(*curve).npv, seasoned_npv, 1e-6);
+
+    cdr::SwapPortfolio portfolio;
+    portfolio.Add(irs);
+    ASSERT_NEAR(portfolio.Price(*curve).npv[0], seasoned_npv, 1e-6);
+    ASSERT_NEAR(portfolio.Risk(*curve)[0].npv, seasoned_npv, 1e-6);
+
+    cdr::CashflowLadder ladder;
+    ladder.Add(irs);
+    ASSERT_NEAR(ladder.PV(*curve), seasoned_npv, 1e-6);
+
+    cdr::FixingsStore late;
+    ASSERT_TRUE(late.Append("SOFR", day(1)/December/year(2026), 0.04).Succeed());
+    ASSERT_EQ(irs.ApplyFixings(*late.Find("SOFR"), today), cdr::ErrorNoData());
+    ASSERT_EQ(irs.SeasonedPeriods(), 3);
+}
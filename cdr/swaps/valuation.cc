@@ -0,0 +1,92 @@
+#include <cdr/swaps/valuation.h>
+
+#include <cdr/base/check.h>
+
+#include <algorithm>
+#include <optional>
+
+namespace cdr {
+
+[[nodiscard]] BookValuation ValueBook(ThreadPool& pool, const SwapPortfolio& book,
+                                      std::span<const Curve* const> curves,
+                                      std::span<const f64> shifts, u64 grain) {
+    static constexpr f64 kNoShift[] = {0.};
+    if (shifts.empty()) {
+        shifts = kNoShift;
+    }
+    grain = std::max<u64>(grain, 1);
+
+    BookValuation result;
+    result.curves = curves.size();
+    result.scenarios = shifts.size();
+
+    const u64 jobs = result.curves * result.scenarios;
+    result.results.resize(jobs);
+    result.totals.assign(jobs, 0.);
+
+    if (jobs == 0 || book.Empty()) [[unlikely]] {
+        for (auto& valuation : result.results) {
+            valuation.npv.resize(book.Size());
+            valuation.pv_fixed.resize(book.Size());
+            valuation.pv_float.resize(book.Size());
+        }
+        return result;
+    }
+
+    for (const Curve* curve : curves) {
+        CDR_CHECK(curve != nullptr) << "curve must be provided";
+    }
+
+    // Sampling a curve is dominated by day count math, so grids are built in parallel too
+    std::vector<std::optional<CurveGrid>> base_grids(curves.size());
+    pool.ParallelFor(0, curves.size(), 1, [&](u64 first, u64 last) {
+        for (u64 curve = first; curve < last; ++curve) {
+            base_grids[curve].emplace(book.Prepare(*curves[curve]));
+        }
+    });
+
+    std::vector<std::optional<CurveGrid>> shifted_grids(jobs);
+    std::vector<const CurveGrid*> grids(jobs, nullptr);
+    pool.ParallelFor(0, jobs, 1, [&](u64 first, u64 last) {
+        for (u64 job = first; job < last; ++job) {
+            const auto& base = *base_grids[job / result.scenarios];
+            const f64 shift = shifts[job % result.scenarios];
+            if (shift == 0.) {
+                grids[job] = &base;
+            } else {
+                grids[job] = &shifted_grids[job].emplace(base.Shifted(shift));
+            }
+
+            auto& valuation = result.results[job];
+            valuation.npv.resize(book.Size());
+            valuation.pv_fixed.resize(book.Size());
+            valuation.pv_float.resize(book.Size());
+        }
+    });
+
+    const u64 chunks_per_job = (book.Size() + grain - 1) / grain;
+    pool.ParallelFor(0, jobs * chunks_per_job, 1, [&](u64 first, u64 last) {
+        for (u64 task = first; task < last; ++task) {
+            const u64 job = task / chunks_per_job;
+            const u64 begin = (task % chunks_per_job) * grain;
+            const u64 end = std::min(begin + grain, book.Size());
+
+            auto& valuation = result.results[job];
+            book.PriceRange(*grids[job], begin, end, valuation.npv, valuation.pv_fixed, valuation.pv_float);
+        }
+    });
+
+    pool.ParallelFor(0, jobs, 1, [&](u64 first, u64 last) {
+        for (u64 job = first; job < last; ++job) {
+            f64 total = 0.;
+            for (f64 npv : result.results[job].npv) {
+                total += npv;
+            }
+            result.totals[job] = total;
+        }
+    });
+
+    return result;
+}
+
+}  // namespace cdr
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cdr/swaps/portfolio.h>
+#include <cdr/base/thread_pool.h>
+#include <cdr/curve/curve.h>
+#include <cdr/types/integers.h>
+#include <cdr/types/floats.h>
+#include <cdr/swaps/internal/export.h>
+
+#include <span>
+#include <vector>
+
+namespace cdr {
+
+// Valuation of one book against curves x scenarios. Results of curve `c`
+// under scenario `s` are stored at index `c * scenarios + s`.
+struct BookValuation {
+    u64 curves = 0;
+    u64 scenarios = 0;
+    std::vector<PortfolioValuation> results;
+    // Sum of trade NPVs, accumulated in trade order
+    std::vector<f64> totals;
+
+    [[nodiscard]] const PortfolioValuation& At(u64 curve, u64 scenario) const noexcept {
+        return results[curve * scenarios + scenario];
+    }
+
+    [[nodiscard]] f64 Total(u64 curve, u64 scenario) const noexcept {
+        return totals[curve * scenarios + scenario];
+    }
+};
+
+inline constexpr u64 kDefaultValuationGrain = 512;
+
+// Prices `book` against every curve under every parallel zero rate shift
+// (fractions, e.g. 0.0001 for +1bp). Work is split into chunks of `grain`
+// trades per (curve, scenario) and spread over `pool`. Chunking does not
+// depend on the pool size and totals are reduced in a fixed order, so the
+// result is bit-identical for any number of threads. Empty `shifts` means
+// a single unshifted scenario.
+[[nodiscard]] CDR_SWAPS_EXPORT BookValuation ValueBook(ThreadPool& pool, const SwapPortfolio& book,
+                                                       std::span<const Curve* const> curves,
+                                                       std::span<const f64> shifts,
+                                                       u64 grain = kDefaultValuationGrain);
+
+}  // namespace cdr
@@ -0,0 +1,111 @@
+#include <benchmark/benchmark.h>
+
+#include <cdr/swaps/irs.h>
+#include <cdr/swaps/portfolio.h>
+#include <cdr/swaps/valuation.h>
+#include <cdr/market/context.h>
+
+#include <chrono>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+
+cdr::HolidayStorage MakeCalendar() {
+    cdr::HolidayStorage holiday_storage;
+    holiday_storage.StaticInit()
+        ("USD", year(2027) / January / day(1))
+        ("USD", year(2027) / July / day(5))
+        ("USD", year(2027) / December / day(24))
+    ;
+    return holiday_storage;
+}
+
+struct BookFixture {
+    BookFixture()
+        : context(MakeCalendar(), day(4)/January/year(2027))
+    {
+        curve = cdr::CurveBuilder(context)
+            .Jurisdiction("USD")
+            .Add(day(11)/January/year(2027), cdr::Percent::FromPercentage(4.30))
+            .Add(day(5)/April/year(2027), cdr::Percent::FromPercentage(4.45))
+            .Add(day(4)/January/year(2029), cdr::Percent::FromPercentage(3.90))
+            .Add(day(4)/January/year(2032), cdr::Percent::FromPercentage(3.75))
+            .Add(day(4)/January/year(2037), cdr::Percent::FromPercentage(3.95))
+            .Add(day(4)/January/year(2047), cdr::Percent::FromPercentage(4.10))
+            .FromPoints()
+        ;
+
+        // A few hundred distinct schedules, replicated into a book of 100k trades
+        std::vector<cdr::IrsContract> templates;
+        for (int years = 1; years <= 30; ++years) {
+            for (int shift = 0; shift < 10; ++shift) {
+                templates.push_back(cdr::IrsBuilderExperimental()
+                    .Adjustment(cdr::Percent::FromPercentage(0.01 * shift))
+                    .FixedFreq({6, cdr::TimeUnit::Month})
+                    .FloatFreq({3, cdr::TimeUnit::Month})
+                    .FixedTerm({years, cdr::TimeUnit::Year})
+                    .FloatTerm({years, cdr::TimeUnit::Year})
+                    .FixedRate(cdr::Percent::FromPercentage(3.5 + 0.05 * shift))
+                    .Notion(1'000'000)
+                    .PayFix(shift % 2 == 0)
+                    .PaymentDateShift(2)
+                    .StartShift(shift)
+                    .Stub(cdr::IrsContract::Stub::SHORT)
+                    .TradeDate(context.Today())
+                    .Build(context.Calendar(), "USD")
+                );
+            }
+        }
+
+        constexpr u64 kTrades = 100'000;
+        book.Reserve(kTrades, 0);
+        for (u64 i = 0; i < kTrades; ++i) {
+            book.Add(templates[i % templates.size()]);
+        }
+    }
+
+    cdr::MarketContext context;
+    std::unique_ptr<cdr::Curve> curve;
+    cdr::SwapPortfolio book;
+};
+
+const BookFixture& Fixture() {
+    static const BookFixture fixture;
+    return fixture;
+}
+
+}  // anonymous namespace
+
+static void BM_SwapPortfolio_Price(benchmark::State& state) {
+    const auto& fixture = Fixture();
+    for (auto _ : state) {
+        auto valuation = fixture.book.Price(*fixture.curve);
+        benchmark::DoNotOptimize(valuation.npv.data());
+    }
+    state.SetItemsProcessed(state.iterations() * fixture.book.Size());
+}
+
+// Book x 2 curves x 5 parallel shifts, scaled over the number of threads
+static void BM_ValueBook_Scaling(benchmark::State& state) {
+    const auto& fixture = Fixture();
+    cdr::ThreadPool pool(static_cast<u32>(state.range(0)));
+
+    const std::vector<const cdr::Curve*> curves = {fixture.curve.get(), fixture.curve.get()};
+    const std::vector<f64> shifts = {-0.0002, -0.0001, 0., 0.0001, 0.0002};
+
+    for (auto _ : state) {
+        auto valuation = cdr::ValueBook(pool, fixture.book, curves, shifts);
+        benchmark::DoNotOptimize(valuation.totals.data());
+    }
+    state.SetItemsProcessed(state.iterations() * fixture.book.Size() * curves.size() * shifts.size());
+}
+
+BENCHMARK(BM_SwapPortfolio_Price)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ValueBook_Scaling)
+    ->DenseRange(1, static_cast<int>(cdr::ThreadPool::DefaultConcurrency()))
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
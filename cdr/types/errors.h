@@ -21,6 +21,8 @@ enum class Error {
     DeltaExtrapolationNotAllowed,
     CalibrationFailed,
     RootNotFound,
+    IOFailure,
+    CorruptedData,
     __NumberOfErrors,
 };
 
@@ -96,6 +98,14 @@ constexpr Failure<Error> ErrorRootNotFound() {
     return Failure<Error>(Error::RootNotFound);
 }
 
+constexpr Failure<Error> ErrorIOFailure() {
+    return Failure<Error>(Error::IOFailure);
+}
+
+constexpr Failure<Error> ErrorCorruptedData() {
+    return Failure<Error>(Error::CorruptedData);
+}
+
 [[nodiscard]] constexpr std::string_view ErrorAsStringView(const Error error) noexcept {
     switch (error) {
     case Error::ContractWithoutNPV:               return "Contract without NPV";
@@ -114,6 +124,8 @@ constexpr Failure<Error> ErrorRootNotFound() {
     case Error::DeltaExtrapolationNotAllowed:    return "Delta extrapolation is not allowed";
     case Error::CalibrationFailed:               return "Calibration failed";
     case Error::RootNotFound:                    return "Root not found";
+    case Error::IOFailure:                       return "I/O failure";
+    case Error::CorruptedData:                   return "Corrupted data";
     case Error::__NumberOfErrors:                [[fallthrough]];
     default:                                     return "Unknown error";
     }
@@ -1,6 +1,8 @@
 include(FetchContent)
 include(CPM)
 
+find_package(Threads REQUIRED)
+
 if (CDR_BUILD_TESTS)
     # set(BUILD_GMOCK ON)
     # FetchContent_Declare(